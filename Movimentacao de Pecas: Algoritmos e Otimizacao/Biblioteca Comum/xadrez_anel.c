@@ -0,0 +1,203 @@
+#define _GNU_SOURCE
+
+#include "xadrez_anel.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <sched.h>
+#endif
+
+// Verificações da fila antes de dormir: cobre o caso comum em que o outro
+// lado está a um bloco de distância sem pagar duas chamadas de sistema.
+#define ANEL_GIROS 256
+
+static inline char* bloco(AnelSaida* a, uint64_t i) {
+	return a->mem + (size_t)(i % a->blocos) * a->tam_bloco;
+}
+
+static uint64_t relogio_ns(clockid_t relogio) {
+	struct timespec ts;
+	clock_gettime(relogio, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t agora_ns(void) {
+	return relogio_ns(CLOCK_MONOTONIC);
+}
+
+// Dorme enquanto *sinal == visto (retorna também em sinal espúrio).
+static void dormir(_Atomic uint32_t* sinal, uint32_t visto) {
+#ifdef __linux__
+	syscall(SYS_futex, (uint32_t*)sinal, FUTEX_WAIT_PRIVATE, visto, NULL, NULL, 0);
+#else
+	(void)sinal;
+	(void)visto;
+	sched_yield();
+#endif
+}
+
+// Muda o sinal e acorda o outro lado se ele anunciou que ia dormir. A
+// ordem (sinal antes de olhar 'dormindo', ambos seq_cst) casa com a de
+// esperar(): ou quem dorme vê o sinal novo, ou quem sinaliza vê quem dorme.
+static void acordar(_Atomic uint32_t* sinal, _Atomic int* dormindo) {
+	atomic_fetch_add(sinal, 1);
+#ifdef __linux__
+	if (atomic_load(dormindo)) syscall(SYS_futex, (uint32_t*)sinal, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+	(void)dormindo;
+#endif
+}
+
+// Thread consumidora: escreve os blocos publicados, um por vez e em ordem.
+// Os blocos entre 'consumidos' e 'publicados' são só dela até avançar
+// 'consumidos' (release), quando voltam ao pool do produtor.
+static void* consumir(void* arg) {
+	AnelSaida* a = arg;
+	uint64_t i = 0;
+	for (;;) {
+		uint64_t pub = atomic_load_explicit(&a->publicados, memory_order_acquire);
+		if (pub == i) {
+			if (atomic_load(&a->fechando) && atomic_load(&a->publicados) == i) break;
+			int giros = 0;
+			while ((pub = atomic_load_explicit(&a->publicados, memory_order_acquire)) == i &&
+			       !atomic_load_explicit(&a->fechando, memory_order_relaxed) && giros < ANEL_GIROS)
+				giros++;
+			if (pub == i && !atomic_load(&a->fechando)) {
+				a->esperas_consumidora++;
+				uint32_t visto = atomic_load(&a->sinal_bloco);
+				atomic_store(&a->dormindo_consumidora, 1);
+				if (atomic_load(&a->publicados) == i && !atomic_load(&a->fechando)) dormir(&a->sinal_bloco, visto);
+				atomic_store(&a->dormindo_consumidora, 0);
+			}
+			continue;
+		}
+
+		do {
+			size_t n = a->tamanhos[i % a->blocos];
+			if (!atomic_load_explicit(&a->erro, memory_order_relaxed)) {
+				uint64_t t0 = agora_ns();
+				int ok = saida_escrever_tudo(a->fd, bloco(a, i), n);
+				a->ns_escrita += agora_ns() - t0;
+				if (!ok) atomic_store(&a->erro, errno ? errno : EIO);
+			}
+			i++;
+			atomic_store_explicit(&a->consumidos, i, memory_order_release);
+			acordar(&a->sinal_espaco, &a->dormindo_produtor);
+		} while (i != pub);
+	}
+	return NULL;
+}
+
+// Espera do produtor: até a consumidora devolver ao menos um bloco.
+static void esperar_espaco(AnelSaida* a, uint64_t pub) {
+	uint64_t t0 = agora_ns();
+	a->esperas++;
+	int giros = 0;
+	while (pub - atomic_load_explicit(&a->consumidos, memory_order_acquire) >= a->blocos) {
+		if (giros++ < ANEL_GIROS) continue;
+		uint32_t visto = atomic_load(&a->sinal_espaco);
+		atomic_store(&a->dormindo_produtor, 1);
+		if (pub - atomic_load(&a->consumidos) >= a->blocos) dormir(&a->sinal_espaco, visto);
+		atomic_store(&a->dormindo_produtor, 0);
+	}
+	a->ns_espera_produtor += agora_ns() - t0;
+}
+
+// Gancho de flush: publica o bloco corrente e passa ao próximo do pool,
+// esperando enquanto todos os blocos estiverem com a consumidora.
+static int descarregar_anel(Saida* s) {
+	AnelSaida* a = s->ctx;
+	if (s->len == 0) return !s->erro;
+	uint64_t pub = atomic_load_explicit(&a->publicados, memory_order_relaxed);
+	a->tamanhos[pub % a->blocos] = s->len;
+	pub++;
+	atomic_store_explicit(&a->publicados, pub, memory_order_release);
+	acordar(&a->sinal_bloco, &a->dormindo_consumidora);
+
+	uint64_t fila = pub - atomic_load_explicit(&a->consumidos, memory_order_acquire);
+	a->soma_profundidade += fila;
+	if (fila > a->profundidade_max) a->profundidade_max = fila;
+	if (fila >= a->blocos) esperar_espaco(a, pub);
+
+	s->erro = atomic_load_explicit(&a->erro, memory_order_relaxed);
+	s->buf = bloco(a, pub);
+	if (!s->erro) s->total += s->len;
+	s->len = 0;
+	return !s->erro;
+}
+
+static void liberar(AnelSaida* a) {
+	free(a->mem);
+	free(a->tamanhos);
+	a->mem = NULL;
+	a->tamanhos = NULL;
+}
+
+// Gancho de fechamento: publica o resto, espera a consumidora drenar tudo
+// e libera o anel.
+static int encerrar_anel(Saida* s) {
+	AnelSaida* a = s->ctx;
+	descarregar_anel(s);
+	atomic_store(&a->fechando, 1);
+	acordar(&a->sinal_bloco, &a->dormindo_consumidora);
+	pthread_join(a->consumidora, NULL);
+	if (a->erro) s->erro = a->erro;
+	a->ns_total = agora_ns() - a->inicio_ns;
+	a->ns_gerar = relogio_ns(CLOCK_THREAD_CPUTIME_ID) - a->inicio_cpu_ns;
+	liberar(a);
+	s->buf = NULL;
+	s->cap = 0;
+	s->descarregar = NULL;
+	s->encerrar = NULL;
+	return !s->erro;
+}
+
+int saida_abrir_anel(Saida* s, AnelSaida* a, int fd, size_t tam_bloco, unsigned blocos) {
+	if (!s || !a) return 0;
+	if (tam_bloco < 64) tam_bloco = SAIDA_CAP_PADRAO;
+	if (blocos < 2) blocos = 2;
+	if (blocos > ANEL_BLOCOS_MAX) blocos = ANEL_BLOCOS_MAX;
+	a->fd = fd;
+	a->tam_bloco = tam_bloco;
+	a->blocos = blocos;
+	a->mem = malloc(tam_bloco * blocos);
+	a->tamanhos = malloc(sizeof *a->tamanhos * blocos);
+	if (!a->mem || !a->tamanhos) {
+		liberar(a);
+		return 0;
+	}
+	atomic_init(&a->publicados, 0);
+	atomic_init(&a->consumidos, 0);
+	atomic_init(&a->sinal_bloco, 0);
+	atomic_init(&a->sinal_espaco, 0);
+	atomic_init(&a->dormindo_consumidora, 0);
+	atomic_init(&a->dormindo_produtor, 0);
+	atomic_init(&a->fechando, 0);
+	atomic_init(&a->erro, 0);
+	a->esperas = a->esperas_consumidora = 0;
+	a->soma_profundidade = a->profundidade_max = 0;
+	a->ns_espera_produtor = a->ns_gerar = a->ns_escrita = a->ns_total = 0;
+	a->inicio_ns = agora_ns();
+	a->inicio_cpu_ns = relogio_ns(CLOCK_THREAD_CPUTIME_ID);
+	if (pthread_create(&a->consumidora, NULL, consumir, a) != 0) {
+		liberar(a);
+		return 0;
+	}
+
+	s->fd = fd;
+	s->buf = a->mem;
+	s->cap = tam_bloco;
+	s->len = 0;
+	s->total = 0;
+	s->erro = 0;
+	s->descarregar = descarregar_anel;
+	s->encerrar = encerrar_anel;
+	s->ctx = a;
+	return 1;
+}
@@ -0,0 +1,86 @@
+#ifndef XADREZ_ANEL_H
+#define XADREZ_ANEL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xadrez_saida.h"
+
+// Saída em streaming por anel de blocos de tamanho fixo: o produtor (quem
+// chama saida_escrever/emitir_*) preenche um bloco e o publica; uma thread
+// consumidora escreve os blocos publicados no descritor, em ordem. Com o
+// anel cheio o produtor espera (contrapressão), então a memória de pico é
+// blocos * tam_bloco para qualquer volume de saída, e a formatação do
+// próximo bloco se sobrepõe ao write(2) do anterior.
+//
+// O anel é uma fila SPSC sem trava: os blocos são um pool fixo reciclado
+// em ordem, e os dois contadores (publicados/consumidos) só são escritos
+// cada um pelo seu lado. Quem encontra a fila vazia (consumidora) ou cheia
+// (produtor) gira um pouco e depois dorme num futex, acordado pelo outro
+// lado só se de fato estiver dormindo.
+//
+// Uso:
+//   Saida out; AnelSaida anel;
+//   saida_abrir_anel(&out, &anel, 1, SAIDA_CAP_PADRAO, ANEL_BLOCOS_PADRAO);
+//   ... emitir_*(&out, ...) ...
+//   saida_fechar(&out); // drena o anel e encerra a consumidora
+// Depois de uma falha de escrita a consumidora continua drenando (e
+// descartando) para o produtor nunca ficar preso; saida_fechar devolve 0.
+
+#define ANEL_BLOCOS_PADRAO 4
+#define ANEL_BLOCOS_MAX 1024
+
+typedef struct {
+	int fd;
+	char* mem;             // blocos * tam_bloco bytes
+	size_t tam_bloco;
+	unsigned blocos;
+	size_t* tamanhos;      // bytes úteis de cada bloco publicado
+	_Atomic uint64_t publicados; // blocos entregues pelo produtor (só ele escreve)
+	_Atomic uint64_t consumidos; // blocos escritos ou descartados (só a consumidora escreve)
+	_Atomic uint32_t sinal_bloco;   // palavra de futex: muda a cada publicação
+	_Atomic uint32_t sinal_espaco;  // palavra de futex: muda a cada consumo
+	_Atomic int dormindo_consumidora;
+	_Atomic int dormindo_produtor;
+	_Atomic int fechando;
+	_Atomic int erro;      // errno da primeira falha de escrita
+	pthread_t consumidora;
+
+	// Estatísticas (válidas depois de saida_fechar)
+	uint64_t esperas;             // vezes que o produtor parou com o anel cheio
+	uint64_t esperas_consumidora; // vezes que a consumidora achou o anel vazio
+	uint64_t soma_profundidade;   // blocos na fila logo após cada publicação
+	uint64_t profundidade_max;
+	uint64_t ns_espera_produtor;  // tempo do produtor parado com o anel cheio
+	uint64_t ns_gerar;            // CPU da thread produtora da abertura ao fechamento
+	uint64_t ns_escrita;          // tempo da consumidora dentro do write(2)
+	uint64_t ns_total;            // da abertura ao fim do fechamento
+	uint64_t inicio_ns, inicio_cpu_ns;
+} AnelSaida;
+
+// Abre s sobre um anel novo em a (s->buf aponta para o bloco corrente).
+// Retorna 0 sem memória ou sem thread; nesse caso nada fica alocado.
+int saida_abrir_anel(Saida* s, AnelSaida* a, int fd, size_t tam_bloco, unsigned blocos);
+
+// Memória ocupada pelo anel (constante durante toda a emissão).
+static inline size_t anel_memoria(const AnelSaida* a) {
+	return a->tam_bloco * a->blocos;
+}
+
+// Profundidade média da fila (blocos esperando a consumidora) por publicação.
+static inline double anel_profundidade_media(const AnelSaida* a) {
+	return a->publicados ? (double)a->soma_profundidade / (double)a->publicados : 0.0;
+}
+
+// Quanto a sobreposição rendeu sobre escrever na mesma thread: (CPU do
+// produtor + tempo em write) / tempo total, isto é, o tempo que a versão
+// síncrona levaria sobre o que o anel levou. Abaixo de 1.0 as duas threads
+// disputam o mesmo núcleo e a troca de contexto custa mais do que sobrepõe.
+static inline double anel_ganho(const AnelSaida* a) {
+	if (!a->ns_total) return 1.0;
+	return (double)(a->ns_gerar + a->ns_escrita) / (double)a->ns_total;
+}
+
+#endif
@@ -0,0 +1,252 @@
+#include "xadrez_ataques_lote.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "xadrez_lances.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ATAQUES_X86 1
+#include <immintrin.h>
+#endif
+
+const char* const CHAVE_ATAQUES[ATAQUES_QTD] = { "escalar", "avx2", "avx512" };
+const int LARGURA_ATAQUES[ATAQUES_QTD] = { 1, 4, 8 };
+
+#define NAO_A (~BB_COLUNA_A)
+#define NAO_H (~BB_COLUNA_H)
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ LOTE
+────────────────────────────────────────────────────────────────────────────
+*/
+
+#define VETORES_LOTE 5
+
+static void apontar(LoteTabuleiros* l) {
+	Bitboard* base = l->bloco;
+	l->ocupadas = base;
+	l->cavalos = base + l->cap;
+	l->ortogonais = base + 2 * l->cap;
+	l->diagonais = base + 3 * l->cap;
+	l->ataques = base + 4 * l->cap;
+}
+
+// Bloco zerado para 'cap' tabuleiros (cap múltiplo de LOTE_ALINHAMENTO).
+static void* alocar(size_t cap) {
+	size_t bytes = VETORES_LOTE * cap * sizeof(Bitboard);
+	void* p = aligned_alloc(64, bytes);
+	if (p) memset(p, 0, bytes);
+	return p;
+}
+
+int lote_iniciar(LoteTabuleiros* l, size_t cap) {
+	cap = (cap + LOTE_ALINHAMENTO - 1) / LOTE_ALINHAMENTO * LOTE_ALINHAMENTO;
+	if (cap == 0) cap = LOTE_ALINHAMENTO;
+	l->n = 0;
+	l->cap = cap;
+	l->bloco = alocar(cap);
+	if (!l->bloco) return 0;
+	apontar(l);
+	return 1;
+}
+
+void lote_liberar(LoteTabuleiros* l) {
+	free(l->bloco);
+	memset(l, 0, sizeof *l);
+}
+
+static int crescer(LoteTabuleiros* l) {
+	if (l->cap > ((size_t)-1) / 2 / (VETORES_LOTE * sizeof(Bitboard))) return 0;
+	LoteTabuleiros novo = *l;
+	novo.cap = l->cap * 2;
+	novo.bloco = alocar(novo.cap);
+	if (!novo.bloco) return 0;
+	apontar(&novo);
+	memcpy(novo.ocupadas, l->ocupadas, l->n * sizeof(Bitboard));
+	memcpy(novo.cavalos, l->cavalos, l->n * sizeof(Bitboard));
+	memcpy(novo.ortogonais, l->ortogonais, l->n * sizeof(Bitboard));
+	memcpy(novo.diagonais, l->diagonais, l->n * sizeof(Bitboard));
+	free(l->bloco);
+	*l = novo;
+	return 1;
+}
+
+int lote_adicionar(LoteTabuleiros* l, const Tabuleiro* t, Cor lado) {
+	if (l->n == l->cap && !crescer(l)) return 0;
+	size_t i = l->n++;
+	const Bitboard* p = t->pecas[lado];
+	l->ocupadas[i] = tabuleiro_ocupadas(t);
+	l->cavalos[i] = p[TP_CAVALO];
+	l->ortogonais[i] = p[TP_TORRE] | p[TP_RAINHA];
+	l->diagonais[i] = p[TP_BISPO] | p[TP_RAINHA];
+	return 1;
+}
+
+int ataques_de_chave(const char* chave) {
+	for (int i = 0; i < ATAQUES_QTD; i++) {
+		if (!strcmp(chave, CHAVE_ATAQUES[i])) return i;
+	}
+	return -1;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ ESCALAR (referência): um tabuleiro por vez
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static void ataques_escalar(LoteTabuleiros* l) {
+	for (size_t i = 0; i < l->n; i++) {
+		Bitboard vazias = ~l->ocupadas[i];
+		l->ataques[i] = ataques_cavalo(l->cavalos[i]) | bb_ataques_deslizantes(PECA_TORRE, l->ortogonais[i], vazias) |
+		                bb_ataques_deslizantes(PECA_BISPO, l->diagonais[i], vazias);
+	}
+}
+
+#ifdef ATAQUES_X86
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ AVX2: 4 tabuleiros por registrador
+
+ raio4(g, vazias, s, m) é bb_preencher() seguido do último deslocamento
+ de bb_ataques_deslizantes(), com o deslocamento s (constante depois do
+ inline, vira imediato) e a máscara m de Direcao.
+────────────────────────────────────────────────────────────────────────────
+*/
+
+#define ALVO_AVX2 __attribute__((target("avx2")))
+
+ALVO_AVX2 static inline __m256i desl4(__m256i v, int s) {
+	return s > 0 ? _mm256_slli_epi64(v, s) : _mm256_srli_epi64(v, -s);
+}
+
+ALVO_AVX2 static inline __m256i raio4(__m256i g, __m256i vazias, int s, Bitboard mascara) {
+	__m256i m = _mm256_set1_epi64x((long long)mascara);
+	__m256i livre = _mm256_and_si256(vazias, m);
+	g = _mm256_or_si256(g, _mm256_and_si256(livre, desl4(g, s)));
+	livre = _mm256_and_si256(livre, desl4(livre, s));
+	g = _mm256_or_si256(g, _mm256_and_si256(livre, desl4(g, 2 * s)));
+	livre = _mm256_and_si256(livre, desl4(livre, 2 * s));
+	g = _mm256_or_si256(g, _mm256_and_si256(livre, desl4(g, 4 * s)));
+	return _mm256_and_si256(desl4(g, s), m);
+}
+
+ALVO_AVX2 static inline __m256i cavalo4(__m256i b) {
+	__m256i l1 = _mm256_and_si256(_mm256_srli_epi64(b, 1), _mm256_set1_epi64x((long long)NAO_H));
+	__m256i l2 = _mm256_and_si256(_mm256_srli_epi64(b, 2), _mm256_set1_epi64x((long long)~(BB_COLUNA_H | (BB_COLUNA_H >> 1))));
+	__m256i r1 = _mm256_and_si256(_mm256_slli_epi64(b, 1), _mm256_set1_epi64x((long long)NAO_A));
+	__m256i r2 = _mm256_and_si256(_mm256_slli_epi64(b, 2), _mm256_set1_epi64x((long long)~(BB_COLUNA_A | (BB_COLUNA_A << 1))));
+	__m256i h1 = _mm256_or_si256(l1, r1), h2 = _mm256_or_si256(l2, r2);
+	return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi64(h1, 16), _mm256_srli_epi64(h1, 16)),
+	                       _mm256_or_si256(_mm256_slli_epi64(h2, 8), _mm256_srli_epi64(h2, 8)));
+}
+
+ALVO_AVX2 static void ataques_avx2(LoteTabuleiros* l) {
+	const __m256i tudo = _mm256_set1_epi64x(-1);
+	for (size_t i = 0; i < l->n; i += 4) {
+		__m256i vazias = _mm256_xor_si256(_mm256_load_si256((const __m256i*)(l->ocupadas + i)), tudo);
+		__m256i ort = _mm256_load_si256((const __m256i*)(l->ortogonais + i));
+		__m256i dia = _mm256_load_si256((const __m256i*)(l->diagonais + i));
+		__m256i a = cavalo4(_mm256_load_si256((const __m256i*)(l->cavalos + i)));
+		a = _mm256_or_si256(a, raio4(ort, vazias, 1, NAO_A));
+		a = _mm256_or_si256(a, raio4(ort, vazias, -1, NAO_H));
+		a = _mm256_or_si256(a, raio4(ort, vazias, 8, BB_TUDO));
+		a = _mm256_or_si256(a, raio4(ort, vazias, -8, BB_TUDO));
+		a = _mm256_or_si256(a, raio4(dia, vazias, 9, NAO_A));
+		a = _mm256_or_si256(a, raio4(dia, vazias, 7, NAO_H));
+		a = _mm256_or_si256(a, raio4(dia, vazias, -7, NAO_A));
+		a = _mm256_or_si256(a, raio4(dia, vazias, -9, NAO_H));
+		_mm256_store_si256((__m256i*)(l->ataques + i), a);
+	}
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ AVX-512: 8 tabuleiros por registrador (mesmas operações)
+────────────────────────────────────────────────────────────────────────────
+*/
+
+#define ALVO_AVX512 __attribute__((target("avx512f")))
+
+ALVO_AVX512 static inline __m512i desl8(__m512i v, int s) {
+	return s > 0 ? _mm512_slli_epi64(v, (unsigned)s) : _mm512_srli_epi64(v, (unsigned)-s);
+}
+
+ALVO_AVX512 static inline __m512i raio8(__m512i g, __m512i vazias, int s, Bitboard mascara) {
+	__m512i m = _mm512_set1_epi64((long long)mascara);
+	__m512i livre = _mm512_and_si512(vazias, m);
+	g = _mm512_or_si512(g, _mm512_and_si512(livre, desl8(g, s)));
+	livre = _mm512_and_si512(livre, desl8(livre, s));
+	g = _mm512_or_si512(g, _mm512_and_si512(livre, desl8(g, 2 * s)));
+	livre = _mm512_and_si512(livre, desl8(livre, 2 * s));
+	g = _mm512_or_si512(g, _mm512_and_si512(livre, desl8(g, 4 * s)));
+	return _mm512_and_si512(desl8(g, s), m);
+}
+
+ALVO_AVX512 static inline __m512i cavalo8(__m512i b) {
+	__m512i l1 = _mm512_and_si512(_mm512_srli_epi64(b, 1), _mm512_set1_epi64((long long)NAO_H));
+	__m512i l2 = _mm512_and_si512(_mm512_srli_epi64(b, 2), _mm512_set1_epi64((long long)~(BB_COLUNA_H | (BB_COLUNA_H >> 1))));
+	__m512i r1 = _mm512_and_si512(_mm512_slli_epi64(b, 1), _mm512_set1_epi64((long long)NAO_A));
+	__m512i r2 = _mm512_and_si512(_mm512_slli_epi64(b, 2), _mm512_set1_epi64((long long)~(BB_COLUNA_A | (BB_COLUNA_A << 1))));
+	__m512i h1 = _mm512_or_si512(l1, r1), h2 = _mm512_or_si512(l2, r2);
+	return _mm512_or_si512(_mm512_or_si512(_mm512_slli_epi64(h1, 16), _mm512_srli_epi64(h1, 16)),
+	                       _mm512_or_si512(_mm512_slli_epi64(h2, 8), _mm512_srli_epi64(h2, 8)));
+}
+
+ALVO_AVX512 static void ataques_avx512(LoteTabuleiros* l) {
+	const __m512i tudo = _mm512_set1_epi64(-1);
+	for (size_t i = 0; i < l->n; i += 8) {
+		__m512i vazias = _mm512_xor_si512(_mm512_load_si512(l->ocupadas + i), tudo);
+		__m512i ort = _mm512_load_si512(l->ortogonais + i);
+		__m512i dia = _mm512_load_si512(l->diagonais + i);
+		__m512i a = cavalo8(_mm512_load_si512(l->cavalos + i));
+		a = _mm512_or_si512(a, raio8(ort, vazias, 1, NAO_A));
+		a = _mm512_or_si512(a, raio8(ort, vazias, -1, NAO_H));
+		a = _mm512_or_si512(a, raio8(ort, vazias, 8, BB_TUDO));
+		a = _mm512_or_si512(a, raio8(ort, vazias, -8, BB_TUDO));
+		a = _mm512_or_si512(a, raio8(dia, vazias, 9, NAO_A));
+		a = _mm512_or_si512(a, raio8(dia, vazias, 7, NAO_H));
+		a = _mm512_or_si512(a, raio8(dia, vazias, -7, NAO_A));
+		a = _mm512_or_si512(a, raio8(dia, vazias, -9, NAO_H));
+		_mm512_store_si512(l->ataques + i, a);
+	}
+}
+
+#endif
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ DESPACHO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+int ataques_disponivel(ImplAtaques impl) {
+	switch (impl) {
+	case ATAQUES_ESCALAR: return 1;
+#ifdef ATAQUES_X86
+	case ATAQUES_AVX2: return __builtin_cpu_supports("avx2");
+	case ATAQUES_AVX512: return __builtin_cpu_supports("avx512f");
+#endif
+	default: return 0;
+	}
+}
+
+ImplAtaques ataques_melhor(void) {
+	for (int i = ATAQUES_QTD - 1; i > 0; i--) {
+		if (ataques_disponivel((ImplAtaques)i)) return (ImplAtaques)i;
+	}
+	return ATAQUES_ESCALAR;
+}
+
+void ataques_lote(LoteTabuleiros* l, ImplAtaques impl) {
+	switch (impl) {
+#ifdef ATAQUES_X86
+	case ATAQUES_AVX2: ataques_avx2(l); break;
+	case ATAQUES_AVX512: ataques_avx512(l); break;
+#endif
+	default: ataques_escalar(l); break;
+	}
+}
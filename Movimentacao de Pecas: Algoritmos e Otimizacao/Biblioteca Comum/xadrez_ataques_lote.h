@@ -0,0 +1,64 @@
+#ifndef XADREZ_ATAQUES_LOTE_H
+#define XADREZ_ATAQUES_LOTE_H
+
+#include <stddef.h>
+
+#include "xadrez_bitboard.h"
+#include "xadrez_posicao.h"
+
+// Ataques de muitos tabuleiros independentes de uma vez. O lote guarda os
+// tabuleiros em estrutura de vetores (um vetor por conjunto de peças, o
+// índice i de todos eles é o tabuleiro i), então 4 (AVX2) ou 8 (AVX-512)
+// tabuleiros consecutivos cabem num registrador, um por faixa. Os
+// deslizantes usam o mesmo preenchimento Kogge-Stone de bb_preencher(),
+// só que com os deslocamentos e máscaras aplicados às faixas todas; os
+// cavalos, os mesmos deslocamentos de ataques_cavalo().
+//
+// A implementação escalar é a referência: um tabuleiro por vez, com as
+// funções de xadrez_bitboard.h / xadrez_lances.h. As vetoriais são
+// escolhidas em tempo de execução (x86 com GCC/Clang) e têm que dar
+// exatamente os mesmos bitboards.
+
+#define LOTE_ALINHAMENTO 8 // tabuleiros: a maior largura vetorial (e 64 bytes)
+
+typedef struct {
+	size_t n;              // tabuleiros no lote
+	size_t cap;            // múltiplo de LOTE_ALINHAMENTO; o resto fica zerado
+	Bitboard* ocupadas;    // todas as peças
+	Bitboard* cavalos;     // do lado analisado
+	Bitboard* ortogonais;  // torres e rainhas do lado analisado
+	Bitboard* diagonais;   // bispos e rainhas do lado analisado
+	Bitboard* ataques;     // saída: casas atacadas pelo lado (cavalos e deslizantes)
+	void* bloco;           // os cinco vetores, alinhados em 64 bytes
+} LoteTabuleiros;
+
+typedef enum {
+	ATAQUES_ESCALAR,
+	ATAQUES_AVX2,
+	ATAQUES_AVX512,
+	ATAQUES_QTD
+} ImplAtaques;
+
+extern const char* const CHAVE_ATAQUES[ATAQUES_QTD]; // "escalar", "avx2", "avx512"
+extern const int LARGURA_ATAQUES[ATAQUES_QTD];       // tabuleiros por instrução: 1, 4, 8
+
+// Retorna 0 sem memória.
+int lote_iniciar(LoteTabuleiros* l, size_t cap);
+void lote_liberar(LoteTabuleiros* l);
+
+// Acrescenta o tabuleiro visto pelo 'lado' (cresce o lote se preciso).
+int lote_adicionar(LoteTabuleiros* l, const Tabuleiro* t, Cor lado);
+
+// "avx2" -> ATAQUES_AVX2; -1 se desconhecido.
+int ataques_de_chave(const char* chave);
+
+// 1 se compilada e suportada pela CPU.
+int ataques_disponivel(ImplAtaques impl);
+
+// A mais larga disponível.
+ImplAtaques ataques_melhor(void);
+
+// Preenche l->ataques[0..n) com a implementação pedida (tem que estar disponível).
+void ataques_lote(LoteTabuleiros* l, ImplAtaques impl);
+
+#endif
@@ -0,0 +1,116 @@
+#include "xadrez_avaliacao.h"
+
+#include <pthread.h>
+
+#include "xadrez_bitboard.h"
+#include "xadrez_lances.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AVALIACAO_POPCNT 1
+#endif
+
+// Torre, Bispo, Rainha, Cavalo (ordem de Peca)
+const int8_t PESO_MOBILIDADE[PECA_QTD] = { 2, 3, 1, 4 };
+
+static const TipoPeca TIPO_DE[PECA_QTD] = { TP_TORRE, TP_BISPO, TP_RAINHA, TP_CAVALO };
+
+// Raios por direção e casa (sem a origem). O ataque de uma peça numa
+// direção é o raio cortado no primeiro bloqueador, sem desvio. Sai
+// mais barato que os três passos de Kogge-Stone por direção, que
+// compensam com muitas origens de uma vez, não com uma peça por vez.
+static Bitboard RAIO[DIR_QTD][64];
+static pthread_once_t raios_prontos = PTHREAD_ONCE_INIT;
+
+static void iniciar_raios(void) {
+	for (int d = 0; d < DIR_QTD; d++) {
+		for (int c = 0; c < 64; c++) {
+			Bitboard raio = 0;
+			for (Bitboard b = bb_deslocar(BB_CASA(c), (Direcao)d); b; b = bb_deslocar(b, (Direcao)d)) raio |= b;
+			RAIO[d][c] = raio;
+		}
+	}
+}
+
+// Casas até o primeiro bloqueador (inclusive) numa direção crescente
+// (bit mais baixo) ou decrescente (bit mais alto); sem bloqueador, o raio.
+static inline Bitboard raio_crescente(Direcao d, int casa, Bitboard ocupadas) {
+	Bitboard raio = RAIO[d][casa];
+	Bitboard bloqueio = raio & ocupadas;
+	Bitboard primeiro = bloqueio & (0 - bloqueio);
+	return raio & (primeiro | (primeiro - 1));
+}
+
+static inline Bitboard raio_decrescente(Direcao d, int casa, Bitboard ocupadas) {
+	Bitboard raio = RAIO[d][casa];
+	Bitboard primeiro = 1ULL << (63 - __builtin_clzll((raio & ocupadas) | 1)); // a1 = sem bloqueador
+	return raio & (0 - primeiro);
+}
+
+static inline Bitboard ataques_ortogonais(int casa, Bitboard ocupadas) {
+	return raio_crescente(DIR_DIREITA, casa, ocupadas) | raio_decrescente(DIR_ESQUERDA, casa, ocupadas) |
+	       raio_crescente(DIR_CIMA, casa, ocupadas) | raio_decrescente(DIR_BAIXO, casa, ocupadas);
+}
+
+static inline Bitboard ataques_diagonais(int casa, Bitboard ocupadas) {
+	return raio_crescente(DIR_CIMA_DIREITA, casa, ocupadas) | raio_crescente(DIR_CIMA_ESQUERDA, casa, ocupadas) |
+	       raio_decrescente(DIR_BAIXO_DIREITA, casa, ocupadas) | raio_decrescente(DIR_BAIXO_ESQUERDA, casa, ocupadas);
+}
+
+static inline Bitboard ataques_de(int p, int casa, Bitboard ocupadas) {
+	switch (p) {
+	case PECA_TORRE: return ataques_ortogonais(casa, ocupadas);
+	case PECA_BISPO: return ataques_diagonais(casa, ocupadas);
+	case PECA_RAINHA: return ataques_ortogonais(casa, ocupadas) | ataques_diagonais(casa, ocupadas);
+	default: return ataques_cavalo(BB_CASA(casa));
+	}
+}
+
+// Núcleo comum: sempre inline, para que cada variante compile o popcount
+// com o conjunto de instruções dela.
+static inline __attribute__((always_inline)) void avaliar_base(const Tabuleiro* t, Avaliacao* a) {
+	Bitboard ocupadas = tabuleiro_ocupadas(t);
+	int32_t pontos = 0;
+	for (int c = 0; c < 2; c++) {
+		Bitboard inimigas = t->cor[c ^ 1];
+		Bitboard alvo = ~t->cor[c];
+		int32_t lado = 0;
+		for (int p = 0; p < PECA_QTD; p++) {
+			int mob = 0, atq = 0;
+			for (Bitboard b = t->pecas[c][TIPO_DE[p]]; b; b &= b - 1) {
+				int casa = __builtin_ctzll(b);
+				Bitboard ataque = ataques_de(p, casa, ocupadas);
+				mob += __builtin_popcountll(ataque & alvo);
+				atq += __builtin_popcountll(ataque & inimigas);
+			}
+			a->mobilidade[c][p] = (uint16_t)mob;
+			a->ataques[c][p] = (uint16_t)atq;
+			lado += PESO_MOBILIDADE[p] * mob + PESO_ATAQUE * atq;
+		}
+		pontos += c == COR_BRANCA ? lado : -lado;
+	}
+	a->pontos = pontos;
+}
+
+static void avaliar_software(const Tabuleiro* t, Avaliacao* a) {
+	avaliar_base(t, a);
+}
+
+#ifdef AVALIACAO_POPCNT
+__attribute__((target("popcnt"))) static void avaliar_popcnt(const Tabuleiro* t, Avaliacao* a) {
+	avaliar_base(t, a);
+}
+#endif
+
+FuncaoAvaliacao avaliacao_escolher(int hardware, const char** nome) {
+	pthread_once(&raios_prontos, iniciar_raios);
+#ifdef AVALIACAO_POPCNT
+	if (hardware && __builtin_cpu_supports("popcnt")) {
+		if (nome) *nome = "hardware";
+		return avaliar_popcnt;
+	}
+#else
+	(void)hardware;
+#endif
+	if (nome) *nome = "software";
+	return avaliar_software;
+}
@@ -0,0 +1,35 @@
+#ifndef XADREZ_AVALIACAO_H
+#define XADREZ_AVALIACAO_H
+
+#include <stdint.h>
+
+#include "xadrez_formatos.h"
+#include "xadrez_posicao.h"
+
+// Avaliação estática de mobilidade: para cada Torre, Bispo, Rainha e
+// Cavalo das duas cores, o bitboard de ataques da peça (deslizantes por
+// raios pré-calculados, cavalos por deslocamento) vira duas
+// contagens com popcount: casas alcançáveis (vazias ou com peça inimiga)
+// e peças inimigas atacadas. Nada de lista de lances nem legalidade: o
+// custo é fixo por peça, barato para varrer arquivos de milhões de posições.
+//
+// O popcount é a instrução POPCNT quando a CPU tem (escolhida em tempo de
+// execução, x86 com GCC/Clang); senão, a versão em software do compilador.
+
+typedef struct {
+	uint16_t mobilidade[2][PECA_QTD]; // [cor][peça]: soma das casas alcançáveis
+	uint16_t ataques[2][PECA_QTD];    // [cor][peça]: peças inimigas atacadas
+	int32_t pontos;                   // brancas - pretas, ponderado por peça
+} Avaliacao;
+
+// Peso de cada casa alcançável por peça e de cada peça inimiga atacada.
+extern const int8_t PESO_MOBILIDADE[PECA_QTD];
+#define PESO_ATAQUE 4
+
+typedef void (*FuncaoAvaliacao)(const Tabuleiro* t, Avaliacao* a);
+
+// Implementação com popcount em hardware se 'hardware' e a CPU permitem;
+// senão, em software. *nome recebe "hardware" ou "software" (se não NULL).
+FuncaoAvaliacao avaliacao_escolher(int hardware, const char** nome);
+
+#endif
@@ -0,0 +1,40 @@
+#include "xadrez_bitboard.h"
+
+// Mesma ordem de Direcao (xadrez_formatos.h).
+const int8_t BB_DESLOCAMENTO[DIR_QTD] = { 1, -1, 8, -8, 9, 7, -7, -9 };
+
+const Bitboard BB_MASCARA_DESTINO[DIR_QTD] = {
+	~BB_COLUNA_A, ~BB_COLUNA_H, BB_TUDO, BB_TUDO,
+	~BB_COLUNA_A, ~BB_COLUNA_H, ~BB_COLUNA_A, ~BB_COLUNA_H,
+};
+
+Bitboard bb_ataques_deslizantes(Peca p, Bitboard origens, Bitboard vazias) {
+	int ini, fim;
+	switch (p) {
+	case PECA_TORRE: ini = DIR_DIREITA; fim = DIR_BAIXO; break;
+	case PECA_BISPO: ini = DIR_CIMA_DIREITA; fim = DIR_BAIXO_ESQUERDA; break;
+	case PECA_RAINHA: ini = DIR_DIREITA; fim = DIR_BAIXO_ESQUERDA; break;
+	default: return 0;
+	}
+	Bitboard ataques = 0;
+	for (int d = ini; d <= fim; d++)
+		ataques |= bb_deslocar(bb_preencher(origens, vazias, (Direcao)d), (Direcao)d);
+	return ataques;
+}
+
+int bb_alcance(Peca p, int origem, Bitboard obstaculos, Bitboard niveis[64]) {
+	if (origem < 0 || origem > 63 || (obstaculos & BB_CASA(origem))) return 0;
+	if (p != PECA_TORRE && p != PECA_BISPO && p != PECA_RAINHA) return 0;
+	Bitboard vazias = ~obstaculos;
+	Bitboard visitadas = BB_CASA(origem);
+	Bitboard fronteira = visitadas;
+	int k = 0;
+	for (;;) {
+		Bitboard novas = bb_ataques_deslizantes(p, fronteira, vazias) & vazias & ~visitadas;
+		if (!novas) break;
+		visitadas |= novas;
+		niveis[k++] = visitadas & ~BB_CASA(origem);
+		fronteira = novas;
+	}
+	return k;
+}
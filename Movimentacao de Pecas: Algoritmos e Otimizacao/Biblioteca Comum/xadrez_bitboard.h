@@ -0,0 +1,55 @@
+#ifndef XADREZ_BITBOARD_H
+#define XADREZ_BITBOARD_H
+
+#include <stdint.h>
+
+#include "xadrez_formatos.h"
+
+// Bitboards 8x8: bit i = casa i, com i = linha * 8 + coluna (a1 = 0, h8 = 63).
+// As operações trabalham sobre conjuntos de casas de uma vez (set-wise):
+// o custo não depende de quantas casas estão no conjunto.
+
+typedef uint64_t Bitboard;
+
+#define BB_CASA(c) (1ULL << (c))
+#define BB_COLUNA_A 0x0101010101010101ULL
+#define BB_COLUNA_H 0x8080808080808080ULL
+#define BB_TUDO 0xFFFFFFFFFFFFFFFFULL
+
+// Deslocamento de bits e máscara de destino (evita "dar a volta" entre a
+// coluna h e a coluna a) para cada Direcao.
+extern const int8_t BB_DESLOCAMENTO[DIR_QTD];
+extern const Bitboard BB_MASCARA_DESTINO[DIR_QTD];
+
+static inline Bitboard bb_deslocar(Bitboard b, Direcao d) {
+	int s = BB_DESLOCAMENTO[d];
+	return (s > 0 ? b << s : b >> -s) & BB_MASCARA_DESTINO[d];
+}
+
+// Preenchimento Kogge-Stone: estende todas as casas de 'geradores' na
+// direção d enquanto houver casas em 'vazias'. 3 passos (1, 2, 4 casas)
+// cobrem as 7 casas possíveis de um deslizamento.
+static inline Bitboard bb_preencher(Bitboard geradores, Bitboard vazias, Direcao d) {
+	int s = BB_DESLOCAMENTO[d];
+	Bitboard livre = vazias & BB_MASCARA_DESTINO[d];
+	for (int passo = 1; passo <= 4; passo <<= 1) {
+		int k = s * passo;
+		geradores |= livre & (k > 0 ? geradores << k : geradores >> -k);
+		livre &= (k > 0 ? livre << k : livre >> -k);
+	}
+	return geradores;
+}
+
+// Casas atacadas por uma peça deslizante (Torre, Bispo ou Rainha) a partir
+// de todas as casas de 'origens' ao mesmo tempo. O deslizamento para antes
+// de qualquer casa fora de 'vazias', mas a inclui no ataque.
+Bitboard bb_ataques_deslizantes(Peca p, Bitboard origens, Bitboard vazias);
+
+// Alcance em k movimentos com obstáculos: BFS por conjuntos, expandindo a
+// fronteira inteira por iteração. niveis[k - 1] recebe as casas alcançáveis
+// em até k movimentos (sem a origem). Obstáculos bloqueiam e não podem ser
+// ocupados. Retorna o número de níveis até estabilizar (0 se a origem é um
+// obstáculo ou a peça não desliza); niveis[] precisa de 64 posições.
+int bb_alcance(Peca p, int origem, Bitboard obstaculos, Bitboard niveis[64]);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef XADREZ_CASA_H
+#define XADREZ_CASA_H
+
+#include <stddef.h>
+#include <string.h>
+
+// Casa do tabuleiro 8x8 e nomes algébricos dos programas dos níveis
+// (xadrez_completo.c e mestre_recursividade_avancada.c): o mesmo tipo, a
+// mesma tabela NOME_CASA e a mesma linha de passo nos dois. Só cabeçalho,
+// incluído por caminho relativo: cada programa continua compilando
+// sozinho, sem -I nem outras unidades de tradução.
+
+typedef struct {
+	int coluna;   // 0..7 = a..h
+	int linha;    // 0..7 = 1..8
+} Casa;
+
+static const char NOME_CASA[64][3] = {
+	"a1", "b1", "c1", "d1", "e1", "f1", "g1", "h1",
+	"a2", "b2", "c2", "d2", "e2", "f2", "g2", "h2",
+	"a3", "b3", "c3", "d3", "e3", "f3", "g3", "h3",
+	"a4", "b4", "c4", "d4", "e4", "f4", "g4", "h4",
+	"a5", "b5", "c5", "d5", "e5", "f5", "g5", "h5",
+	"a6", "b6", "c6", "d6", "e6", "f6", "g6", "h6",
+	"a7", "b7", "c7", "d7", "e7", "f7", "g7", "h7",
+	"a8", "b8", "c8", "d8", "e8", "f8", "g8", "h8"
+};
+
+// Casas iniciais padrão (escolhidas para que o movimento caiba no tabuleiro)
+#define INICIO_TORRE              ((Casa){0, 0})   // a1 → f1
+#define INICIO_BISPO              ((Casa){2, 0})   // c1 → h6
+#define INICIO_RAINHA             ((Casa){7, 3})   // h4 → a4 (8ª casa sai do tabuleiro)
+#define INICIO_CAVALO_AVENTUREIRO ((Casa){6, 7})   // g8 → f6
+#define INICIO_CAVALO_MESTRE      ((Casa){1, 0})   // b1 → c3
+
+// Converte "e4" em Casa; retorna 0 se o nome for inválido.
+static inline int casa_de_nome(const char* nome, Casa* casa) {
+	if (!nome || strlen(nome) != 2) return 0;
+	if (nome[0] < 'a' || nome[0] > 'h' || nome[1] < '1' || nome[1] > '8') return 0;
+	casa->coluna = nome[0] - 'a';
+	casa->linha = nome[1] - '1';
+	return 1;
+}
+
+// Nome da casa; "--" fora do tabuleiro.
+static inline const char* nome_casa(Casa c) {
+	if (c.coluna < 0 || c.coluna > 7 || c.linha < 0 || c.linha > 7) return "--";
+	return NOME_CASA[c.linha * 8 + c.coluna];
+}
+
+#define PASSO_LINHA_MAX 48
+
+// Monta "Direção\n" ou, com coordenadas, "Direção de→para\n" em dst;
+// retorna o tamanho (sem terminador).
+static inline size_t formatar_passo(char dst[PASSO_LINHA_MAX], const char* direcao, Casa de, Casa para,
+                                    int coordenadas) {
+	size_t len = strlen(direcao);
+	memcpy(dst, direcao, len);
+	if (coordenadas) {
+		dst[len++] = ' ';
+		memcpy(dst + len, nome_casa(de), 2);
+		len += 2;
+		memcpy(dst + len, "→", sizeof("→") - 1);
+		len += sizeof("→") - 1;
+		memcpy(dst + len, nome_casa(para), 2);
+		len += 2;
+	}
+	dst[len++] = '\n';
+	return len;
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include "xadrez_cavalo.h"
+
+#include <string.h>
+
+// Ordem dos saltos: sentido horário a partir de (+1, +2).
+const int8_t CAVALO_DC[CAVALO_DIRECOES] = { 1, 2, 2, 1, -1, -2, -2, -1 };
+const int8_t CAVALO_DL[CAVALO_DIRECOES] = { 2, 1, -1, -2, -2, -1, 1, 2 };
+
+int tabela_cavalo_iniciar(TabelaCavalo* t, int largura, int altura) {
+	if (!t || largura < 1 || largura > TAB_MAX_LADO || altura < 1 || altura > TAB_MAX_LADO) return 0;
+	memset(t, 0, sizeof *t);
+	t->largura = largura;
+	t->altura = altura;
+	t->casas = largura * altura;
+	for (int c = 0; c < t->casas; c++) {
+		int col = c % largura, lin = c / largura;
+		for (int d = 0; d < CAVALO_DIRECOES; d++) {
+			int nc = col + CAVALO_DC[d], nl = lin + CAVALO_DL[d];
+			if (nc < 0 || nc >= largura || nl < 0 || nl >= altura) continue;
+			int destino = nl * largura + nc;
+			t->viz[c][t->qtd[c]++] = (uint8_t)destino;
+			t->mascara[c] |= 1ULL << destino;
+		}
+	}
+	return 1;
+}
+
+int nome_casa_tab(const TabelaCavalo* t, int casa, char dst[3]) {
+	if (casa < 0 || casa >= t->casas) return 0;
+	dst[0] = (char)('a' + casa % t->largura);
+	dst[1] = (char)('1' + casa / t->largura);
+	dst[2] = '\0';
+	return 1;
+}
+
+int casa_tab_de_nome(const TabelaCavalo* t, const char* nome) {
+	if (!nome || strlen(nome) != 2) return -1;
+	int col = nome[0] - 'a', lin = nome[1] - '1';
+	if (col < 0 || col >= t->largura || lin < 0 || lin >= t->altura) return -1;
+	return lin * t->largura + col;
+}
+
+void distancias_cavalo_iniciar(DistanciasCavalo* dist, const TabelaCavalo* t) {
+	uint8_t fila[TAB_MAX_CASAS];
+	memset(dist->d, CAVALO_INALCANCAVEL, sizeof dist->d);
+	dist->tab = t;
+	for (int origem = 0; origem < t->casas; origem++) {
+		uint8_t* d = dist->d[origem];
+		int ini = 0, fim = 0;
+		d[origem] = 0;
+		fila[fim++] = (uint8_t)origem;
+		while (ini < fim) {
+			int c = fila[ini++];
+			for (int k = 0; k < t->qtd[c]; k++) {
+				int v = t->viz[c][k];
+				if (d[v] != CAVALO_INALCANCAVEL) continue;
+				d[v] = (uint8_t)(d[c] + 1);
+				fila[fim++] = (uint8_t)v;
+			}
+		}
+	}
+}
+
+int caminho_cavalo(const DistanciasCavalo* dist, int de, int para, uint8_t* caminho) {
+	const TabelaCavalo* t = dist->tab;
+	int restante = dist->d[de][para];
+	if (restante == CAVALO_INALCANCAVEL) return 0;
+	int n = 0, atual = de;
+	caminho[n++] = (uint8_t)atual;
+	while (restante > 0) {
+		for (int k = 0; k < t->qtd[atual]; k++) {
+			int v = t->viz[atual][k];
+			if (dist->d[v][para] == restante - 1) {
+				atual = v;
+				break;
+			}
+		}
+		caminho[n++] = (uint8_t)atual;
+		restante--;
+	}
+	return n;
+}
@@ -0,0 +1,56 @@
+#ifndef XADREZ_CAVALO_H
+#define XADREZ_CAVALO_H
+
+#include <stdint.h>
+
+// Tabelas do movimento em "L" do Cavalo para tabuleiros de até 8x8.
+// Casa = linha * largura + coluna; coluna 0 = 'a', linha 0 = '1'.
+
+#define CAVALO_DIRECOES 8
+#define TAB_MAX_LADO 8
+#define TAB_MAX_CASAS (TAB_MAX_LADO * TAB_MAX_LADO)
+
+// Os 8 saltos (dc, dl): 2 casas em um eixo + 1 no outro.
+extern const int8_t CAVALO_DC[CAVALO_DIRECOES];
+extern const int8_t CAVALO_DL[CAVALO_DIRECOES];
+
+typedef struct {
+	int largura;
+	int altura;
+	int casas;
+	uint8_t qtd[TAB_MAX_CASAS];                   // grau de cada casa
+	uint8_t viz[TAB_MAX_CASAS][CAVALO_DIRECOES];  // destinos válidos
+	uint64_t mascara[TAB_MAX_CASAS];              // mesmos destinos em bitmask
+} TabelaCavalo;
+
+// Preenche a tabela para um tabuleiro largura x altura (1..8 cada).
+// Retorna 0 para dimensões inválidas.
+int tabela_cavalo_iniciar(TabelaCavalo* t, int largura, int altura);
+
+// Nome algébrico da casa ("a1".."h8") em dst[3]; 0 se fora dos limites.
+int nome_casa_tab(const TabelaCavalo* t, int casa, char dst[3]);
+
+// "c3" -> índice da casa no tabuleiro da tabela; -1 se inválido.
+int casa_tab_de_nome(const TabelaCavalo* t, const char* nome);
+
+// Distância mínima (em saltos) entre todos os pares de casas, preenchida
+// por uma BFS a partir de cada casa. Consulta = uma leitura de tabela.
+#define CAVALO_INALCANCAVEL 0xFF
+
+typedef struct {
+	const TabelaCavalo* tab;
+	uint8_t d[TAB_MAX_CASAS][TAB_MAX_CASAS];
+} DistanciasCavalo;
+
+void distancias_cavalo_iniciar(DistanciasCavalo* dist, const TabelaCavalo* t);
+
+static inline int distancia_cavalo(const DistanciasCavalo* dist, int de, int para) {
+	return dist->d[de][para];
+}
+
+// Um caminho mínimo de 'de' até 'para' (inclusive), guiado pela tabela:
+// a cada salto escolhe um vizinho uma unidade mais perto do destino.
+// Retorna o número de casas em caminho[] ou 0 se inalcançável.
+int caminho_cavalo(const DistanciasCavalo* dist, int de, int para, uint8_t* caminho);
+
+#endif
@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "xadrez_cenarios.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "xadrez_hash.h"
+
+_Static_assert(sizeof(CenarioRegistro) == 20, "CenarioRegistro tem que ter o tamanho do registro no arquivo");
+
+// Campos do cabeçalho (deslocamentos em bytes)
+#define CAB_VERSAO 4
+#define CAB_ORDEM 6
+#define CAB_BYTES_REGISTRO 8
+#define CAB_POR_BLOCO 12
+#define CAB_REGISTROS 20
+#define CAB_BLOCOS 28
+#define CAB_TABELA 36
+#define CAB_RESUMO 56
+
+static inline uint64_t alinhar8(uint64_t v) {
+	return (v + 7) & ~(uint64_t)7;
+}
+
+static inline uint64_t ler64(const uint8_t* p) {
+	uint64_t v;
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+static inline uint32_t ler32(const uint8_t* p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+static inline uint16_t ler16(const uint8_t* p) {
+	uint16_t v;
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ LEITURA
+────────────────────────────────────────────────────────────────────────────
+*/
+
+int cenarios_abrir(Cenarios* c, const char* caminho) {
+	memset(c, 0, sizeof *c);
+	int fd = open(caminho, O_RDONLY);
+	if (fd < 0) return 0;
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return 0;
+	}
+	size_t tam = (size_t)st.st_size;
+	if (tam < CENARIO_CABECALHO) {
+		close(fd);
+		errno = EINVAL;
+		return 0;
+	}
+	void* mapa = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapa == MAP_FAILED) return 0;
+	madvise(mapa, tam, MADV_SEQUENTIAL);
+
+	const uint8_t* cab = mapa;
+	uint64_t n = ler64(cab + CAB_REGISTROS), blocos = ler64(cab + CAB_BLOCOS), tabela = ler64(cab + CAB_TABELA);
+	int ok = memcmp(cab, CENARIO_MAGICO, 4) == 0 && ler16(cab + CAB_VERSAO) == CENARIO_VERSAO &&
+	         ler16(cab + CAB_ORDEM) == CENARIO_ORDEM && ler64(cab + CAB_RESUMO) == hash64(cab, CAB_RESUMO, HASH64_SEMENTE) &&
+	         ler32(cab + CAB_BYTES_REGISTRO) == sizeof(CenarioRegistro) && ler32(cab + CAB_POR_BLOCO) == CENARIO_BLOCO &&
+	         n <= (tam - CENARIO_CABECALHO) / sizeof(CenarioRegistro) && blocos == (n + CENARIO_BLOCO - 1) / CENARIO_BLOCO &&
+	         tabela == alinhar8(CENARIO_CABECALHO + n * sizeof(CenarioRegistro)) && tabela + blocos * 8 == tam;
+	if (!ok) {
+		munmap(mapa, tam);
+		errno = EINVAL;
+		return 0;
+	}
+	c->mapa = mapa;
+	c->tam_mapa = tam;
+	c->registros = (const CenarioRegistro*)(cab + CENARIO_CABECALHO);
+	c->resumos = cab + tabela;
+	c->n = n;
+	c->blocos = blocos;
+	return 1;
+}
+
+void cenarios_fechar(Cenarios* c) {
+	if (c->mapa) munmap((void*)c->mapa, c->tam_mapa);
+	memset(c, 0, sizeof *c);
+}
+
+const CenarioRegistro* cenarios_bloco(Cenarios* c, uint64_t b, size_t* qtd) {
+	if (b >= c->blocos) return NULL;
+	const CenarioRegistro* r = c->registros + b * CENARIO_BLOCO;
+	size_t k = b + 1 == c->blocos ? (size_t)(c->n - b * CENARIO_BLOCO) : CENARIO_BLOCO;
+	if (hash64(r, k * sizeof *r, HASH64_SEMENTE) != ler64(c->resumos + b * 8)) return NULL;
+	c->conferidos++;
+	*qtd = k;
+	return r;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ GRAVAÇÃO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+int cenarios_escritor_abrir(CenariosEscritor* w, FILE* f) {
+	memset(w, 0, sizeof *w);
+	w->f = f;
+	// Cabeçalho provisório: zerado, invalida o arquivo até o fechamento.
+	uint8_t zero[CENARIO_CABECALHO] = { 0 };
+	if (fwrite(zero, 1, sizeof zero, f) != sizeof zero) w->erro = 1;
+	return !w->erro;
+}
+
+static void fechar_bloco(CenariosEscritor* w) {
+	if (!w->no_bloco) return;
+	if (w->blocos == w->cap_resumos) {
+		uint64_t cap = w->cap_resumos ? w->cap_resumos * 2 : 64;
+		uint64_t* novo = realloc(w->resumos, (size_t)cap * sizeof *novo);
+		if (!novo) {
+			w->erro = 1;
+			return;
+		}
+		w->resumos = novo;
+		w->cap_resumos = cap;
+	}
+	w->resumos[w->blocos++] = hash64(w->bloco, w->no_bloco * sizeof(CenarioRegistro), HASH64_SEMENTE);
+	if (fwrite(w->bloco, sizeof(CenarioRegistro), w->no_bloco, w->f) != w->no_bloco) w->erro = 1;
+	w->no_bloco = 0;
+}
+
+int cenarios_escritor_adicionar(CenariosEscritor* w, const CenarioRegistro* r) {
+	w->bloco[w->no_bloco++] = *r;
+	w->n++;
+	if (w->no_bloco == CENARIO_BLOCO) fechar_bloco(w);
+	return !w->erro;
+}
+
+int cenarios_escritor_fechar(CenariosEscritor* w) {
+	fechar_bloco(w);
+	uint64_t fim_registros = CENARIO_CABECALHO + w->n * sizeof(CenarioRegistro);
+	uint64_t tabela = alinhar8(fim_registros);
+	uint8_t cab[CENARIO_CABECALHO] = { 0 };
+	uint16_t versao = CENARIO_VERSAO, ordem = CENARIO_ORDEM;
+	uint32_t bytes = sizeof(CenarioRegistro), por_bloco = CENARIO_BLOCO;
+	memcpy(cab, CENARIO_MAGICO, 4);
+	memcpy(cab + CAB_VERSAO, &versao, 2);
+	memcpy(cab + CAB_ORDEM, &ordem, 2);
+	memcpy(cab + CAB_BYTES_REGISTRO, &bytes, 4);
+	memcpy(cab + CAB_POR_BLOCO, &por_bloco, 4);
+	memcpy(cab + CAB_REGISTROS, &w->n, 8);
+	memcpy(cab + CAB_BLOCOS, &w->blocos, 8);
+	memcpy(cab + CAB_TABELA, &tabela, 8);
+	uint64_t resumo = hash64(cab, CAB_RESUMO, HASH64_SEMENTE);
+	memcpy(cab + CAB_RESUMO, &resumo, 8);
+
+	static const uint8_t zeros[8] = { 0 };
+	if (!w->erro) {
+		size_t pad = (size_t)(tabela - fim_registros);
+		if (fwrite(zeros, 1, pad, w->f) != pad ||
+		    (w->blocos && fwrite(w->resumos, 8, (size_t)w->blocos, w->f) != w->blocos) ||
+		    fseek(w->f, 0, SEEK_SET) != 0 || fwrite(cab, 1, sizeof cab, w->f) != sizeof cab || fflush(w->f) != 0) {
+			w->erro = 1;
+		}
+	}
+	free(w->resumos);
+	w->resumos = NULL;
+	return !w->erro;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ LISTA EM TEXTO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static inline int separador(char c) {
+	return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+int cenario_ler_linha(const char* ini, const char* fim, uint32_t limite, CenarioRegistro* r) {
+	const char* comentario = memchr(ini, '#', (size_t)(fim - ini));
+	if (comentario) fim = comentario;
+	uint32_t* campos[5] = { &r->torre, &r->bispo, &r->rainha, &r->cavalo_v, &r->cavalo_h };
+	while (ini < fim && separador(*ini)) ini++;
+	if (ini == fim) return -1;
+	for (int i = 0; i < 5; i++) {
+		if (i > 0) {
+			if (ini == fim || !separador(*ini)) return 0;
+			while (ini < fim && separador(*ini)) ini++;
+		}
+		uint64_t v = 0;
+		const char* d = ini;
+		while (ini < fim && *ini >= '0' && *ini <= '9' && v <= limite) v = v * 10 + (uint64_t)(*ini++ - '0');
+		if (ini == d || v > limite) return 0;
+		*campos[i] = (uint32_t)v;
+	}
+	while (ini < fim && separador(*ini)) ini++;
+	return ini == fim;
+}
@@ -0,0 +1,86 @@
+#ifndef XADREZ_CENARIOS_H
+#define XADREZ_CENARIOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Arquivo de cenários pré-compilado (.xcn): a lista "torre bispo rainha
+// cavaloV cavaloH" já convertida em registros de tamanho fixo, lidos direto
+// do mmap (nenhum parse, nenhuma cópia: o programa itera ponteiros para
+// os registros do próprio mapa).
+//
+// Formato (inteiros na ordem de bytes da máquina que gravou; o campo
+// 'ordem' recusa o arquivo numa máquina de ordem diferente):
+//   cabeçalho (64 bytes):
+//     "XCN1" | versão (u16) | ordem = 0x0102 (u16) | bytes por registro (u32)
+//     | registros por bloco (u32) | reservado (u32) | registros (u64)
+//     | blocos (u64) | início da tabela de resumos (u64) | 0 (8 bytes)
+//     | xxh64 dos bytes 0..55 (u64)
+//   registros: n x CenarioRegistro, a partir do byte 64
+//   zeros até múltiplo de 8, tabela de resumos: um xxh64 por bloco
+//
+// Abrir confere só o cabeçalho e o tamanho do arquivo (custo fixo); cada
+// bloco de CENARIO_BLOCO registros é conferido quando é pedido pela
+// primeira vez. O primeiro resultado sai depois de um bloco, qualquer
+// que seja o tamanho do arquivo.
+
+#define CENARIO_MAGICO "XCN1"
+#define CENARIO_VERSAO 1
+#define CENARIO_ORDEM 0x0102
+#define CENARIO_CABECALHO 64
+#define CENARIO_BLOCO 4096
+
+// Maior número de passos por peça: argumentos, --lote e .xcn.
+#define LIMITE_PASSOS 100000000
+
+typedef struct {
+	uint32_t torre;
+	uint32_t bispo;
+	uint32_t rainha;
+	uint32_t cavalo_v;
+	uint32_t cavalo_h;
+} CenarioRegistro;
+
+typedef struct {
+	const uint8_t* mapa;
+	size_t tam_mapa;
+	const CenarioRegistro* registros;
+	const uint8_t* resumos;   // xxh64 por bloco (u64 na ordem da máquina)
+	uint64_t n;
+	uint64_t blocos;
+	uint64_t conferidos;      // blocos já conferidos
+} Cenarios;
+
+// Mapeia e confere o cabeçalho; retorna 0 (com errno; EINVAL = formato)
+// se falhar. Não lê os registros.
+int cenarios_abrir(Cenarios* c, const char* caminho);
+void cenarios_fechar(Cenarios* c);
+
+// Registros do bloco b (*qtd deles, até CENARIO_BLOCO), conferidos contra
+// o resumo do bloco; NULL se o bloco está corrompido.
+const CenarioRegistro* cenarios_bloco(Cenarios* c, uint64_t b, size_t* qtd);
+
+// Gravação em streaming, com memória de um bloco: o destino tem que
+// aceitar fseek (o cabeçalho é gravado por último).
+typedef struct {
+	FILE* f;
+	CenarioRegistro bloco[CENARIO_BLOCO];
+	size_t no_bloco;
+	uint64_t n;
+	uint64_t* resumos;
+	uint64_t blocos, cap_resumos;
+	int erro;
+} CenariosEscritor;
+
+int cenarios_escritor_abrir(CenariosEscritor* w, FILE* f);
+int cenarios_escritor_adicionar(CenariosEscritor* w, const CenarioRegistro* r);
+// Grava o último bloco, a tabela e o cabeçalho; não fecha f. 1 se tudo ok.
+int cenarios_escritor_fechar(CenariosEscritor* w);
+
+// Uma linha da lista em texto: 5 valores separados por espaço, tab ou
+// vírgula, '#' até o fim da linha é comentário. 1 se válida, 0 se
+// inválida (ou valor acima de 'limite'), -1 se em branco.
+int cenario_ler_linha(const char* ini, const char* fim, uint32_t limite, CenarioRegistro* r);
+
+#endif
@@ -0,0 +1,184 @@
+#include "xadrez_compressao.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static inline uint32_t ler32(const uint8_t* p) {
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+static inline uint32_t hash4(uint32_t v) {
+	return (v * 2654435761u) >> (32 - LZ_BITS_TABELA);
+}
+
+// Comprimento em nibble + bytes de 255 (o resto no último byte).
+static inline uint8_t* gravar_extra(uint8_t* o, size_t v) {
+	for (; v >= 255; v -= 255) *o++ = 255;
+	*o++ = (uint8_t)v;
+	return o;
+}
+
+static inline uint8_t* gravar_sequencia(uint8_t* o, const uint8_t* lit, size_t nlit, size_t offset, size_t nmatch) {
+	uint8_t* token = o++;
+	size_t m = nmatch ? nmatch - LZ_MATCH_MIN : 0;
+	*token = (uint8_t)(((nlit < 15 ? nlit : 15) << 4) | (m < 15 ? m : 15));
+	if (nlit >= 15) o = gravar_extra(o, nlit - 15);
+	memcpy(o, lit, nlit);
+	o += nlit;
+	if (!nmatch) return o;
+	*o++ = (uint8_t)offset;
+	*o++ = (uint8_t)(offset >> 8);
+	if (m >= 15) o = gravar_extra(o, m - 15);
+	return o;
+}
+
+size_t lz_comprimir(const uint8_t* in, size_t n, uint8_t* out, uint32_t* tabela) {
+	uint8_t* o = out;
+	size_t ip = 0, ancora = 0;
+	memset(tabela, 0, sizeof *tabela << LZ_BITS_TABELA);
+	if (n >= LZ_MATCH_MIN) {
+		size_t limite = n - LZ_MATCH_MIN;
+		while (ip <= limite) {
+			uint32_t v = ler32(in + ip);
+			uint32_t h = hash4(v);
+			size_t cand = tabela[h];
+			tabela[h] = (uint32_t)ip;
+			if (cand < ip && ip - cand <= 0xFFFF && ler32(in + cand) == v) {
+				size_t m = LZ_MATCH_MIN;
+				while (ip + m < n && in[cand + m] == in[ip + m]) m++;
+				o = gravar_sequencia(o, in + ancora, ip - ancora, ip - cand, m);
+				ip += m;
+				ancora = ip;
+				// Repõe uma posição dentro do match para o próximo achar o período.
+				if (ip - 2 <= limite) tabela[hash4(ler32(in + ip - 2))] = (uint32_t)(ip - 2);
+			} else {
+				// Sem match há tempo: avança mais rápido em trechos incompressíveis.
+				ip += 1 + ((ip - ancora) >> 6);
+			}
+		}
+	}
+	return (size_t)(gravar_sequencia(o, in + ancora, n - ancora, 0, 0) - out);
+}
+
+// Lê um comprimento estendido; -1 se o bloco acabar antes.
+static inline long ler_extra(const uint8_t* in, size_t n, size_t* ip, size_t base) {
+	size_t v = base;
+	uint8_t b;
+	do {
+		if (*ip >= n) return -1;
+		b = in[(*ip)++];
+		v += b;
+	} while (b == 255);
+	return (long)v;
+}
+
+long lz_descomprimir(const uint8_t* in, size_t n, uint8_t* out, size_t cap) {
+	size_t ip = 0, op = 0;
+	while (ip < n) {
+		uint8_t token = in[ip++];
+		long nlit = token >> 4;
+		if (nlit == 15 && (nlit = ler_extra(in, n, &ip, 15)) < 0) return -1;
+		if ((size_t)nlit > n - ip || (size_t)nlit > cap - op) return -1;
+		memcpy(out + op, in + ip, (size_t)nlit);
+		ip += (size_t)nlit;
+		op += (size_t)nlit;
+		if (ip == n) break; // última sequência: só literais
+
+		if (n - ip < 2) return -1;
+		size_t offset = (size_t)in[ip] | (size_t)in[ip + 1] << 8;
+		ip += 2;
+		if (offset == 0 || offset > op) return -1;
+		long m = token & 15;
+		if (m == 15 && (m = ler_extra(in, n, &ip, 15)) < 0) return -1;
+		size_t resto = (size_t)m + LZ_MATCH_MIN;
+		if (resto > cap - op) return -1;
+		// Cópia sobreposta por dobra: cada memcpy lê só bytes já escritos.
+		const uint8_t* src = out + op - offset;
+		while (resto > 0) {
+			size_t k = (size_t)(out + op - src);
+			if (k > resto) k = resto;
+			memcpy(out + op, src, k);
+			op += k;
+			resto -= k;
+		}
+	}
+	return (long)op;
+}
+
+static inline void gravar_u32(uint8_t* p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+// Gancho de flush: o buffer vira um quadro (comprimido, ou cru se não
+// compensar) escrito no destino.
+static int descarregar_comprimindo(Saida* s) {
+	CompressorSaida* c = s->ctx;
+	if (s->len == 0) return !s->erro;
+	size_t n = lz_comprimir((const uint8_t*)s->buf, s->len, c->comprimido + 8, c->tabela);
+	uint32_t gravado = (uint32_t)n;
+	const uint8_t* dados = c->comprimido + 8;
+	if (n >= s->len) {
+		gravado = (uint32_t)s->len | LZ_QUADRO_CRU;
+		dados = (const uint8_t*)s->buf;
+		n = s->len;
+	}
+	gravar_u32(c->comprimido, (uint32_t)s->len);
+	gravar_u32(c->comprimido + 4, gravado);
+	if (dados == c->comprimido + 8) {
+		saida_escrever(c->destino, c->comprimido, n + 8);
+	} else {
+		saida_escrever(c->destino, c->comprimido, 8);
+		saida_escrever(c->destino, dados, n);
+	}
+	s->erro = c->destino->erro;
+	if (!s->erro) s->total += s->len;
+	s->len = 0;
+	return !s->erro;
+}
+
+static int encerrar_compressao(Saida* s) {
+	CompressorSaida* c = s->ctx;
+	descarregar_comprimindo(s);
+	static const uint8_t fim[8] = { 0 };
+	saida_escrever(c->destino, fim, sizeof fim);
+	s->erro = c->destino->erro;
+	free(s->buf);
+	free(c->comprimido);
+	free(c->tabela);
+	s->buf = NULL;
+	s->cap = 0;
+	s->descarregar = NULL;
+	s->encerrar = NULL;
+	return !s->erro;
+}
+
+int saida_abrir_compressao(Saida* s, CompressorSaida* c, Saida* destino, size_t cap) {
+	if (!s || !c || !destino) return 0;
+	if (cap < 64 || cap > LZ_BLOCO_MAX) cap = LZ_BLOCO_MAX;
+	s->buf = malloc(cap);
+	c->comprimido = malloc(lz_limite(cap) + 8);
+	c->tabela = malloc(sizeof *c->tabela << LZ_BITS_TABELA);
+	if (!s->buf || !c->comprimido || !c->tabela) {
+		free(s->buf);
+		free(c->comprimido);
+		free(c->tabela);
+		s->buf = NULL;
+		return 0;
+	}
+	c->destino = destino;
+	s->fd = destino->fd;
+	s->cap = cap;
+	s->len = 0;
+	s->total = 0;
+	s->erro = 0;
+	s->descarregar = descarregar_comprimindo;
+	s->encerrar = encerrar_compressao;
+	s->ctx = c;
+	saida_escrever(destino, LZ_MAGICO, 4);
+	return 1;
+}
@@ -0,0 +1,53 @@
+#ifndef XADREZ_COMPRESSAO_H
+#define XADREZ_COMPRESSAO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xadrez_saida.h"
+
+// Compressão LZ sem dicionário para traços de passos (texto muito
+// repetitivo), no estilo do LZ4: cada bloco de até 64 KiB é comprimido de
+// forma independente em sequências
+//   token | [literais extra] | literais | offset (2 bytes LE) | [match extra]
+// com o nibble alto do token = nº de literais e o baixo = comprimento do
+// match - 4 (15 = continua em bytes de 255). A última sequência só tem
+// literais. Matches são achados por uma tabela hash de 4 bytes, guloso.
+//
+// Formato do fluxo (.xzl):
+//   "XZL1"
+//   quadros: bruto (u32 LE) | gravado (u32 LE, bit 31 = bloco sem compressão) | dados
+//   fim: quadro com bruto = 0 (e gravado = 0)
+
+#define LZ_MAGICO "XZL1"
+#define LZ_BLOCO_MAX (1u << 16)
+#define LZ_MATCH_MIN 4
+#define LZ_BITS_TABELA 14
+#define LZ_QUADRO_CRU 0x80000000u
+
+// Pior caso do comprimido para n bytes de entrada.
+static inline size_t lz_limite(size_t n) {
+	return n + n / 255 + 16;
+}
+
+// Comprime in[0..n) (n <= LZ_BLOCO_MAX) em out (>= lz_limite(n) bytes).
+// tabela: 1 << LZ_BITS_TABELA entradas de trabalho. Retorna bytes gravados.
+size_t lz_comprimir(const uint8_t* in, size_t n, uint8_t* out, uint32_t* tabela);
+
+// Descomprime um bloco; retorna os bytes produzidos ou -1 se o bloco for
+// inválido (nunca lê nem escreve fora de in[0..n) e out[0..cap)).
+long lz_descomprimir(const uint8_t* in, size_t n, uint8_t* out, size_t cap);
+
+// Saída comprimida: s recebe o texto bruto pelos escritores inline de
+// sempre; cada buffer cheio vira um quadro escrito em 'destino' (que pode
+// ser outra Saida com anel). saida_fechar(s) grava o quadro final mas não
+// fecha 'destino'. s->total conta bytes brutos; destino->total, comprimidos.
+typedef struct {
+	Saida* destino;
+	uint8_t* comprimido;  // lz_limite(cap) bytes
+	uint32_t* tabela;
+} CompressorSaida;
+
+int saida_abrir_compressao(Saida* s, CompressorSaida* c, Saida* destino, size_t cap);
+
+#endif
@@ -0,0 +1,257 @@
+#include "xadrez_estado.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ CHAVES ZOBRIST
+
+ Sorteadas uma vez (splitmix64 com semente fixa, então a chave de uma
+ posição é a mesma entre execuções) antes de main, sem corrida entre
+ threads.
+────────────────────────────────────────────────────────────────────────────
+*/
+static uint64_t Z_PECA[2 * TP_QTD][64];
+static uint64_t Z_ROQUES[16];
+static uint64_t Z_EN_PASSANT[8];
+static uint64_t Z_PRETAS;
+
+static uint64_t splitmix64(uint64_t* s) {
+	uint64_t z = (*s += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+__attribute__((constructor)) static void zobrist_iniciar(void) {
+	uint64_t s = 0x5851F42D4C957F2DULL;
+	for (int p = 0; p < 2 * TP_QTD; p++) {
+		for (int c = 0; c < 64; c++) Z_PECA[p][c] = splitmix64(&s);
+	}
+	// Combinações de direitos: XOR das chaves de cada direito.
+	uint64_t z_direito[4];
+	for (int i = 0; i < 4; i++) z_direito[i] = splitmix64(&s);
+	for (int r = 0; r < 16; r++) {
+		Z_ROQUES[r] = 0;
+		for (int i = 0; i < 4; i++) {
+			if (r & (1 << i)) Z_ROQUES[r] ^= z_direito[i];
+		}
+	}
+	for (int c = 0; c < 8; c++) Z_EN_PASSANT[c] = splitmix64(&s);
+	Z_PRETAS = splitmix64(&s);
+}
+
+static inline uint64_t z_en_passant(int8_t ep) {
+	return ep == SEM_EN_PASSANT ? 0 : Z_EN_PASSANT[ep % 8];
+}
+
+uint64_t zobrist_calcular(const Tabuleiro* t) {
+	uint64_t h = Z_ROQUES[t->roques & 15] ^ z_en_passant(t->en_passant);
+	if (t->lado == COR_PRETA) h ^= Z_PRETAS;
+	for (int c = 0; c < 64; c++) {
+		if (t->casa[c] != CASA_VAZIA) h ^= Z_PECA[t->casa[c]][c];
+	}
+	return h;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ MAPAS DE ATAQUE
+────────────────────────────────────────────────────────────────────────────
+*/
+
+// Ataques de todas as peças de um tipo de uma vez (set-wise).
+static inline Bitboard ataques_tipo(Bitboard pecas, Cor cor, TipoPeca tipo, Bitboard ocupadas) {
+	switch (tipo) {
+	case TP_PEAO: return ataques_peao(pecas, cor);
+	case TP_CAVALO: return ataques_cavalo(pecas);
+	case TP_BISPO: return pecas ? bb_ataques_deslizantes(PECA_BISPO, pecas, ~ocupadas) : 0;
+	case TP_TORRE: return pecas ? bb_ataques_deslizantes(PECA_TORRE, pecas, ~ocupadas) : 0;
+	case TP_RAINHA: return pecas ? bb_ataques_deslizantes(PECA_RAINHA, pecas, ~ocupadas) : 0;
+	default: return ataques_rei(pecas);
+	}
+}
+
+// Refaz os mapas dos tipos em 'tipos[cor]' (bits de TipoPeca) e dos
+// deslizantes cujo ataque alcança 'tocadas'.
+static void atualizar_ataques(Estado* e, const unsigned tipos[2], Bitboard tocadas) {
+	Bitboard ocupadas = tabuleiro_ocupadas(&e->t);
+	for (int c = 0; c < 2; c++) {
+		unsigned refazer = tipos[c];
+		for (int tp = TP_BISPO; tp <= TP_RAINHA; tp++) {
+			if (e->ataques[c][tp] & tocadas) refazer |= 1u << tp;
+		}
+		if (!refazer) continue;
+		for (; refazer; refazer &= refazer - 1) {
+			int tp = __builtin_ctz(refazer);
+			e->ataques[c][tp] = ataques_tipo(e->t.pecas[c][tp], (Cor)c, (TipoPeca)tp, ocupadas);
+		}
+		const Bitboard* a = e->ataques[c];
+		e->atacadas[c] = a[0] | a[1] | a[2] | a[3] | a[4] | a[5];
+	}
+}
+
+void estado_iniciar(Estado* e, const Tabuleiro* t) {
+	e->t = *t;
+	e->chave = zobrist_calcular(t);
+	unsigned todos[2] = { (1u << TP_QTD) - 1, (1u << TP_QTD) - 1 };
+	atualizar_ataques(e, todos, 0);
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ FAZER / DESFAZER
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static inline void mover(Estado* e, int de, int para) {
+	uint8_t cod = e->t.casa[de];
+	tabuleiro_tirar(&e->t, de);
+	tabuleiro_por(&e->t, para, cod);
+	e->chave ^= Z_PECA[cod][de] ^ Z_PECA[cod][para];
+}
+
+static inline void tirar(Estado* e, int casa) {
+	e->chave ^= Z_PECA[e->t.casa[casa]][casa];
+	tabuleiro_tirar(&e->t, casa);
+}
+
+static inline void por(Estado* e, int casa, uint8_t cod) {
+	e->chave ^= Z_PECA[cod][casa];
+	tabuleiro_por(&e->t, casa, cod);
+}
+
+void estado_fazer(Estado* e, Lance l, Desfazer* d) {
+	Tabuleiro* t = &e->t;
+	Cor nos = (Cor)t->lado, eles = (Cor)!nos;
+	d->lance = l;
+	d->roques = t->roques;
+	d->en_passant = t->en_passant;
+	d->meio_lance = t->meio_lance;
+	d->chave = e->chave;
+	memcpy(d->ataques, e->ataques, sizeof d->ataques);
+
+	uint8_t cod = t->casa[l.de];
+	TipoPeca tipo = COD_TIPO(cod);
+	unsigned tipos[2] = { 0, 0 };
+	tipos[nos] = 1u << tipo;
+	Bitboard tocadas = BB_CASA(l.de) | BB_CASA(l.para);
+
+	int casa_captura = (l.flags & LANCE_EN_PASSANT) ? (nos == COR_BRANCA ? l.para - 8 : l.para + 8) : l.para;
+	d->capturada = t->casa[casa_captura];
+	if (d->capturada != CASA_VAZIA) {
+		tipos[eles] = 1u << COD_TIPO(d->capturada);
+		tocadas |= BB_CASA(casa_captura);
+		tirar(e, casa_captura);
+	}
+	if (l.promocao) {
+		tirar(e, l.de);
+		por(e, l.para, PECA_COD(nos, l.promocao));
+		tipos[nos] |= 1u << l.promocao;
+	} else {
+		mover(e, l.de, l.para);
+	}
+	if (l.flags & LANCE_ROQUE) {
+		int base = l.de & 56;
+		int de = l.para > l.de ? base + 7 : base;
+		int para = l.para > l.de ? base + 5 : base + 3;
+		mover(e, de, para);
+		tipos[nos] |= 1u << TP_TORRE;
+		tocadas |= BB_CASA(de) | BB_CASA(para);
+	}
+
+	uint8_t roques = t->roques & (uint8_t)~(ROQUE_PERDIDO[l.de] | ROQUE_PERDIDO[l.para]);
+	int8_t ep = (l.flags & LANCE_DUPLO) ? (int8_t)((l.de + l.para) / 2) : SEM_EN_PASSANT;
+	e->chave ^= Z_ROQUES[t->roques] ^ Z_ROQUES[roques] ^ z_en_passant(t->en_passant) ^ z_en_passant(ep) ^ Z_PRETAS;
+	t->roques = roques;
+	t->en_passant = ep;
+	if (tipo == TP_PEAO || d->capturada != CASA_VAZIA) t->meio_lance = 0;
+	else t->meio_lance = (uint16_t)(t->meio_lance + (t->meio_lance < 65535));
+	if (nos == COR_PRETA) t->lance++;
+	t->lado = (uint8_t)eles;
+
+	atualizar_ataques(e, tipos, tocadas);
+}
+
+void estado_desfazer(Estado* e, const Desfazer* d) {
+	Tabuleiro* t = &e->t;
+	Lance l = d->lance;
+	Cor nos = (Cor)!t->lado;
+	t->lado = (uint8_t)nos;
+	if (nos == COR_PRETA) t->lance--;
+
+	if (l.flags & LANCE_ROQUE) {
+		int base = l.de & 56;
+		int de = l.para > l.de ? base + 7 : base;
+		int para = l.para > l.de ? base + 5 : base + 3;
+		uint8_t torre = t->casa[para];
+		tabuleiro_tirar(t, para);
+		tabuleiro_por(t, de, torre);
+	}
+	if (l.promocao) {
+		tabuleiro_tirar(t, l.para);
+		tabuleiro_por(t, l.de, PECA_COD(nos, TP_PEAO));
+	} else {
+		uint8_t cod = t->casa[l.para];
+		tabuleiro_tirar(t, l.para);
+		tabuleiro_por(t, l.de, cod);
+	}
+	if (d->capturada != CASA_VAZIA) {
+		int casa_captura = (l.flags & LANCE_EN_PASSANT) ? (nos == COR_BRANCA ? l.para - 8 : l.para + 8) : l.para;
+		tabuleiro_por(t, casa_captura, d->capturada);
+	}
+
+	t->roques = d->roques;
+	t->en_passant = d->en_passant;
+	t->meio_lance = d->meio_lance;
+	e->chave = d->chave;
+	memcpy(e->ataques, d->ataques, sizeof e->ataques);
+	for (int c = 0; c < 2; c++) {
+		const Bitboard* a = e->ataques[c];
+		e->atacadas[c] = a[0] | a[1] | a[2] | a[3] | a[4] | a[5];
+	}
+}
+
+int estado_conferir(const Estado* e) {
+	const Tabuleiro* t = &e->t;
+	int ok = 1;
+	Bitboard ocupadas = tabuleiro_ocupadas(t);
+	for (int c = 0; c < 2; c++) {
+		Bitboard uniao = 0, cor = 0;
+		for (int tp = 0; tp < TP_QTD; tp++) {
+			Bitboard a = ataques_tipo(t->pecas[c][tp], (Cor)c, (TipoPeca)tp, ocupadas);
+			uniao |= a;
+			cor |= t->pecas[c][tp];
+			if (a != e->ataques[c][tp]) {
+				fprintf(stderr, "conferir: ataques[%d][%d] = %016llx, esperado %016llx\n", c, tp,
+						(unsigned long long)e->ataques[c][tp], (unsigned long long)a);
+				ok = 0;
+			}
+		}
+		if (uniao != e->atacadas[c]) {
+			fprintf(stderr, "conferir: atacadas[%d] divergente\n", c);
+			ok = 0;
+		}
+		if (cor != t->cor[c]) {
+			fprintf(stderr, "conferir: cor[%d] divergente das peças\n", c);
+			ok = 0;
+		}
+	}
+	for (int c = 0; c < 64; c++) {
+		uint8_t cod = t->casa[c];
+		int na_mailbox = cod != CASA_VAZIA;
+		if (na_mailbox != (int)((ocupadas >> c) & 1) ||
+		    (na_mailbox && !((t->pecas[COD_COR(cod)][COD_TIPO(cod)] >> c) & 1))) {
+			fprintf(stderr, "conferir: casa %d diverge dos bitboards\n", c);
+			ok = 0;
+		}
+	}
+	uint64_t chave = zobrist_calcular(t);
+	if (chave != e->chave) {
+		fprintf(stderr, "conferir: chave %016llx, esperada %016llx\n",
+				(unsigned long long)e->chave, (unsigned long long)chave);
+		ok = 0;
+	}
+	return ok;
+}
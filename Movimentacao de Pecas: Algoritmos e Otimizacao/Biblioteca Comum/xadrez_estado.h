@@ -0,0 +1,57 @@
+#ifndef XADREZ_ESTADO_H
+#define XADREZ_ESTADO_H
+
+#include <stdint.h>
+
+#include "xadrez_lances.h"
+
+// Estado de busca: o Tabuleiro mais o que é caro recalcular a cada nó,
+// mantido de forma incremental por fazer/desfazer (make/unmake) em vez de
+// copiar a posição inteira:
+//   - chave Zobrist (XOR de uma chave por peça/casa, lado, roques e coluna
+//     de en passant), atualizada só nas casas tocadas;
+//   - mapas de ataque por cor e tipo de peça. Num lance, só são refeitos os
+//     tipos cujas peças mudaram e os deslizantes cujo ataque passava por uma
+//     casa tocada (só essas casas podem abrir ou fechar um raio).
+// Desfazer restaura o que não dá para inverter (roques, en passant,
+// contador, chave e mapas) a partir do registro gravado ao fazer.
+
+typedef struct {
+	Tabuleiro t;
+	uint64_t chave;
+	Bitboard ataques[2][TP_QTD];  // casas atacadas por cada cor e tipo
+	Bitboard atacadas[2];         // união dos tipos de cada cor
+} Estado;
+
+typedef struct {
+	Lance lance;
+	uint8_t capturada;   // código da peça capturada ou CASA_VAZIA
+	uint8_t roques;
+	int8_t en_passant;
+	uint16_t meio_lance;
+	uint64_t chave;
+	Bitboard ataques[2][TP_QTD];
+} Desfazer;
+
+// Chave Zobrist calculada do zero.
+uint64_t zobrist_calcular(const Tabuleiro* t);
+
+// Inicializa o estado a partir de t (cálculo completo).
+void estado_iniciar(Estado* e, const Tabuleiro* t);
+
+// Faz um lance legal, gravando em d o necessário para desfazê-lo.
+void estado_fazer(Estado* e, Lance l, Desfazer* d);
+
+// Desfaz o último lance feito com d.
+void estado_desfazer(Estado* e, const Desfazer* d);
+
+// Modo de depuração: recalcula tudo do zero e compara com o estado
+// incremental. Retorna 1 se confere; senão escreve a divergência em stderr.
+int estado_conferir(const Estado* e);
+
+static inline int estado_em_xeque(const Estado* e) {
+	Cor nos = (Cor)e->t.lado;
+	return (e->atacadas[!nos] & e->t.pecas[nos][TP_REI]) != 0;
+}
+
+#endif
@@ -0,0 +1,215 @@
+#include "xadrez_fen.h"
+
+#include "xadrez_saida.h"
+
+// Classes do classificador de bytes.
+enum {
+	CL_INVALIDO,
+	CL_PECA,
+	CL_VAZIAS,
+	CL_BARRA,
+	CL_ESPACO
+};
+
+static const uint8_t CLASSE[256] = {
+	['P'] = CL_PECA, ['N'] = CL_PECA, ['B'] = CL_PECA, ['R'] = CL_PECA, ['Q'] = CL_PECA, ['K'] = CL_PECA,
+	['p'] = CL_PECA, ['n'] = CL_PECA, ['b'] = CL_PECA, ['r'] = CL_PECA, ['q'] = CL_PECA, ['k'] = CL_PECA,
+	['1'] = CL_VAZIAS, ['2'] = CL_VAZIAS, ['3'] = CL_VAZIAS, ['4'] = CL_VAZIAS,
+	['5'] = CL_VAZIAS, ['6'] = CL_VAZIAS, ['7'] = CL_VAZIAS, ['8'] = CL_VAZIAS,
+	['/'] = CL_BARRA,
+	[' '] = CL_ESPACO, ['\t'] = CL_ESPACO,
+};
+
+// Avanço na ordem da FEN (a8, b8, ..., h1) causado por cada byte da
+// disposição: 1 por peça, n por dígito, 0 na barra.
+static const uint8_t AVANCO[256] = {
+	['P'] = 1, ['N'] = 1, ['B'] = 1, ['R'] = 1, ['Q'] = 1, ['K'] = 1,
+	['p'] = 1, ['n'] = 1, ['b'] = 1, ['r'] = 1, ['q'] = 1, ['k'] = 1,
+	['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4, ['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8,
+};
+
+// Código da peça + 1 de cada letra; 0 para dígitos e barra. Subtraindo 1
+// em uint8_t, os não-peças viram CASA_VAZIA sem desvio.
+#define IDX(cor, tipo) (PECA_COD(cor, tipo) + 1)
+static const uint8_t IDX_PECA[256] = {
+	['P'] = IDX(COR_BRANCA, TP_PEAO), ['N'] = IDX(COR_BRANCA, TP_CAVALO),
+	['B'] = IDX(COR_BRANCA, TP_BISPO), ['R'] = IDX(COR_BRANCA, TP_TORRE),
+	['Q'] = IDX(COR_BRANCA, TP_RAINHA), ['K'] = IDX(COR_BRANCA, TP_REI),
+	['p'] = IDX(COR_PRETA, TP_PEAO), ['n'] = IDX(COR_PRETA, TP_CAVALO),
+	['b'] = IDX(COR_PRETA, TP_BISPO), ['r'] = IDX(COR_PRETA, TP_TORRE),
+	['q'] = IDX(COR_PRETA, TP_RAINHA), ['k'] = IDX(COR_PRETA, TP_REI),
+};
+
+// Letra FEN de cada código de peça.
+static const char LETRA[2 * TP_QTD] = { 'P', 'N', 'B', 'R', 'Q', 'K', 'p', 'n', 'b', 'r', 'q', 'k' };
+
+// Bit de roque de cada letra.
+static const uint8_t BIT_ROQUE[256] = { ['K'] = ROQUE_K, ['Q'] = ROQUE_Q, ['k'] = ROQUE_k, ['q'] = ROQUE_q };
+
+static const char* const MSG_ERRO[FEN_ERRO_QTD] = {
+	[FEN_OK] = "ok",
+	[FEN_ERRO_CARACTERE] = "caractere inválido na disposição",
+	[FEN_ERRO_FILEIRA] = "fileira sem 8 casas",
+	[FEN_ERRO_FILEIRAS] = "disposição sem 8 fileiras",
+	[FEN_ERRO_REIS] = "é preciso exatamente um rei de cada cor",
+	[FEN_ERRO_LADO] = "lado a jogar inválido",
+	[FEN_ERRO_ROQUE] = "direitos de roque inválidos",
+	[FEN_ERRO_EN_PASSANT] = "casa de en passant inválida",
+	[FEN_ERRO_CONTADOR] = "contador de lances inválido",
+	[FEN_ERRO_CAMPOS] = "número de campos inválido",
+};
+
+const char* fen_erro_msg(FenErro e) {
+	return (unsigned)e < FEN_ERRO_QTD ? MSG_ERRO[e] : "erro desconhecido";
+}
+
+static inline const char* pular_espacos(const char* p, const char* fim) {
+	while (p < fim && CLASSE[(uint8_t)*p] == CL_ESPACO) p++;
+	return p;
+}
+
+// Número decimal até o próximo espaço; 0 se vazio, não numérico ou > max.
+static int ler_contador(const char** pp, const char* fim, uint32_t max, uint32_t* out) {
+	const char* p = *pp;
+	uint32_t v = 0;
+	int digitos = 0;
+	while (p < fim && *p >= '0' && *p <= '9') {
+		v = v * 10 + (uint32_t)(*p++ - '0');
+		if (++digitos > 9 || v > max) return 0;
+	}
+	if (!digitos || (p < fim && CLASSE[(uint8_t)*p] != CL_ESPACO)) return 0;
+	*out = v;
+	*pp = p;
+	return 1;
+}
+
+FenErro fen_ler(Tabuleiro* t, const char* ini, const char* fim) {
+	while (fim > ini && (fim[-1] == '\r' || fim[-1] == '\n')) fim--;
+	tabuleiro_limpar(t);
+	const char* p = pular_espacos(ini, fim);
+
+	// 1. Disposição: k conta as casas na ordem da FEN (a8 = 0 ... h1 = 63),
+	// então a casa é k ^ 56. Cada byte só consulta tabelas, sem desvio por
+	// classe: grava o código na mailbox (dígitos e barras gravam CASA_VAZIA
+	// numa casa ainda vazia), marca a ocupação num registrador e avança k.
+	// Barras são validadas pela aritmética: a s-ésima precisa vir em k = 8s.
+	unsigned k = 0, barras = 0, erro = 0;
+	Bitboard ocupadas = 0;
+	uint8_t c;
+	while (p < fim && CLASSE[c = (uint8_t)*p] >= CL_PECA && CLASSE[c] <= CL_BARRA) {
+		unsigned barra = CLASSE[c] == CL_BARRA;
+		unsigned casa = (k ^ 56) & 63;
+		t->casa[casa] = (uint8_t)(IDX_PECA[c] - 1);
+		ocupadas |= (Bitboard)(IDX_PECA[c] != 0) << casa;
+		erro |= (k > 63) & !barra;
+		erro |= barra & (k != 8 * (barras + 1));
+		barras += barra;
+		k += AVANCO[c];
+		p++;
+	}
+	if (p < fim && CLASSE[(uint8_t)*p] != CL_ESPACO) return FEN_ERRO_CARACTERE;
+	if (barras != 7) return FEN_ERRO_FILEIRAS;
+	if (erro || k != 64) return FEN_ERRO_FILEIRA;
+	// Bitboards só a partir das casas ocupadas (pecas[2][6] visto como 12
+	// bitboards indexados pelo código da peça).
+	Bitboard* bbs = &t->pecas[0][0];
+	for (Bitboard b = ocupadas; b; b &= b - 1) {
+		int sq = __builtin_ctzll(b);
+		bbs[t->casa[sq]] |= BB_CASA(sq);
+	}
+	t->cor[COR_BRANCA] = bbs[0] | bbs[1] | bbs[2] | bbs[3] | bbs[4] | bbs[5];
+	t->cor[COR_PRETA] = ocupadas & ~t->cor[COR_BRANCA];
+	if (__builtin_popcountll(t->pecas[COR_BRANCA][TP_REI]) != 1 ||
+	    __builtin_popcountll(t->pecas[COR_PRETA][TP_REI]) != 1) return FEN_ERRO_REIS;
+
+	// 2. Lado a jogar.
+	p = pular_espacos(p, fim);
+	if (p >= fim) return FEN_ERRO_CAMPOS;
+	if (*p == 'w') t->lado = COR_BRANCA;
+	else if (*p == 'b') t->lado = COR_PRETA;
+	else return FEN_ERRO_LADO;
+	p++;
+	if (p < fim && CLASSE[(uint8_t)*p] != CL_ESPACO) return FEN_ERRO_LADO;
+
+	// 3. Roques: '-' ou subconjunto de "KQkq" sem repetição.
+	p = pular_espacos(p, fim);
+	if (p >= fim) return FEN_ERRO_CAMPOS;
+	if (*p == '-') {
+		p++;
+	} else {
+		while (p < fim && CLASSE[(uint8_t)*p] != CL_ESPACO) {
+			uint8_t bit = BIT_ROQUE[(uint8_t)*p++];
+			if (!bit || (t->roques & bit)) return FEN_ERRO_ROQUE;
+			t->roques |= bit;
+		}
+	}
+	if (p < fim && CLASSE[(uint8_t)*p] != CL_ESPACO) return FEN_ERRO_ROQUE;
+
+	// 4. En passant: '-' ou casa na 3ª (pretas jogam) / 6ª (brancas) fileira.
+	p = pular_espacos(p, fim);
+	if (p >= fim) return FEN_ERRO_CAMPOS;
+	if (*p == '-') {
+		p++;
+	} else {
+		if (fim - p < 2) return FEN_ERRO_EN_PASSANT;
+		unsigned col = (unsigned)(p[0] - 'a'), lin = (unsigned)(p[1] - '1');
+		unsigned esperada = t->lado == COR_BRANCA ? 5 : 2;
+		if (col >= 8 || lin != esperada) return FEN_ERRO_EN_PASSANT;
+		t->en_passant = (int8_t)(lin * 8 + col);
+		p += 2;
+	}
+	if (p < fim && CLASSE[(uint8_t)*p] != CL_ESPACO) return FEN_ERRO_EN_PASSANT;
+
+	// 5-6. Contadores (opcionais, mas os dois juntos).
+	p = pular_espacos(p, fim);
+	if (p == fim) return FEN_OK;
+	uint32_t meio, lance;
+	if (!ler_contador(&p, fim, 65535, &meio)) return FEN_ERRO_CONTADOR;
+	p = pular_espacos(p, fim);
+	if (p == fim) return FEN_ERRO_CAMPOS;
+	if (!ler_contador(&p, fim, 100000000, &lance) || lance == 0) return FEN_ERRO_CONTADOR;
+	if (pular_espacos(p, fim) != fim) return FEN_ERRO_CAMPOS;
+	t->meio_lance = (uint16_t)meio;
+	t->lance = lance;
+	return FEN_OK;
+}
+
+size_t fen_escrever(const Tabuleiro* t, char* dst) {
+	size_t n = 0;
+	for (int linha = 7; linha >= 0; linha--) {
+		int vazias = 0;
+		for (int coluna = 0; coluna < 8; coluna++) {
+			uint8_t cod = t->casa[linha * 8 + coluna];
+			if (cod == CASA_VAZIA) {
+				vazias++;
+				continue;
+			}
+			if (vazias) dst[n++] = (char)('0' + vazias);
+			vazias = 0;
+			dst[n++] = LETRA[cod];
+		}
+		if (vazias) dst[n++] = (char)('0' + vazias);
+		if (linha) dst[n++] = '/';
+	}
+	dst[n++] = ' ';
+	dst[n++] = t->lado == COR_BRANCA ? 'w' : 'b';
+	dst[n++] = ' ';
+	if (!t->roques) dst[n++] = '-';
+	if (t->roques & ROQUE_K) dst[n++] = 'K';
+	if (t->roques & ROQUE_Q) dst[n++] = 'Q';
+	if (t->roques & ROQUE_k) dst[n++] = 'k';
+	if (t->roques & ROQUE_q) dst[n++] = 'q';
+	dst[n++] = ' ';
+	if (t->en_passant == SEM_EN_PASSANT) {
+		dst[n++] = '-';
+	} else {
+		dst[n++] = (char)('a' + t->en_passant % 8);
+		dst[n++] = (char)('1' + t->en_passant / 8);
+	}
+	dst[n++] = ' ';
+	n += formatar_u64(dst + n, t->meio_lance);
+	dst[n++] = ' ';
+	n += formatar_u64(dst + n, t->lance);
+	dst[n] = '\0';
+	return n;
+}
@@ -0,0 +1,41 @@
+#ifndef XADREZ_FEN_H
+#define XADREZ_FEN_H
+
+#include <stddef.h>
+
+#include "xadrez_posicao.h"
+
+// Leitura e escrita de FEN (Forsyth-Edwards Notation).
+// O parser é dirigido por tabela: cada byte passa por um classificador de
+// 256 entradas (peça, dígito, '/', espaço...) e o valor associado (código
+// da peça ou número de casas vazias) sai de uma segunda tabela. Nenhuma
+// alocação: a linha [ini, fim) é lida direto para o Tabuleiro.
+
+#define FEN_MAX 100 // maior FEN válida + terminador, com folga
+
+typedef enum {
+	FEN_OK,
+	FEN_ERRO_CARACTERE,   // caractere inesperado na disposição
+	FEN_ERRO_FILEIRA,     // fileira sem exatamente 8 casas
+	FEN_ERRO_FILEIRAS,    // disposição sem exatamente 8 fileiras
+	FEN_ERRO_REIS,        // não há exatamente um rei de cada cor
+	FEN_ERRO_LADO,        // lado a jogar diferente de 'w'/'b'
+	FEN_ERRO_ROQUE,       // direitos de roque inválidos
+	FEN_ERRO_EN_PASSANT,  // casa de en passant inválida
+	FEN_ERRO_CONTADOR,    // contadores de lance inválidos
+	FEN_ERRO_CAMPOS,      // campos faltando ou sobrando
+	FEN_ERRO_QTD
+} FenErro;
+
+// Lê a FEN em [ini, fim). Os contadores de lance são opcionais (padrão
+// "0 1"); '\r' final é ignorado.
+FenErro fen_ler(Tabuleiro* t, const char* ini, const char* fim);
+
+// Escreve a FEN de t em dst (FEN_MAX bytes); retorna o tamanho sem o '\0'.
+size_t fen_escrever(const Tabuleiro* t, char* dst);
+
+const char* fen_erro_msg(FenErro e);
+
+#define FEN_INICIAL "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+
+#endif
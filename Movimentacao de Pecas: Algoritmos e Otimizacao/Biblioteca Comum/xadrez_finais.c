@@ -0,0 +1,386 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "xadrez_finais.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "xadrez_bitboard.h"
+#include "xadrez_hash.h"
+#include "xadrez_lances.h"
+#include "xadrez_util.h"
+
+#define MAX_THREADS_FINAIS 64
+#define CONFIGS 4096 // (rei branco, peça): índice rei_branco * 64 + peça
+
+const char* const CHAVE_FINAL[FINAL_QTD] = { "kqk", "krk" };
+
+static const Peca PECA_FINAL[FINAL_QTD] = { PECA_RAINHA, PECA_TORRE };
+static const TipoPeca TIPO_FINAL[FINAL_QTD] = { TP_RAINHA, TP_TORRE };
+
+int final_de_chave(const char* chave) {
+	for (int i = 0; i < FINAL_QTD; i++) {
+		if (!strcmp(chave, CHAVE_FINAL[i])) return i;
+	}
+	return -1;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ GERAÇÃO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+// Estado da geração, sobre o espaço completo (sem simetria). Cada bitboard
+// é indexado pela casa do rei preto.
+typedef struct {
+	TipoFinal tipo;
+	Bitboard valida_b[CONFIGS];  // pretas a jogar: posição possível
+	Bitboard valida_w[CONFIGS];  // brancas a jogar: idem, e pretas fora de xeque
+	Bitboard xeque[CONFIGS];     // rei preto atacado pela peça
+	Bitboard livres[CONFIGS];    // destinos do rei preto (inclui capturar a peça solta)
+	Bitboard lances_peca[CONFIGS]; // destinos da peça com só o rei branco bloqueando
+	Bitboard ganha[CONFIGS];     // brancas a jogar: vitória conhecida
+	Bitboard perde[CONFIGS];     // pretas a jogar: derrota conhecida
+	Bitboard perde_novo[CONFIGS]; // derrotas achadas no último passe
+	uint8_t* dtm[2];             // [config * 64 + rei preto]: plies + 1
+	int passe;                   // plies da metade em andamento
+	int novos[MAX_THREADS_FINAIS];
+} Geracao;
+
+// Casas estritamente entre a e b (mesma linha, coluna ou diagonal), ou 0.
+static Bitboard ENTRE[64][64];
+static pthread_once_t entre_pronto = PTHREAD_ONCE_INIT;
+
+static void iniciar_entre(void) {
+	for (int a = 0; a < 64; a++) {
+		for (int d = 0; d < DIR_QTD; d++) {
+			Bitboard caminho = 0, atual = BB_CASA(a);
+			for (;;) {
+				atual = bb_deslocar(atual, (Direcao)d);
+				if (!atual) break;
+				ENTRE[a][__builtin_ctzll(atual)] = caminho;
+				caminho |= atual;
+			}
+		}
+	}
+}
+
+static void gravar_dtm(uint8_t* dtm, int config, Bitboard novos, int plies) {
+	while (novos) {
+		int bk = __builtin_ctzll(novos);
+		novos &= novos - 1;
+		dtm[config * 64 + bk] = (uint8_t)(plies + 1);
+	}
+}
+
+// Casas vizinhas de alguma casa de b. Diferente de ataques_rei(), não tira
+// as casas de b: uma casa de b vizinha de outra também entra.
+static inline Bitboard vizinhas(Bitboard b) {
+	Bitboard linha = b | ((b << 1) & ~BB_COLUNA_A) | ((b >> 1) & ~BB_COLUNA_H);
+	return (linha << 8) | (linha >> 8) | ((b << 1) & ~BB_COLUNA_A) | ((b >> 1) & ~BB_COLUNA_H);
+}
+
+// Derrotas das pretas com a vitória 'ganha' conhecida: o rei tem lance (ou
+// está em xeque, para contar o mate) e nenhum destino livre escapa dela.
+static inline Bitboard derrotas(const Geracao* g, int c) {
+	Bitboard escapes = g->livres[c] & ~g->ganha[c];
+	return g->valida_b[c] & ~vizinhas(escapes) & (vizinhas(g->livres[c]) | g->xeque[c]);
+}
+
+typedef struct {
+	Geracao* g;
+	int ini, fim;
+	int id;
+	int metade; // 0 = brancas (vitórias), 1 = pretas (derrotas)
+} Faixa;
+
+// Metade das brancas: vitória em 'passe' plies onde algum lance leva a uma
+// derrota das pretas achada no passe anterior. Lances do rei só dependem
+// da configuração de destino (a validade dela já exclui reis vizinhos);
+// lances da peça exigem o rei preto fora do caminho.
+static void* passe_brancas(Faixa* f) {
+	Geracao* g = f->g;
+	int novos = 0;
+	for (int c = f->ini; c < f->fim; c++) {
+		if (!g->valida_w[c]) continue;
+		int rb = c >> 6, pc = c & 63;
+		Bitboard alcance = 0;
+		for (Bitboard k = ataques_rei(BB_CASA(rb)) & ~BB_CASA(pc); k; k &= k - 1) {
+			alcance |= g->perde_novo[__builtin_ctzll(k) * 64 + pc];
+		}
+		for (Bitboard m = g->lances_peca[c]; m; m &= m - 1) {
+			int destino = __builtin_ctzll(m);
+			alcance |= g->perde_novo[rb * 64 + destino] & ~ENTRE[pc][destino];
+		}
+		Bitboard novas = alcance & g->valida_w[c] & ~g->ganha[c];
+		if (novas) {
+			g->ganha[c] |= novas;
+			gravar_dtm(g->dtm[COR_BRANCA], c, novas, g->passe);
+			novos += __builtin_popcountll(novas);
+		}
+	}
+	g->novos[f->id] = novos;
+	return NULL;
+}
+
+// Metade das pretas: derrota em 'passe' plies, todo lance cai numa vitória
+// das brancas (só a própria configuração: o rei preto não muda as peças
+// brancas, e capturar a peça escapa para o empate).
+static void* passe_pretas(Faixa* f) {
+	Geracao* g = f->g;
+	int novos = 0;
+	for (int c = f->ini; c < f->fim; c++) {
+		Bitboard novas = derrotas(g, c) & ~g->perde[c];
+		g->perde_novo[c] = novas;
+		if (novas) {
+			g->perde[c] |= novas;
+			gravar_dtm(g->dtm[COR_PRETA], c, novas, g->passe);
+			novos += __builtin_popcountll(novas);
+		}
+	}
+	g->novos[f->id] = novos;
+	return NULL;
+}
+
+static void* executar_faixa(void* arg) {
+	Faixa* f = arg;
+	return f->metade ? passe_pretas(f) : passe_brancas(f);
+}
+
+// Uma metade de passe sobre todas as configurações; retorna as posições novas.
+static int rodar_metade(Geracao* g, int metade, int threads) {
+	Faixa faixas[MAX_THREADS_FINAIS];
+	pthread_t ids[MAX_THREADS_FINAIS];
+	for (int i = 0; i < threads; i++) {
+		faixas[i] = (Faixa){ g, CONFIGS * i / threads, CONFIGS * (i + 1) / threads, i, metade };
+	}
+	int criada[MAX_THREADS_FINAIS] = { 0 };
+	for (int i = 1; i < threads; i++) criada[i] = pthread_create(&ids[i], NULL, executar_faixa, &faixas[i]) == 0;
+	// Faixas sem thread (pthread_create falhou) rodam aqui, depois da 0.
+	executar_faixa(&faixas[0]);
+	for (int i = 1; i < threads; i++) {
+		if (!criada[i]) executar_faixa(&faixas[i]);
+	}
+	for (int i = 1; i < threads; i++) {
+		if (criada[i]) pthread_join(ids[i], NULL);
+	}
+	int novos = 0;
+	for (int i = 0; i < threads; i++) novos += g->novos[i];
+	return novos;
+}
+
+static void preparar(Geracao* g) {
+	Peca peca = PECA_FINAL[g->tipo];
+	for (int c = 0; c < CONFIGS; c++) {
+		int rb = c >> 6, pc = c & 63;
+		g->ganha[c] = g->perde[c] = g->perde_novo[c] = 0;
+		if (rb == pc) {
+			g->valida_b[c] = g->valida_w[c] = g->xeque[c] = g->livres[c] = g->lances_peca[c] = 0;
+			continue;
+		}
+		Bitboard b_rei = BB_CASA(rb), b_peca = BB_CASA(pc);
+		Bitboard em_volta = ataques_rei(b_rei);
+		// O rei preto não bloqueia o próprio xeque: o raio passa pela casa
+		// dele (raio-x), e as casas atrás dela também ficam atacadas.
+		Bitboard ataque = bb_ataques_deslizantes(peca, b_peca, ~(b_rei | b_peca));
+		Bitboard base = ~(b_rei | b_peca | em_volta);
+		g->valida_b[c] = base;
+		g->valida_w[c] = base & ~ataque;
+		g->xeque[c] = base & ataque;
+		g->livres[c] = ~(em_volta | ataque | b_rei);
+		g->lances_peca[c] = ataque & ~b_rei;
+	}
+}
+
+int final_gerar(TabelaFinal* t, TipoFinal tipo, int threads, FinalStats* stats) {
+	if (!t || tipo < 0 || tipo >= FINAL_QTD) return 0;
+	if (threads < 1) threads = 1;
+	if (threads > MAX_THREADS_FINAIS) threads = MAX_THREADS_FINAIS;
+	pthread_once(&entre_pronto, iniciar_entre);
+
+	Geracao* g = malloc(sizeof *g);
+	uint8_t* dtm = malloc((size_t)2 * CONFIGS * 64);
+	uint8_t* dados = malloc(FINAL_ENTRADAS);
+	if (!g || !dtm || !dados) {
+		free(g);
+		free(dtm);
+		free(dados);
+		return 0;
+	}
+	double t0 = agora_seg();
+	g->tipo = tipo;
+	g->dtm[COR_BRANCA] = dtm;
+	g->dtm[COR_PRETA] = dtm + (size_t)CONFIGS * 64;
+	memset(dtm, FINAL_EMPATE, (size_t)2 * CONFIGS * 64);
+	preparar(g);
+
+	// Passe 0: os mates (sem vitória conhecida, só sobra quem não tem lance).
+	g->passe = 0;
+	int passes = 0;
+	int novos = rodar_metade(g, 1, threads);
+	int maior = 0;
+	while (novos) {
+		passes++;
+		g->passe = 2 * passes - 1;
+		if (!rodar_metade(g, 0, threads)) break;
+		maior = g->passe;
+		g->passe = 2 * passes;
+		novos = rodar_metade(g, 1, threads);
+		if (novos) maior = g->passe;
+	}
+
+	// Posições impossíveis e contagens no espaço completo.
+	uint64_t vitorias = 0, derrotas_pretas = 0, empates = 0;
+	for (int c = 0; c < CONFIGS; c++) {
+		for (int lado = 0; lado < 2; lado++) {
+			Bitboard valida = lado == COR_BRANCA ? g->valida_w[c] : g->valida_b[c];
+			Bitboard resolvida = lado == COR_BRANCA ? g->ganha[c] : g->perde[c];
+			for (int bk = 0; bk < 64; bk++) {
+				if (!(valida >> bk & 1)) g->dtm[lado][c * 64 + bk] = FINAL_INVALIDA;
+			}
+			if (lado == COR_BRANCA) vitorias += (uint64_t)__builtin_popcountll(resolvida);
+			else derrotas_pretas += (uint64_t)__builtin_popcountll(resolvida);
+			empates += (uint64_t)__builtin_popcountll(valida & ~resolvida);
+		}
+	}
+
+	// Só o rei branco no triângulo vai para a tabela.
+	for (int lado = 0; lado < 2; lado++) {
+		for (int rb = 0; rb < 64; rb++) {
+			int col = rb & 7, lin = rb >> 3;
+			if (col > 3 || lin > col) continue;
+			memcpy(dados + ((size_t)lado * FINAL_TRIANGULO + (size_t)final_indice_triangulo(rb)) * 4096,
+			       g->dtm[lado] + (size_t)rb * 4096, 4096);
+		}
+	}
+	free(dtm);
+	free(g);
+
+	t->tipo = tipo;
+	t->dados = dados;
+	t->maior_plies = maior;
+	t->mapa = NULL;
+	t->tam_mapa = 0;
+	t->proprio = dados;
+	if (stats) {
+		stats->passes = passes;
+		stats->vitorias = vitorias;
+		stats->derrotas = derrotas_pretas;
+		stats->empates = empates;
+		stats->segundos = agora_seg() - t0;
+	}
+	return 1;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ ARQUIVO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static void gravar_u32(uint8_t* p, uint32_t v) {
+	for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void gravar_u64(uint8_t* p, uint64_t v) {
+	for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t ler_u32(const uint8_t* p) {
+	uint32_t v = 0;
+	for (int i = 3; i >= 0; i--) v = v << 8 | p[i];
+	return v;
+}
+
+static uint64_t ler_u64(const uint8_t* p) {
+	uint64_t v = 0;
+	for (int i = 7; i >= 0; i--) v = v << 8 | p[i];
+	return v;
+}
+
+int final_salvar(const TabelaFinal* t, const char* caminho) {
+	uint8_t cab[FINAL_CABECALHO] = { 0 };
+	memcpy(cab, FINAL_MAGICO, 4);
+	cab[4] = (uint8_t)t->tipo;
+	cab[5] = (uint8_t)t->maior_plies;
+	gravar_u32(cab + 8, FINAL_ENTRADAS);
+	gravar_u64(cab + 12, hash64(t->dados, FINAL_ENTRADAS, HASH64_SEMENTE));
+	// Grava em <caminho>.tmp e só renomeia no sucesso: uma regeneração que
+	// falha não destrói a tabela anterior.
+	char tmp[4096];
+	if (snprintf(tmp, sizeof tmp, "%s.tmp", caminho) >= (int)sizeof tmp) {
+		errno = ENAMETOOLONG;
+		return 0;
+	}
+	FILE* f = fopen(tmp, "wb");
+	if (!f) return 0;
+	int ok = fwrite(cab, 1, sizeof cab, f) == sizeof cab && fwrite(t->dados, 1, FINAL_ENTRADAS, f) == FINAL_ENTRADAS;
+	ok = fclose(f) == 0 && ok;
+	if (ok && rename(tmp, caminho) == 0) return 1;
+	int erro = errno;
+	unlink(tmp);
+	errno = erro;
+	return 0;
+}
+
+int final_abrir(TabelaFinal* t, const char* caminho) {
+	int fd = open(caminho, O_RDONLY);
+	if (fd < 0) return 0;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size != final_tamanho_arquivo()) {
+		close(fd);
+		errno = EINVAL;
+		return 0;
+	}
+	void* mapa = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapa == MAP_FAILED) return 0;
+	const uint8_t* cab = mapa;
+	const uint8_t* dados = cab + FINAL_CABECALHO;
+	if (memcmp(cab, FINAL_MAGICO, 4) != 0 || cab[4] >= FINAL_QTD || ler_u32(cab + 8) != FINAL_ENTRADAS ||
+	    ler_u64(cab + 12) != hash64(dados, FINAL_ENTRADAS, HASH64_SEMENTE)) {
+		munmap(mapa, (size_t)st.st_size);
+		errno = EINVAL;
+		return 0;
+	}
+	t->tipo = (TipoFinal)cab[4];
+	t->dados = dados;
+	t->maior_plies = cab[5];
+	t->mapa = mapa;
+	t->tam_mapa = (size_t)st.st_size;
+	t->proprio = NULL;
+	return 1;
+}
+
+void final_fechar(TabelaFinal* t) {
+	if (t->mapa) munmap(t->mapa, t->tam_mapa);
+	free(t->proprio);
+	t->mapa = NULL;
+	t->proprio = NULL;
+	t->dados = NULL;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ CONSULTA
+────────────────────────────────────────────────────────────────────────────
+*/
+
+int final_consultar_tabuleiro(const TabelaFinal* t, const Tabuleiro* tab) {
+	Bitboard brancas = tab->cor[COR_BRANCA], pretas = tab->cor[COR_PRETA];
+	Bitboard peca = tab->pecas[COR_BRANCA][TIPO_FINAL[t->tipo]];
+	if (__builtin_popcountll(brancas) != 2 || __builtin_popcountll(pretas) != 1 ||
+	    __builtin_popcountll(peca) != 1 || !tab->pecas[COR_BRANCA][TP_REI] || !tab->pecas[COR_PRETA][TP_REI]) {
+		return FINAL_OUTRO_MATERIAL;
+	}
+	return final_consultar(t, __builtin_ctzll(tab->pecas[COR_BRANCA][TP_REI]), __builtin_ctzll(peca),
+	                       __builtin_ctzll(tab->pecas[COR_PRETA][TP_REI]), (Cor)tab->lado);
+}
@@ -0,0 +1,138 @@
+#ifndef XADREZ_FINAIS_H
+#define XADREZ_FINAIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xadrez_posicao.h"
+
+// Tabelas de finais Rei+Rainha x Rei (KQK) e Rei+Torre x Rei (KRK) por
+// análise retrógrada: partindo dos mates, cada passe acha as posições com
+// as brancas a jogar que alcançam uma derrota recém-descoberta das pretas
+// e, depois, as posições com as pretas a jogar em que todo lance cai numa
+// vitória já conhecida. Para cada par (rei branco, peça) o passe trata as
+// 64 casas do rei preto de uma vez, como bitboards; os 4096 pares são
+// divididos entre as threads, com um join entre as duas metades do passe.
+//
+// A tabela guarda a distância até o mate em plies (+1; 0 = empate) para
+// os dois lados a jogar, reduzida pela simetria do tabuleiro: o rei branco
+// é levado ao triângulo a1-d1-d4 (10 casas), então cada tabela tem
+// 2 x 10 x 64 x 64 = 81920 entradas de 1 byte. A consulta é O(1): três
+// casas transformadas e uma leitura.
+//
+// Arquivo (.xtf), mapeável direto com mmap:
+//   "XTF1" | tipo (u8) | maior distância em plies (u8) | 0 (u16)
+//   bytes de dados (u32 LE) | xxh64 dos dados (u64 LE) | 0 (12 bytes)
+//   dados: [lado][rei branco no triângulo][peça][rei preto]
+
+#define FINAL_MAGICO "XTF1"
+#define FINAL_CABECALHO 32
+#define FINAL_TRIANGULO 10
+#define FINAL_ENTRADAS (2 * FINAL_TRIANGULO * 64 * 64)
+
+#define FINAL_EMPATE 0        // valor guardado: empate (afogamento, captura...)
+#define FINAL_INVALIDA 0xFF   // valor guardado: posição impossível
+
+// Retornos de final_consultar (>= 0 = plies até o mate)
+#define FINAL_SEM_MATE (-1)
+#define FINAL_POSICAO_INVALIDA (-2)
+#define FINAL_OUTRO_MATERIAL (-3)
+
+typedef enum {
+	FINAL_KQK,
+	FINAL_KRK,
+	FINAL_QTD
+} TipoFinal;
+
+extern const char* const CHAVE_FINAL[FINAL_QTD]; // "kqk", "krk"
+
+typedef struct {
+	TipoFinal tipo;
+	const uint8_t* dados; // FINAL_ENTRADAS bytes
+	int maior_plies;      // maior distância até o mate
+	void* mapa;           // arquivo mapeado (final_abrir) ou NULL
+	size_t tam_mapa;
+	uint8_t* proprio;     // memória da geração (final_gerar) ou NULL
+} TabelaFinal;
+
+typedef struct {
+	int passes;               // passes retrógrados até estabilizar
+	uint64_t vitorias;        // brancas a jogar, ganham (posições completas)
+	uint64_t derrotas;        // pretas a jogar, perdem (inclui os mates)
+	uint64_t empates;         // posições válidas sem mate forçado
+	double segundos;
+} FinalStats;
+
+// "kqk" -> FINAL_KQK; -1 se desconhecido.
+int final_de_chave(const char* chave);
+
+// Gera a tabela com 'threads' threads (>= 1). Retorna 0 sem memória.
+int final_gerar(TabelaFinal* t, TipoFinal tipo, int threads, FinalStats* stats);
+
+// Grava / mapeia o arquivo .xtf. final_salvar escreve em <caminho>.tmp e
+// renomeia no fim, então uma falha mantém o arquivo anterior; final_abrir
+// confere magia, tipo, tamanho e o resumo dos dados. Retornam 0 (com errno
+// ou EINVAL) se falharem.
+int final_salvar(const TabelaFinal* t, const char* caminho);
+int final_abrir(TabelaFinal* t, const char* caminho);
+void final_fechar(TabelaFinal* t);
+
+// Tamanho do arquivo gravado.
+static inline size_t final_tamanho_arquivo(void) {
+	return FINAL_CABECALHO + FINAL_ENTRADAS;
+}
+
+// Leva o rei branco ao triângulo a1-d1-d4: bit 0 espelha as colunas, bit 1
+// as fileiras e bit 2 troca linha e coluna (aplicado por último).
+static inline int final_simetria(int rei_branco) {
+	int col = rei_branco & 7, lin = rei_branco >> 3, s = 0;
+	if (col > 3) {
+		s |= 1;
+		col = 7 - col;
+	}
+	if (lin > 3) {
+		s |= 2;
+		lin = 7 - lin;
+	}
+	if (lin > col) s |= 4;
+	return s;
+}
+
+static inline int final_transformar(int casa, int s) {
+	int col = casa & 7, lin = casa >> 3;
+	if (s & 1) col = 7 - col;
+	if (s & 2) lin = 7 - lin;
+	if (s & 4) {
+		int x = col;
+		col = lin;
+		lin = x;
+	}
+	return lin * 8 + col;
+}
+
+// Índice do rei branco já no triângulo (lin <= col <= 3): 0..9.
+static inline int final_indice_triangulo(int casa) {
+	int col = casa & 7, lin = casa >> 3;
+	return lin * 4 - lin * (lin + 1) / 2 + col;
+}
+
+// Valor guardado para a posição (FINAL_EMPATE, FINAL_INVALIDA ou plies+1).
+static inline uint8_t final_valor(const TabelaFinal* t, int rei_branco, int peca, int rei_preto, Cor lado) {
+	int s = final_simetria(rei_branco);
+	size_t i = ((size_t)lado * FINAL_TRIANGULO + (size_t)final_indice_triangulo(final_transformar(rei_branco, s))) * 4096 +
+	           (size_t)final_transformar(peca, s) * 64 + (size_t)final_transformar(rei_preto, s);
+	return t->dados[i];
+}
+
+// Plies até o mate com jogo perfeito (0 = pretas já estão em mate),
+// FINAL_SEM_MATE ou FINAL_POSICAO_INVALIDA.
+static inline int final_consultar(const TabelaFinal* t, int rei_branco, int peca, int rei_preto, Cor lado) {
+	uint8_t v = final_valor(t, rei_branco, peca, rei_preto, lado);
+	return v == FINAL_INVALIDA ? FINAL_POSICAO_INVALIDA : v == FINAL_EMPATE ? FINAL_SEM_MATE : v - 1;
+}
+
+// Mesmo, a partir de um Tabuleiro: FINAL_OUTRO_MATERIAL se a posição não
+// tem exatamente rei e peça da tabela contra rei sozinho.
+int final_consultar_tabuleiro(const TabelaFinal* t, const Tabuleiro* tab);
+
+#endif
@@ -0,0 +1,175 @@
+#include "xadrez_formatos.h"
+
+#include <string.h>
+
+const char* const NOME_PECA[PECA_QTD] = { "TORRE", "BISPO", "RAINHA", "CAVALO" };
+const char* const CHAVE_PECA[PECA_QTD] = { "torre", "bispo", "rainha", "cavalo" };
+
+const char* const NOME_DIRECAO[DIR_QTD] = {
+	"Direita", "Esquerda", "Cima", "Baixo",
+	"Cima Direita", "Cima Esquerda", "Baixo Direita", "Baixo Esquerda"
+};
+const char* const CHAVE_DIRECAO[DIR_QTD] = {
+	"direita", "esquerda", "cima", "baixo",
+	"cima_direita", "cima_esquerda", "baixo_direita", "baixo_esquerda"
+};
+
+const int8_t DIRECAO_DX[DIR_QTD] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+const int8_t DIRECAO_DY[DIR_QTD] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+
+static const char* const NOMES_FORMATO[] = { "text", "csv", "jsonl", "bin" };
+
+int formato_de_nome(const char* nome, Formato* out) {
+	if (!nome || !out) return 0;
+	for (int i = 0; i < (int)(sizeof NOMES_FORMATO / sizeof *NOMES_FORMATO); i++) {
+		if (!strcmp(nome, NOMES_FORMATO[i])) {
+			*out = (Formato)i;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+const char* nome_formato(Formato f) {
+	return NOMES_FORMATO[f];
+}
+
+void emitir_inicio(Saida* s, Formato f) {
+	if (f == FORMATO_CSV) {
+		saida_linha(s, "peca,passo,direcao,de_x,de_y,para_x,para_y");
+	} else if (f == FORMATO_BIN) {
+		char cab[BIN_TAM_CABECALHO] = BIN_MAGICO;
+		cab[4] = BIN_VERSAO;
+		cab[6] = BIN_TAM_REGISTRO;
+		saida_escrever(s, cab, sizeof cab);
+	}
+}
+
+void emitir_secao(Saida* s, Formato f, const char* rotulo) {
+	if (f == FORMATO_TEXTO) saida_linha(s, rotulo);
+}
+
+static inline char* escrever_bytes(char* p, const char* txt, size_t n) {
+	memcpy(p, txt, n);
+	return p + n;
+}
+
+// Monta prefixos constantes uma vez por chamada (fora do laço quente).
+static void anexar(char* buf, size_t* len, const char* txt) {
+	size_t n = strlen(txt);
+	memcpy(buf + *len, txt, n);
+	*len += n;
+}
+
+static inline char* escrever_le32(char* p, uint32_t v) {
+	p[0] = (char)v;
+	p[1] = (char)(v >> 8);
+	p[2] = (char)(v >> 16);
+	p[3] = (char)(v >> 24);
+	return p + 4;
+}
+
+// Pior caso de uma linha CSV/JSONL: prefixos fixos + 1 u64 + 4 i32.
+#define LINHA_MAX 192
+
+// Cada emissor é um consumidor do iterador: pede passos até ele acabar.
+// O formato é decidido uma vez por chamada e os prefixos constantes da
+// peça/direção são montados fora do laço.
+void emitir_iterador(Saida* s, Formato f, IterPassos* iter) {
+	// Cópia local: o estado do iterador fica em registradores no laço.
+	IterPassos local = *iter;
+	IterPassos* it = &local;
+	const Peca p = it->peca;
+	const Direcao d = it->direcao;
+	Passo ps;
+
+	switch (f) {
+	case FORMATO_TEXTO: {
+		char linha[32];
+		size_t len = strlen(NOME_DIRECAO[d]);
+		memcpy(linha, NOME_DIRECAO[d], len);
+		linha[len++] = '\n';
+		while (passos_proximo(it, &ps)) saida_escrever(s, linha, len);
+		break;
+	}
+	case FORMATO_CSV: {
+		char pre[16], meio[24];
+		size_t lp = 0, lm = 0;
+		anexar(pre, &lp, CHAVE_PECA[p]);
+		anexar(pre, &lp, ",");
+		anexar(meio, &lm, ",");
+		anexar(meio, &lm, CHAVE_DIRECAO[d]);
+		anexar(meio, &lm, ",");
+		while (passos_proximo(it, &ps)) {
+			char* o = saida_reservar(s, LINHA_MAX);
+			char* c = o;
+			c = escrever_bytes(c, pre, lp);
+			c += formatar_u64(c, ps.indice);
+			c = escrever_bytes(c, meio, lm);
+			c += formatar_i64(c, ps.de.x);
+			*c++ = ',';
+			c += formatar_i64(c, ps.de.y);
+			*c++ = ',';
+			c += formatar_i64(c, ps.para.x);
+			*c++ = ',';
+			c += formatar_i64(c, ps.para.y);
+			*c++ = '\n';
+			saida_avancar(s, (size_t)(c - o));
+		}
+		break;
+	}
+	case FORMATO_JSONL: {
+		char pre[40], meio[48];
+		size_t lp = 0, lm = 0;
+		anexar(pre, &lp, "{\"peca\":\"");
+		anexar(pre, &lp, CHAVE_PECA[p]);
+		anexar(pre, &lp, "\",\"passo\":");
+		anexar(meio, &lm, ",\"direcao\":\"");
+		anexar(meio, &lm, CHAVE_DIRECAO[d]);
+		anexar(meio, &lm, "\",\"de\":[");
+		while (passos_proximo(it, &ps)) {
+			char* o = saida_reservar(s, LINHA_MAX);
+			char* c = o;
+			c = escrever_bytes(c, pre, lp);
+			c += formatar_u64(c, ps.indice);
+			c = escrever_bytes(c, meio, lm);
+			c += formatar_i64(c, ps.de.x);
+			*c++ = ',';
+			c += formatar_i64(c, ps.de.y);
+			c = escrever_bytes(c, "],\"para\":[", 10);
+			c += formatar_i64(c, ps.para.x);
+			*c++ = ',';
+			c += formatar_i64(c, ps.para.y);
+			c = escrever_bytes(c, "]}\n", 3);
+			saida_avancar(s, (size_t)(c - o));
+		}
+		break;
+	}
+	case FORMATO_BIN:
+		while (passos_proximo(it, &ps)) {
+			char* o = saida_reservar(s, BIN_TAM_REGISTRO);
+			char* c = o;
+			c = escrever_le32(c, (uint32_t)ps.indice);
+			c = escrever_le32(c, (uint32_t)(ps.indice >> 32));
+			*c++ = (char)p;
+			*c++ = (char)d;
+			*c++ = 0;
+			*c++ = 0;
+			c = escrever_le32(c, (uint32_t)ps.de.x);
+			c = escrever_le32(c, (uint32_t)ps.de.y);
+			c = escrever_le32(c, (uint32_t)ps.para.x);
+			c = escrever_le32(c, (uint32_t)ps.para.y);
+			saida_avancar(s, BIN_TAM_REGISTRO);
+		}
+		break;
+	}
+	*iter = local;
+}
+
+void emitir_passos(Saida* s, Formato f, Peca p, Direcao d, int n,
+                   Posicao* pos, uint64_t* indice) {
+	IterPassos it = passos_iniciar(p, d, n, *pos, *indice);
+	emitir_iterador(s, f, &it);
+	*pos = it.pos;
+	*indice = it.indice;
+}
@@ -0,0 +1,117 @@
+#ifndef XADREZ_FORMATOS_H
+#define XADREZ_FORMATOS_H
+
+#include <stdint.h>
+
+#include "xadrez_saida.h"
+
+// Emissores de passos em formatos estruturados (texto, CSV, JSON Lines e
+// binário). Cada passo carrega peça, índice, direção e coordenadas de/para.
+
+typedef enum {
+	PECA_TORRE,
+	PECA_BISPO,
+	PECA_RAINHA,
+	PECA_CAVALO,
+	PECA_QTD
+} Peca;
+
+typedef enum {
+	DIR_DIREITA,
+	DIR_ESQUERDA,
+	DIR_CIMA,
+	DIR_BAIXO,
+	DIR_CIMA_DIREITA,
+	DIR_CIMA_ESQUERDA,
+	DIR_BAIXO_DIREITA,
+	DIR_BAIXO_ESQUERDA,
+	DIR_QTD
+} Direcao;
+
+typedef enum {
+	FORMATO_TEXTO,
+	FORMATO_CSV,
+	FORMATO_JSONL,
+	FORMATO_BIN
+} Formato;
+
+// Coordenadas: x = coluna (a..h = 0..7), y = linha (1..8 = 0..7).
+// Não são limitadas ao tabuleiro: n grande sai das 8x8 casas.
+typedef struct {
+	int32_t x;
+	int32_t y;
+} Posicao;
+
+// Um passo de uma peça: índice (1-based, contínuo na peça), direção e
+// casas de/para.
+typedef struct {
+	uint64_t indice;
+	Peca peca;
+	Direcao direcao;
+	Posicao de;
+	Posicao para;
+} Passo;
+
+extern const char* const NOME_PECA[PECA_QTD];      // "TORRE", ...
+extern const char* const CHAVE_PECA[PECA_QTD];     // "torre", ...
+extern const char* const NOME_DIRECAO[DIR_QTD];    // "Direita", ...
+extern const char* const CHAVE_DIRECAO[DIR_QTD];   // "direita", ...
+extern const int8_t DIRECAO_DX[DIR_QTD];
+extern const int8_t DIRECAO_DY[DIR_QTD];
+
+// Gerador preguiçoso (pull) de passos: passos_proximo calcula só o passo
+// seguinte, sob demanda. Quem para cedo (primeiro passo válido, corte numa
+// busca) não paga pelos passos que não pediu; os emissores abaixo são
+// consumidores que esgotam o iterador.
+typedef struct {
+	Peca peca;
+	Direcao direcao;
+	int restantes;
+	Posicao pos;       // casa atual (origem do próximo passo)
+	uint64_t indice;   // índice do último passo entregue
+} IterPassos;
+
+static inline IterPassos passos_iniciar(Peca p, Direcao d, int n, Posicao pos, uint64_t indice) {
+	return (IterPassos){ p, d, n > 0 ? n : 0, pos, indice };
+}
+
+// Entrega o próximo passo em *out; 0 quando acabou.
+static inline int passos_proximo(IterPassos* it, Passo* out) {
+	if (it->restantes == 0) return 0;
+	it->restantes--;
+	out->indice = ++it->indice;
+	out->peca = it->peca;
+	out->direcao = it->direcao;
+	out->de = it->pos;
+	it->pos.x += DIRECAO_DX[it->direcao];
+	it->pos.y += DIRECAO_DY[it->direcao];
+	out->para = it->pos;
+	return 1;
+}
+
+// Formato binário: cabeçalho de 8 bytes seguido de registros de 28 bytes
+// little-endian: u64 passo, u8 peca, u8 direcao, u16 reservado,
+// i32 de_x, i32 de_y, i32 para_x, i32 para_y.
+#define BIN_MAGICO "XZP"
+#define BIN_VERSAO 1
+#define BIN_TAM_CABECALHO 8
+#define BIN_TAM_REGISTRO 28
+
+int formato_de_nome(const char* nome, Formato* out);
+const char* nome_formato(Formato f);
+
+// Cabeçalho do fluxo (linha de colunas no CSV, assinatura no binário).
+void emitir_inicio(Saida* s, Formato f);
+
+// Rótulo de seção ("TORRE:"); só aparece no formato texto.
+void emitir_secao(Saida* s, Formato f, const char* rotulo);
+
+// Emite os passos restantes do iterador, que fica esgotado.
+void emitir_iterador(Saida* s, Formato f, IterPassos* it);
+
+// Emite n passos na direção dada a partir de *pos, atualizando *pos e
+// *indice (1-based, contínuo entre chamadas da mesma peça).
+void emitir_passos(Saida* s, Formato f, Peca p, Direcao d, int n,
+                   Posicao* pos, uint64_t* indice);
+
+#endif
@@ -0,0 +1,266 @@
+#include "xadrez_geometria.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define OCUPACAO_CAP_INICIAL 64
+
+int geometria_iniciar(Geometria* g, int64_t largura, int64_t altura) {
+	if (!g || largura < 1 || largura > GEO_MAX_LADO || altura < 1 || altura > GEO_MAX_LADO) return 0;
+	g->largura = largura;
+	g->altura = altura;
+	return 1;
+}
+
+int ocupacao_iniciar(Ocupacao* o, const Geometria* g) {
+	int densa = g->largura <= GEO_DENSA_MAX_LADO && g->altura <= GEO_DENSA_MAX_LADO;
+	return ocupacao_iniciar_tipo(o, g, densa ? OCUPACAO_DENSA : OCUPACAO_ESPARSA);
+}
+
+int ocupacao_iniciar_tipo(Ocupacao* o, const Geometria* g, TipoOcupacao tipo) {
+	memset(o, 0, sizeof *o);
+	o->geo = g;
+	o->tipo = tipo;
+	if (tipo == OCUPACAO_DENSA) {
+		return g->largura * g->altura <= 64 * GEO_DENSA_PALAVRAS;
+	}
+	o->chaves = calloc(OCUPACAO_CAP_INICIAL, sizeof *o->chaves);
+	o->cap = OCUPACAO_CAP_INICIAL;
+	return o->chaves != NULL;
+}
+
+void ocupacao_liberar(Ocupacao* o) {
+	for (int f = 0; f < RETA_QTD; f++) {
+		IndiceRetas* ir = &o->retas[f];
+		for (size_t i = 0; i < ir->cap; i++) free(ir->retas[i].pos);
+		free(ir->retas);
+		ir->retas = NULL;
+		ir->cap = ir->qtd = 0;
+	}
+	free(o->chaves);
+	o->chaves = NULL;
+	o->cap = 0;
+	o->qtd = 0;
+}
+
+// Hash multiplicativo (Fibonacci): os bits altos do produto indexam a tabela.
+static inline size_t indice_hash(uint64_t chave, size_t cap) {
+	return (size_t)((chave * 0x9E3779B97F4A7C15ULL) >> 32) & (cap - 1);
+}
+
+static int crescer(Ocupacao* o) {
+	size_t nova_cap = o->cap * 2;
+	uint64_t* novas = calloc(nova_cap, sizeof *novas);
+	if (!novas) return 0;
+	for (size_t i = 0; i < o->cap; i++) {
+		uint64_t c = o->chaves[i];
+		if (!c) continue;
+		size_t j = indice_hash(c, nova_cap);
+		while (novas[j]) j = (j + 1) & (nova_cap - 1);
+		novas[j] = c;
+	}
+	free(o->chaves);
+	o->chaves = novas;
+	o->cap = nova_cap;
+	return 1;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ ÍNDICE DE RETAS (só na representação esparsa)
+
+ Cada família mapeia o id da reta (y, x, x - y, x + y) para o vetor
+ ordenado das coordenadas das peças ao longo dela (x, ou y na coluna).
+────────────────────────────────────────────────────────────────────────────
+*/
+static inline uint64_t id_reta(const Geometria* g, FamiliaReta f, int64_t x, int64_t y) {
+	switch (f) {
+	case RETA_LINHA: return (uint64_t)y;
+	case RETA_COLUNA: return (uint64_t)x;
+	case RETA_DIAGONAL: return (uint64_t)(x - y + g->altura);
+	default: return (uint64_t)(x + y);
+	}
+}
+
+static inline int32_t pos_na_reta(FamiliaReta f, int64_t x, int64_t y) {
+	return (int32_t)(f == RETA_COLUNA ? y : x);
+}
+
+static Reta* buscar_reta(const IndiceRetas* ir, uint64_t id) {
+	if (!ir->cap) return NULL;
+	uint64_t chave = id + 1;
+	for (size_t i = indice_hash(chave, ir->cap); ir->retas[i].chave; i = (i + 1) & (ir->cap - 1)) {
+		if (ir->retas[i].chave == chave) return &ir->retas[i];
+	}
+	return NULL;
+}
+
+// Retas vazias continuam na tabela (só o vetor esvazia): não há remoção
+// de chaves e, portanto, nenhuma lápide.
+static Reta* obter_reta(IndiceRetas* ir, uint64_t id) {
+	Reta* r = buscar_reta(ir, id);
+	if (r) return r;
+	if ((ir->qtd + 1) * 2 > ir->cap) {
+		size_t nova_cap = ir->cap ? ir->cap * 2 : OCUPACAO_CAP_INICIAL;
+		Reta* novas = calloc(nova_cap, sizeof *novas);
+		if (!novas) return NULL;
+		for (size_t i = 0; i < ir->cap; i++) {
+			if (!ir->retas[i].chave) continue;
+			size_t j = indice_hash(ir->retas[i].chave, nova_cap);
+			while (novas[j].chave) j = (j + 1) & (nova_cap - 1);
+			novas[j] = ir->retas[i];
+		}
+		free(ir->retas);
+		ir->retas = novas;
+		ir->cap = nova_cap;
+	}
+	uint64_t chave = id + 1;
+	size_t i = indice_hash(chave, ir->cap);
+	while (ir->retas[i].chave) i = (i + 1) & (ir->cap - 1);
+	ir->retas[i].chave = chave;
+	ir->qtd++;
+	return &ir->retas[i];
+}
+
+// Primeira posição >= v no vetor ordenado.
+static uint32_t limite_inferior(const Reta* r, int32_t v) {
+	uint32_t ini = 0, fim = r->n;
+	while (ini < fim) {
+		uint32_t meio = ini + (fim - ini) / 2;
+		if (r->pos[meio] < v) ini = meio + 1;
+		else fim = meio;
+	}
+	return ini;
+}
+
+static int indexar(Ocupacao* o, int64_t x, int64_t y) {
+	for (int f = 0; f < RETA_QTD; f++) {
+		Reta* r = obter_reta(&o->retas[f], id_reta(o->geo, (FamiliaReta)f, x, y));
+		if (!r) return 0;
+		if (r->n == r->cap) {
+			uint32_t nova_cap = r->cap ? r->cap * 2 : 4;
+			int32_t* novo = realloc(r->pos, nova_cap * sizeof *novo);
+			if (!novo) return 0;
+			r->pos = novo;
+			r->cap = nova_cap;
+		}
+		int32_t v = pos_na_reta((FamiliaReta)f, x, y);
+		uint32_t i = limite_inferior(r, v);
+		memmove(r->pos + i + 1, r->pos + i, (r->n - i) * sizeof *r->pos);
+		r->pos[i] = v;
+		r->n++;
+	}
+	return 1;
+}
+
+static void desindexar(Ocupacao* o, int64_t x, int64_t y) {
+	for (int f = 0; f < RETA_QTD; f++) {
+		Reta* r = buscar_reta(&o->retas[f], id_reta(o->geo, (FamiliaReta)f, x, y));
+		if (!r) continue;
+		uint32_t i = limite_inferior(r, pos_na_reta((FamiliaReta)f, x, y));
+		memmove(r->pos + i, r->pos + i + 1, (r->n - i - 1) * sizeof *r->pos);
+		r->n--;
+	}
+}
+
+int ocupacao_inserir(Ocupacao* o, int64_t x, int64_t y) {
+	if (!geometria_dentro(o->geo, x, y)) return 0;
+	uint64_t casa = geometria_casa(o->geo, x, y);
+	if (o->tipo == OCUPACAO_DENSA) {
+		uint64_t bit = 1ULL << (casa & 63);
+		if (o->densa[casa >> 6] & bit) return 0;
+		o->densa[casa >> 6] |= bit;
+		o->qtd++;
+		return 1;
+	}
+	if ((o->qtd + 1) * 2 > o->cap && !crescer(o)) return 0;
+	uint64_t chave = casa + 1;
+	size_t i = indice_hash(chave, o->cap);
+	while (o->chaves[i]) {
+		if (o->chaves[i] == chave) return 0;
+		i = (i + 1) & (o->cap - 1);
+	}
+	if (!indexar(o, x, y)) return 0;
+	o->chaves[i] = chave;
+	o->qtd++;
+	return 1;
+}
+
+int ocupacao_contem_esparsa(const Ocupacao* o, uint64_t casa) {
+	uint64_t chave = casa + 1;
+	for (size_t i = indice_hash(chave, o->cap); o->chaves[i]; i = (i + 1) & (o->cap - 1)) {
+		if (o->chaves[i] == chave) return 1;
+	}
+	return 0;
+}
+
+int ocupacao_remover(Ocupacao* o, int64_t x, int64_t y) {
+	if (!ocupacao_contem(o, x, y)) return 0;
+	uint64_t casa = geometria_casa(o->geo, x, y);
+	o->qtd--;
+	if (o->tipo == OCUPACAO_DENSA) {
+		o->densa[casa >> 6] &= ~(1ULL << (casa & 63));
+		return 1;
+	}
+	desindexar(o, x, y);
+	// Remoção com deslocamento para trás: mantém as sequências de sondagem
+	// sem lápides.
+	size_t mask = o->cap - 1;
+	size_t i = indice_hash(casa + 1, o->cap);
+	while (o->chaves[i] != casa + 1) i = (i + 1) & mask;
+	for (size_t j = (i + 1) & mask; o->chaves[j]; j = (j + 1) & mask) {
+		size_t ideal = indice_hash(o->chaves[j], o->cap);
+		// j pode ocupar o buraco i se sua posição ideal não está em (i, j]
+		if (((j - ideal) & mask) >= ((j - i) & mask)) {
+			o->chaves[i] = o->chaves[j];
+			i = j;
+		}
+	}
+	o->chaves[i] = 0;
+	return 1;
+}
+
+// Passo k >= 1 em que a casa 'chave' cai no raio (x + k*dx, y + k*dy); 0 se fora.
+static int64_t passo_no_raio(const Geometria* g, uint64_t chave, Posicao p, int64_t dx, int64_t dy) {
+	uint64_t casa = chave - 1;
+	int64_t cx = (int64_t)(casa % (uint64_t)g->largura) - p.x;
+	int64_t cy = (int64_t)(casa / (uint64_t)g->largura) - p.y;
+	int64_t k;
+	if (dx != 0) {
+		if (cx % dx) return 0;
+		k = cx / dx;
+	} else {
+		if (cx != 0 || cy % dy) return 0;
+		k = cy / dy;
+	}
+	return (k >= 1 && cy == k * dy) ? k : 0;
+}
+
+int64_t ocupacao_bloqueio_esparso(const Ocupacao* o, Posicao p, int64_t dx, int64_t dy, int64_t lim) {
+	if (dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1) {
+		FamiliaReta f = dy == 0 ? RETA_LINHA : dx == 0 ? RETA_COLUNA : dx == dy ? RETA_DIAGONAL : RETA_ANTI;
+		const Reta* r = buscar_reta(&o->retas[f], id_reta(o->geo, f, p.x, p.y));
+		if (!r || !r->n) return lim;
+		int32_t atual = pos_na_reta(f, p.x, p.y);
+		int sentido = f == RETA_COLUNA ? (int)dy : (int)dx;
+		uint32_t i = limite_inferior(r, atual + (sentido > 0 ? 1 : 0));
+		int64_t livre;
+		if (sentido > 0) livre = i < r->n ? (int64_t)r->pos[i] - atual - 1 : lim;
+		else livre = i > 0 ? atual - (int64_t)r->pos[i - 1] - 1 : lim;
+		return livre < lim ? livre : lim;
+	}
+	if (lim <= (int64_t)o->qtd) {
+		for (int64_t k = 1; k <= lim; k++) {
+			if (ocupacao_contem_esparsa(o, geometria_casa(o->geo, p.x + k * dx, p.y + k * dy))) return k - 1;
+		}
+		return lim;
+	}
+	// Raio longo: o bloqueio é a peça mais próxima no raio.
+	int64_t primeiro = lim + 1;
+	for (size_t i = 0; i < o->cap; i++) {
+		if (!o->chaves[i]) continue;
+		int64_t k = passo_no_raio(o->geo, o->chaves[i], p, dx, dy);
+		if (k && k < primeiro) primeiro = k;
+	}
+	return primeiro - 1;
+}
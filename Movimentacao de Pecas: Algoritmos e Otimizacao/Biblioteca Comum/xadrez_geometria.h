@@ -0,0 +1,150 @@
+#ifndef XADREZ_GEOMETRIA_H
+#define XADREZ_GEOMETRIA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xadrez_formatos.h"
+
+// Geometria de tabuleiros largura x altura genéricos (5x5 até 10^6 x 10^6
+// e além). Casa = y * largura + x, em 64 bits.
+// O recorte nas bordas é aritmético: o número máximo de passos em uma
+// direção sai de uma divisão por eixo, sem percorrer casa a casa.
+
+#define GEO_MAX_LADO 2000000000LL   // cabe em Posicao (int32)
+#define GEO_DENSA_MAX_LADO 16       // até 16x16 = 256 casas em bitset
+#define GEO_DENSA_PALAVRAS 4
+
+typedef struct {
+	int64_t largura;
+	int64_t altura;
+} Geometria;
+
+// Retorna 0 para dimensões fora de 1..GEO_MAX_LADO.
+int geometria_iniciar(Geometria* g, int64_t largura, int64_t altura);
+
+static inline int geometria_dentro(const Geometria* g, int64_t x, int64_t y) {
+	return (uint64_t)x < (uint64_t)g->largura && (uint64_t)y < (uint64_t)g->altura;
+}
+
+static inline uint64_t geometria_casa(const Geometria* g, int64_t x, int64_t y) {
+	return (uint64_t)y * (uint64_t)g->largura + (uint64_t)x;
+}
+
+// Passos possíveis em um eixo antes da borda (sem limite se d == 0).
+static inline int64_t geometria_limite_eixo(int64_t pos, int64_t d, int64_t lado) {
+	if (d > 0) return (lado - 1 - pos) / d;
+	if (d < 0) return pos / -d;
+	return INT64_MAX;
+}
+
+// Quantos passos (dx, dy) cabem a partir de (x, y) sem sair do tabuleiro.
+static inline int64_t geometria_alcance(const Geometria* g, int64_t x, int64_t y, int64_t dx, int64_t dy) {
+	int64_t kx = geometria_limite_eixo(x, dx, g->largura);
+	int64_t ky = geometria_limite_eixo(y, dy, g->altura);
+	return kx < ky ? kx : ky;
+}
+
+// Move *p até n passos (dx, dy), parando na borda. Retorna os passos dados.
+static inline int64_t geometria_mover(const Geometria* g, Posicao* p, int64_t dx, int64_t dy, int64_t n) {
+	int64_t k = geometria_alcance(g, p->x, p->y, dx, dy);
+	if (n < k) k = n;
+	p->x = (int32_t)(p->x + k * dx);
+	p->y = (int32_t)(p->y + k * dy);
+	return k;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ OCUPAÇÃO
+
+ Conjunto de casas ocupadas. Tabuleiros de até 16x16 usam um bitset fixo
+ (4 palavras de 64 bits); os maiores, uma tabela hash de endereçamento
+ aberto com as chaves das casas (memória proporcional às peças, não ao
+ tabuleiro). A esparsa mantém também, para cada linha, coluna e diagonal
+ com peças, as posições ordenadas: o bloqueio de um raio é uma busca
+ binária, não importa o comprimento do raio.
+────────────────────────────────────────────────────────────────────────────
+*/
+typedef enum {
+	OCUPACAO_DENSA,
+	OCUPACAO_ESPARSA
+} TipoOcupacao;
+
+// Famílias de retas dos movimentos deslizantes (passo com |dx|, |dy| <= 1).
+typedef enum {
+	RETA_LINHA,     // dy = 0
+	RETA_COLUNA,    // dx = 0
+	RETA_DIAGONAL,  // dx = dy
+	RETA_ANTI,      // dx = -dy
+	RETA_QTD
+} FamiliaReta;
+
+typedef struct {
+	uint64_t chave;   // id da reta + 1; 0 = vazio
+	int32_t* pos;     // coordenada ao longo da reta, ordenada
+	uint32_t n;
+	uint32_t cap;
+} Reta;
+
+typedef struct {
+	Reta* retas;
+	size_t cap;       // potência de 2
+	size_t qtd;
+} IndiceRetas;
+
+typedef struct {
+	const Geometria* geo;
+	TipoOcupacao tipo;
+	size_t qtd;
+	uint64_t densa[GEO_DENSA_PALAVRAS];
+	uint64_t* chaves;  // casa + 1; 0 = vazio
+	size_t cap;        // potência de 2
+	IndiceRetas retas[RETA_QTD];
+} Ocupacao;
+
+// Escolhe a representação pelo tamanho do tabuleiro.
+int ocupacao_iniciar(Ocupacao* o, const Geometria* g);
+// Força uma representação (a densa só vale até 16x16). Retorna 0 se inválida.
+int ocupacao_iniciar_tipo(Ocupacao* o, const Geometria* g, TipoOcupacao tipo);
+void ocupacao_liberar(Ocupacao* o);
+
+// Retornam 1 se o conjunto mudou (0 se já estava / não estava, ou fora do tabuleiro).
+int ocupacao_inserir(Ocupacao* o, int64_t x, int64_t y);
+int ocupacao_remover(Ocupacao* o, int64_t x, int64_t y);
+
+// Consulta e deslizamento são inline: com (dx, dy) constantes (kernels do
+// motor de peças) o recorte e o caminho denso viram aritmética pura. Só a
+// busca na representação esparsa é chamada externa.
+int ocupacao_contem_esparsa(const Ocupacao* o, uint64_t casa);
+int64_t ocupacao_bloqueio_esparso(const Ocupacao* o, Posicao p, int64_t dx, int64_t dy, int64_t lim);
+
+static inline int ocupacao_contem(const Ocupacao* o, int64_t x, int64_t y) {
+	if (!geometria_dentro(o->geo, x, y)) return 0;
+	uint64_t casa = geometria_casa(o->geo, x, y);
+	if (o->tipo == OCUPACAO_DENSA) return (int)((o->densa[casa >> 6] >> (casa & 63)) & 1);
+	return ocupacao_contem_esparsa(o, casa);
+}
+
+// Passos livres a partir de p na direção (dx, dy), até n: para na borda
+// (recorte aritmético) ou antes da primeira casa ocupada. Na densa, anda
+// no bitset com um delta fixo (<= 15 passos); na esparsa, os passos
+// deslizantes usam o índice de retas (O(log peças na reta)) e os demais
+// (ex.: (2, 1) repetido) percorrem O(min(raio, peças)).
+static inline int64_t ocupacao_deslizar(const Ocupacao* o, Posicao p, int64_t dx, int64_t dy, int64_t n) {
+	if (dx == 0 && dy == 0) return 0;
+	int64_t lim = geometria_alcance(o->geo, p.x, p.y, dx, dy);
+	if (n < lim) lim = n;
+	if (lim <= 0) return 0;
+	if (o->qtd == 0) return lim;
+	if (o->tipo == OCUPACAO_ESPARSA) return ocupacao_bloqueio_esparso(o, p, dx, dy, lim);
+	int64_t delta = dy * o->geo->largura + dx;
+	int64_t casa = (int64_t)geometria_casa(o->geo, p.x, p.y);
+	for (int64_t k = 1; k <= lim; k++) {
+		casa += delta;
+		if ((o->densa[casa >> 6] >> (casa & 63)) & 1) return k - 1;
+	}
+	return lim;
+}
+
+#endif
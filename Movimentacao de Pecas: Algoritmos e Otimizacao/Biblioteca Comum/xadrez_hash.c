@@ -0,0 +1,165 @@
+#include "xadrez_hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define P1 0x9E3779B185EBCA87ULL
+#define P2 0xC2B2AE3D27D4EB4FULL
+#define P3 0x165667B19E3779F9ULL
+#define P4 0x85EBCA77C2B2AE63ULL
+#define P5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t rotl(uint64_t x, int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t ler64(const uint8_t* p) {
+	uint64_t v;
+	memcpy(&v, p, 8);
+	return v;
+}
+
+static inline uint32_t ler32(const uint8_t* p) {
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+static inline uint64_t rodada(uint64_t acc, uint64_t entrada) {
+	acc += entrada * P2;
+	return rotl(acc, 31) * P1;
+}
+
+static inline uint64_t juntar(uint64_t h, uint64_t acc) {
+	h ^= rodada(0, acc);
+	return h * P1 + P4;
+}
+
+// Consome faixas de 32 bytes; devolve o ponteiro após a última inteira.
+static const uint8_t* faixas(uint64_t v[4], const uint8_t* p, const uint8_t* fim) {
+	uint64_t a = v[0], b = v[1], c = v[2], d = v[3];
+	for (; fim - p >= 32; p += 32) {
+		a = rodada(a, ler64(p));
+		b = rodada(b, ler64(p + 8));
+		c = rodada(c, ler64(p + 16));
+		d = rodada(d, ler64(p + 24));
+	}
+	v[0] = a;
+	v[1] = b;
+	v[2] = c;
+	v[3] = d;
+	return p;
+}
+
+void hash64_iniciar(Hash64* h, uint64_t semente) {
+	h->total = 0;
+	h->v[0] = semente + P1 + P2;
+	h->v[1] = semente + P2;
+	h->v[2] = semente;
+	h->v[3] = semente - P1;
+	h->len_resto = 0;
+	h->semente = semente;
+}
+
+void hash64_atualizar(Hash64* h, const void* dados, size_t n) {
+	const uint8_t* p = dados;
+	const uint8_t* fim = p + n;
+	h->total += n;
+	if (h->len_resto + n < 32) {
+		memcpy(h->resto + h->len_resto, p, n);
+		h->len_resto += n;
+		return;
+	}
+	if (h->len_resto) {
+		size_t falta = 32 - h->len_resto;
+		memcpy(h->resto + h->len_resto, p, falta);
+		faixas(h->v, h->resto, h->resto + 32);
+		p += falta;
+		h->len_resto = 0;
+	}
+	p = faixas(h->v, p, fim);
+	h->len_resto = (size_t)(fim - p);
+	memcpy(h->resto, p, h->len_resto);
+}
+
+uint64_t hash64_final(const Hash64* h) {
+	uint64_t r;
+	if (h->total >= 32) {
+		const uint64_t* v = h->v;
+		r = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+		for (int i = 0; i < 4; i++) r = juntar(r, v[i]);
+	} else {
+		r = h->semente + P5;
+	}
+	r += h->total;
+
+	const uint8_t* p = h->resto;
+	size_t n = h->len_resto;
+	for (; n >= 8; p += 8, n -= 8) r = rotl(r ^ rodada(0, ler64(p)), 27) * P1 + P4;
+	if (n >= 4) {
+		r = rotl(r ^ (uint64_t)ler32(p) * P1, 23) * P2 + P3;
+		p += 4;
+		n -= 4;
+	}
+	for (; n > 0; p++, n--) r = rotl(r ^ *p * P5, 11) * P1;
+
+	r ^= r >> 33;
+	r *= P2;
+	r ^= r >> 29;
+	r *= P3;
+	r ^= r >> 32;
+	return r;
+}
+
+uint64_t hash64(const void* p, size_t n, uint64_t semente) {
+	Hash64 h;
+	hash64_iniciar(&h, semente);
+	hash64_atualizar(&h, p, n);
+	return hash64_final(&h);
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ SAÍDA COM RESUMO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static int descarregar_resumindo(Saida* s) {
+	DigestSaida* d = s->ctx;
+	hash64_atualizar(&d->hash, s->buf, s->len);
+	if (d->destino) {
+		saida_escrever(d->destino, s->buf, s->len);
+		if (d->destino->erro) s->erro = 1;
+	}
+	s->total += s->len;
+	s->len = 0;
+	return !s->erro;
+}
+
+static int encerrar_resumo(Saida* s) {
+	int ok = descarregar_resumindo(s);
+	free(s->buf);
+	s->buf = NULL;
+	s->cap = 0;
+	s->descarregar = NULL;
+	s->encerrar = NULL;
+	return ok;
+}
+
+int saida_abrir_digest(Saida* s, DigestSaida* d, Saida* destino, size_t cap) {
+	if (!s || !d) return 0;
+	if (cap < 64) cap = SAIDA_CAP_PADRAO;
+	s->buf = malloc(cap);
+	if (!s->buf) return 0;
+	d->destino = destino;
+	hash64_iniciar(&d->hash, HASH64_SEMENTE);
+	s->fd = destino ? destino->fd : -1;
+	s->cap = cap;
+	s->len = 0;
+	s->total = 0;
+	s->erro = 0;
+	s->descarregar = descarregar_resumindo;
+	s->encerrar = encerrar_resumo;
+	s->ctx = d;
+	return 1;
+}
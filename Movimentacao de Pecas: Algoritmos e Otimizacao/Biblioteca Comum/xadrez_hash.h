@@ -0,0 +1,42 @@
+#ifndef XADREZ_HASH_H
+#define XADREZ_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xadrez_saida.h"
+
+// Hash de 64 bits incremental (algoritmo do XXH64: quatro acumuladores
+// sobre faixas de 32 bytes, mistura final por avalanche), para conferir
+// traços gigantes sem guardar uma cópia: o resumo é calculado no próprio
+// escritor, bloco a bloco, numa passada. Com a mesma semente, o resultado
+// é o do XXH64 de referência em máquinas little-endian.
+
+#define HASH64_SEMENTE 0
+
+typedef struct {
+	uint64_t total;   // bytes vistos
+	uint64_t v[4];    // acumuladores das faixas
+	uint8_t resto[32];
+	size_t len_resto; // bytes pendentes em 'resto' (< 32)
+	uint64_t semente;
+} Hash64;
+
+void hash64_iniciar(Hash64* h, uint64_t semente);
+void hash64_atualizar(Hash64* h, const void* p, size_t n);
+uint64_t hash64_final(const Hash64* h); // não altera h: pode seguir atualizando
+
+// Resumo de um buffer inteiro (mesmo valor que iniciar/atualizar/final).
+uint64_t hash64(const void* p, size_t n, uint64_t semente);
+
+// Saída com resumo: tudo o que passa por s entra no hash e, se 'destino'
+// não for NULL, segue para ele (sem destino, o fluxo só é resumido).
+// saida_fechar(s) não fecha 'destino'. s->total = bytes resumidos.
+typedef struct {
+	Saida* destino;
+	Hash64 hash;
+} DigestSaida;
+
+int saida_abrir_digest(Saida* s, DigestSaida* d, Saida* destino, size_t cap);
+
+#endif
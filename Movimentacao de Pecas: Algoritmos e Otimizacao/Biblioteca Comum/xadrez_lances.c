@@ -0,0 +1,438 @@
+#include "xadrez_lances.h"
+
+#define FILEIRA_1 0x00000000000000FFULL
+#define FILEIRA_3 0x0000000000FF0000ULL
+#define FILEIRA_6 0x0000FF0000000000ULL
+#define FILEIRA_8 0xFF00000000000000ULL
+
+// Letra SAN de cada TipoPeca (peão não tem letra).
+static const char LETRA_SAN[TP_QTD] = { 0, 'N', 'B', 'R', 'Q', 'K' };
+
+const uint8_t ROQUE_PERDIDO[64] = {
+	[0] = ROQUE_Q, [4] = ROQUE_K | ROQUE_Q, [7] = ROQUE_K,
+	[56] = ROQUE_q, [60] = ROQUE_k | ROQUE_q, [63] = ROQUE_k,
+};
+
+static inline Bitboard deslocar(Bitboard b, int s) {
+	return s > 0 ? b << s : b >> -s;
+}
+
+static inline Bitboard ataques_bispo(int casa, Bitboard ocupadas) {
+	return bb_ataques_deslizantes(PECA_BISPO, BB_CASA(casa), ~ocupadas);
+}
+
+static inline Bitboard ataques_torre(int casa, Bitboard ocupadas) {
+	return bb_ataques_deslizantes(PECA_TORRE, BB_CASA(casa), ~ocupadas);
+}
+
+int casa_atacada(const Tabuleiro* t, int casa, Cor por) {
+	const Bitboard* p = t->pecas[por];
+	Bitboard b = BB_CASA(casa);
+	if (ataques_cavalo(b) & p[TP_CAVALO]) return 1;
+	if (ataques_rei(b) & p[TP_REI]) return 1;
+	// Um peão de 'por' ataca a casa se está onde um peão adversário
+	// nessa casa atacaria.
+	if (ataques_peao(b, (Cor)!por) & p[TP_PEAO]) return 1;
+	Bitboard ocupadas = tabuleiro_ocupadas(t);
+	Bitboard diagonais = p[TP_BISPO] | p[TP_RAINHA];
+	if (diagonais && (ataques_bispo(casa, ocupadas) & diagonais)) return 1;
+	Bitboard retas = p[TP_TORRE] | p[TP_RAINHA];
+	return retas && (ataques_torre(casa, ocupadas) & retas);
+}
+
+static inline int casa_do_rei(const Tabuleiro* t, Cor cor) {
+	return __builtin_ctzll(t->pecas[cor][TP_REI]);
+}
+
+int em_xeque(const Tabuleiro* t) {
+	return casa_atacada(t, casa_do_rei(t, (Cor)t->lado), (Cor)!t->lado);
+}
+
+void aplicar_lance(Tabuleiro* t, Lance l) {
+	Cor nos = (Cor)t->lado;
+	uint8_t cod = t->casa[l.de];
+	int zera = COD_TIPO(cod) == TP_PEAO;
+	if (l.flags & LANCE_EN_PASSANT) {
+		tabuleiro_tirar(t, nos == COR_BRANCA ? l.para - 8 : l.para + 8);
+		zera = 1;
+	} else if (t->casa[l.para] != CASA_VAZIA) {
+		tabuleiro_tirar(t, l.para);
+		zera = 1;
+	}
+	tabuleiro_tirar(t, l.de);
+	tabuleiro_por(t, l.para, l.promocao ? PECA_COD(nos, l.promocao) : cod);
+	if (l.flags & LANCE_ROQUE) {
+		int base = l.de & 56;
+		int de = l.para > l.de ? base + 7 : base;
+		int para = l.para > l.de ? base + 5 : base + 3;
+		uint8_t torre = t->casa[de];
+		tabuleiro_tirar(t, de);
+		tabuleiro_por(t, para, torre);
+	}
+	t->roques &= (uint8_t)~(ROQUE_PERDIDO[l.de] | ROQUE_PERDIDO[l.para]);
+	t->en_passant = (l.flags & LANCE_DUPLO) ? (int8_t)((l.de + l.para) / 2) : SEM_EN_PASSANT;
+	t->meio_lance = zera ? 0 : (uint16_t)(t->meio_lance + (t->meio_lance < 65535));
+	if (nos == COR_PRETA) t->lance++;
+	t->lado = (uint8_t)!nos;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ GERAÇÃO
+
+ Primeiro os lances pseudo-legais (a peça se move como deve), depois o
+ filtro de legalidade. Um lance só pode expor o próprio rei se o rei está
+ em xeque, se é o próprio rei que anda, se é en passant (duas casas se
+ esvaziam) ou se a peça sai de uma linha/diagonal que passa pelo rei; os
+ demais são legais sem teste. Os suspeitos são aplicados numa cópia.
+
+ A geração é preguiçosa e em etapas (capturas, depois quietos): o filtro
+ roda lance a lance, conforme o consumidor pede, e os quietos só são
+ gerados quando as capturas acabam.
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static inline void adicionar(ListaLances* lista, int de, int para, int flags) {
+	lista->l[lista->n++] = (Lance){ (uint8_t)de, (uint8_t)para, 0, (uint8_t)flags };
+}
+
+static inline void adicionar_destinos(ListaLances* lista, int de, Bitboard destinos, int flags) {
+	for (; destinos; destinos &= destinos - 1) adicionar(lista, de, __builtin_ctzll(destinos), flags);
+}
+
+// Lances de peão cujo destino está em 'destinos', vindos de para - delta.
+static void adicionar_peoes(ListaLances* lista, Bitboard destinos, int delta, int flags, Bitboard promocao) {
+	for (; destinos; destinos &= destinos - 1) {
+		int para = __builtin_ctzll(destinos);
+		int de = para - delta;
+		if ((promocao >> para) & 1) {
+			for (int tp = TP_RAINHA; tp >= TP_CAVALO; tp--)
+				lista->l[lista->n++] = (Lance){ (uint8_t)de, (uint8_t)para, (uint8_t)tp, (uint8_t)flags };
+		} else {
+			adicionar(lista, de, para, flags);
+		}
+	}
+}
+
+// Lances pseudo-legais de uma etapa: ETAPA_CAPTURAS traz capturas (com
+// en passant) e promoções; ETAPA_QUIETOS o resto, roques incluídos. Os
+// ataques das peças são calculados uma vez, na etapa das capturas, e
+// guardados no iterador para a etapa dos quietos.
+static void gerar_etapa(IterLances* it) {
+	const Tabuleiro* t = it->t;
+	ListaLances* lista = &it->pendentes;
+	Cor nos = (Cor)t->lado, eles = (Cor)!nos;
+	const Bitboard* p = t->pecas[nos];
+	Bitboard proprias = t->cor[nos], deles = t->cor[eles];
+	Bitboard ocupadas = proprias | deles, vazias = ~ocupadas;
+	int capturas = it->etapa == ETAPA_CAPTURAS;
+	lista->n = 0;
+
+	// Peões
+	int frente = nos == COR_BRANCA ? 8 : -8;
+	int diag_esq = nos == COR_BRANCA ? 7 : -9;   // para a coluna a
+	int diag_dir = nos == COR_BRANCA ? 9 : -7;   // para a coluna h
+	Bitboard promocao = nos == COR_BRANCA ? FILEIRA_8 : FILEIRA_1;
+	Bitboard peoes = p[TP_PEAO];
+	Bitboard simples = deslocar(peoes, frente) & vazias;
+	if (capturas) {
+		adicionar_peoes(lista, simples & promocao, frente, 0, promocao);
+		adicionar_peoes(lista, deslocar(peoes, diag_esq) & ~BB_COLUNA_H & deles, diag_esq, LANCE_CAPTURA, promocao);
+		adicionar_peoes(lista, deslocar(peoes, diag_dir) & ~BB_COLUNA_A & deles, diag_dir, LANCE_CAPTURA, promocao);
+		if (t->en_passant != SEM_EN_PASSANT) {
+			Bitboard capturadores = ataques_peao(BB_CASA(t->en_passant), eles) & peoes;
+			for (; capturadores; capturadores &= capturadores - 1)
+				adicionar(lista, __builtin_ctzll(capturadores), t->en_passant, LANCE_CAPTURA | LANCE_EN_PASSANT);
+		}
+
+		// Ataques de cada peça (o rei por último).
+		int n = 0;
+		for (Bitboard b = p[TP_CAVALO]; b; b &= b - 1) {
+			int de = __builtin_ctzll(b);
+			it->origem[n] = (uint8_t)de;
+			it->ataques[n++] = ataques_cavalo(BB_CASA(de));
+		}
+		for (Bitboard b = p[TP_BISPO]; b; b &= b - 1) {
+			int de = __builtin_ctzll(b);
+			it->origem[n] = (uint8_t)de;
+			it->ataques[n++] = ataques_bispo(de, ocupadas);
+		}
+		for (Bitboard b = p[TP_TORRE]; b; b &= b - 1) {
+			int de = __builtin_ctzll(b);
+			it->origem[n] = (uint8_t)de;
+			it->ataques[n++] = ataques_torre(de, ocupadas);
+		}
+		for (Bitboard b = p[TP_RAINHA]; b; b &= b - 1) {
+			int de = __builtin_ctzll(b);
+			it->origem[n] = (uint8_t)de;
+			it->ataques[n++] = ataques_bispo(de, ocupadas) | ataques_torre(de, ocupadas);
+		}
+		it->origem[n] = (uint8_t)it->rei;
+		it->ataques[n++] = ataques_rei(BB_CASA(it->rei));
+		it->n_pecas = n;
+	} else {
+		Bitboard duplos = deslocar(simples & (nos == COR_BRANCA ? FILEIRA_3 : FILEIRA_6), frente) & vazias;
+		adicionar_peoes(lista, simples & ~promocao, frente, 0, 0);
+		adicionar_peoes(lista, duplos, 2 * frente, LANCE_DUPLO, 0);
+	}
+
+	// Peças
+	Bitboard alvos = capturas ? deles : vazias;
+	int flags = capturas ? LANCE_CAPTURA : 0;
+	for (int k = 0; k < it->n_pecas; k++) adicionar_destinos(lista, it->origem[k], it->ataques[k] & alvos, flags);
+	if (capturas) return;
+
+	// Roques: rei e torre nas casas de origem, casas entre eles vazias e o
+	// rei não pode sair de xeque nem atravessar casa atacada (a casa de
+	// chegada é conferida pelo filtro de legalidade, como todo lance de rei).
+	int rei = it->rei;
+	int base = nos == COR_BRANCA ? 0 : 56;
+	uint8_t dir_k = nos == COR_BRANCA ? ROQUE_K : ROQUE_k;
+	uint8_t dir_q = nos == COR_BRANCA ? ROQUE_Q : ROQUE_q;
+	uint8_t cod_torre = PECA_COD(nos, TP_TORRE);
+	if ((t->roques & (dir_k | dir_q)) && rei == base + 4 && !it->xeque) {
+		if ((t->roques & dir_k) && t->casa[base + 7] == cod_torre &&
+		    !(ocupadas & (BB_CASA(base + 5) | BB_CASA(base + 6))) &&
+		    !casa_atacada(t, base + 5, eles))
+			adicionar(lista, rei, base + 6, LANCE_ROQUE);
+		if ((t->roques & dir_q) && t->casa[base] == cod_torre &&
+		    !(ocupadas & (BB_CASA(base + 1) | BB_CASA(base + 2) | BB_CASA(base + 3))) &&
+		    !casa_atacada(t, base + 3, eles))
+			adicionar(lista, rei, base + 2, LANCE_ROQUE);
+	}
+}
+
+// Aplica o lance numa cópia e confere se o rei de quem jogou ficou a salvo.
+static int deixa_rei_seguro(const Tabuleiro* t, Lance l) {
+	Cor nos = (Cor)t->lado;
+	Tabuleiro copia = *t;
+	aplicar_lance(&copia, l);
+	return !casa_atacada(&copia, casa_do_rei(&copia, nos), (Cor)!nos);
+}
+
+void lances_iniciar(IterLances* it, const Tabuleiro* t) {
+	Cor nos = (Cor)t->lado;
+	it->t = t;
+	it->etapa = ETAPA_CAPTURAS;
+	it->i = 0;
+	it->rei = casa_do_rei(t, nos);
+	it->xeque = casa_atacada(t, it->rei, (Cor)!nos);
+	// Casas nas linhas e diagonais do rei, ignorando bloqueios.
+	it->linhas_do_rei = bb_ataques_deslizantes(PECA_RAINHA, BB_CASA(it->rei), BB_TUDO);
+	gerar_etapa(it);
+}
+
+static inline int proximo_legal(IterLances* it, Lance* out) {
+	for (;;) {
+		while (it->i < it->pendentes.n) {
+			Lance l = it->pendentes.l[it->i++];
+			int suspeito = it->xeque || l.de == it->rei || (l.flags & LANCE_EN_PASSANT) ||
+			               ((it->linhas_do_rei >> l.de) & 1);
+			if (!suspeito || deixa_rei_seguro(it->t, l)) {
+				*out = l;
+				return 1;
+			}
+		}
+		if (it->etapa != ETAPA_CAPTURAS) return 0;
+		// Capturas esgotadas: só agora os lances quietos são gerados.
+		it->etapa = ETAPA_QUIETOS;
+		it->i = 0;
+		gerar_etapa(it);
+	}
+}
+
+int lances_proximo(IterLances* it, Lance* out) {
+	return proximo_legal(it, out);
+}
+
+int gerar_lances(const Tabuleiro* t, ListaLances* lista) {
+	IterLances it;
+	lances_iniciar(&it, t);
+	lista->n = 0;
+	while (proximo_legal(&it, &lista->l[lista->n])) lista->n++;
+	return lista->n;
+}
+
+int tem_lance_legal(const Tabuleiro* t) {
+	IterLances it;
+	Lance l;
+	lances_iniciar(&it, t);
+	return lances_proximo(&it, &l);
+}
+
+uint64_t perft(const Tabuleiro* t, int profundidade) {
+	ListaLances lista;
+	int n = gerar_lances(t, &lista);
+	if (profundidade <= 1) return profundidade == 1 ? (uint64_t)n : 1;
+	uint64_t total = 0;
+	for (int i = 0; i < n; i++) {
+		Tabuleiro filho = *t;
+		aplicar_lance(&filho, lista.l[i]);
+		total += perft(&filho, profundidade - 1);
+	}
+	return total;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ SAN
+────────────────────────────────────────────────────────────────────────────
+*/
+
+size_t lance_para_san(const Tabuleiro* t, const ListaLances* legais, Lance l, char* dst) {
+	size_t n = 0;
+	TipoPeca tipo = COD_TIPO(t->casa[l.de]);
+	if (l.flags & LANCE_ROQUE) {
+		const char* s = l.para > l.de ? "O-O" : "O-O-O";
+		while (*s) dst[n++] = *s++;
+	} else {
+		if (tipo == TP_PEAO) {
+			if (l.flags & LANCE_CAPTURA) dst[n++] = (char)('a' + l.de % 8);
+		} else {
+			dst[n++] = LETRA_SAN[tipo];
+			// Desambiguação: coluna se basta, senão fileira, senão as duas.
+			int outros = 0, mesma_coluna = 0, mesma_fileira = 0;
+			for (int i = 0; i < legais->n; i++) {
+				Lance o = legais->l[i];
+				if (o.para != l.para || o.de == l.de || t->casa[o.de] != t->casa[l.de]) continue;
+				outros++;
+				mesma_coluna |= o.de % 8 == l.de % 8;
+				mesma_fileira |= o.de / 8 == l.de / 8;
+			}
+			if (outros) {
+				if (!mesma_coluna || mesma_fileira) dst[n++] = (char)('a' + l.de % 8);
+				if (mesma_coluna) dst[n++] = (char)('1' + l.de / 8);
+			}
+		}
+		if (l.flags & LANCE_CAPTURA) dst[n++] = 'x';
+		dst[n++] = (char)('a' + l.para % 8);
+		dst[n++] = (char)('1' + l.para / 8);
+		if (l.promocao) {
+			dst[n++] = '=';
+			dst[n++] = LETRA_SAN[l.promocao];
+		}
+	}
+	Tabuleiro depois = *t;
+	aplicar_lance(&depois, l);
+	if (em_xeque(&depois)) {
+		dst[n++] = tem_lance_legal(&depois) ? '+' : '#';
+	}
+	dst[n] = '\0';
+	return n;
+}
+
+static int tipo_da_letra(char c) {
+	switch (c) {
+	case 'N': return TP_CAVALO;
+	case 'B': return TP_BISPO;
+	case 'R': return TP_TORRE;
+	case 'Q': return TP_RAINHA;
+	case 'K': return TP_REI;
+	default: return -1;
+	}
+}
+
+static int eh_coluna(char c) { return c >= 'a' && c <= 'h'; }
+static int eh_fileira(char c) { return c >= '1' && c <= '8'; }
+
+// Resolução de trás para frente: em vez de gerar todos os lances, parte da
+// casa de destino e acha as peças do tipo pedido que chegam nela (os
+// ataques são simétricos: um cavalo em 'de' ataca 'para' se um cavalo em
+// 'para' ataca 'de'). Só os candidatos que passam pela desambiguação são
+// testados quanto à legalidade.
+SanResultado san_resolver(const Tabuleiro* t, const char* ini, const char* fim, Lance* out) {
+	// Sufixos de xeque e anotações não mudam o lance.
+	while (fim > ini && (fim[-1] == '+' || fim[-1] == '#' || fim[-1] == '!' || fim[-1] == '?')) fim--;
+	if (fim - ini < 2) return SAN_SINTAXE;
+
+	// Roques (também com zeros, como em alguns arquivos antigos).
+	if (ini[0] == 'O' || ini[0] == '0') {
+		size_t len = (size_t)(fim - ini);
+		int curto = len == 3 && ini[1] == '-' && ini[2] == ini[0];
+		int longo = len == 5 && ini[1] == '-' && ini[2] == ini[0] && ini[3] == '-' && ini[4] == ini[0];
+		if (!curto && !longo) return SAN_SINTAXE;
+		ListaLances legais;
+		gerar_lances(t, &legais);
+		for (int i = 0; i < legais.n; i++) {
+			Lance l = legais.l[i];
+			if ((l.flags & LANCE_ROQUE) && (l.para > l.de) == curto) {
+				*out = l;
+				return SAN_OK;
+			}
+		}
+		return SAN_ILEGAL;
+	}
+
+	int tipo = TP_PEAO;
+	if (tipo_da_letra(*ini) >= 0) tipo = tipo_da_letra(*ini++);
+
+	int promocao = 0;
+	if (tipo == TP_PEAO && fim - ini >= 3 && tipo_da_letra(fim[-1]) > TP_PEAO && fim[-1] != 'K') {
+		promocao = tipo_da_letra(fim[-1]);
+		fim--;
+		if (fim[-1] == '=') fim--;
+	}
+	if (fim - ini < 2 || !eh_coluna(fim[-2]) || !eh_fileira(fim[-1])) return SAN_SINTAXE;
+	int para = (fim[-1] - '1') * 8 + (fim[-2] - 'a');
+	fim -= 2;
+
+	// Entre a peça e o destino: [coluna][fileira][x ou -].
+	int coluna = -1, fileira = -1, captura = 0;
+	if (ini < fim && eh_coluna(*ini)) coluna = *ini++ - 'a';
+	if (ini < fim && eh_fileira(*ini)) fileira = *ini++ - '1';
+	if (ini < fim && (*ini == 'x' || *ini == ':')) {
+		captura = 1;
+		ini++;
+	} else if (ini < fim && *ini == '-') {
+		ini++;
+	}
+	if (ini != fim) return SAN_SINTAXE;
+
+	Cor nos = (Cor)t->lado, eles = (Cor)!nos;
+	const Bitboard* p = t->pecas[nos];
+	Bitboard alvo = BB_CASA(para), ocupadas = tabuleiro_ocupadas(t);
+	if (t->cor[nos] & alvo) return SAN_ILEGAL;
+	int flags = (t->cor[eles] & alvo) ? LANCE_CAPTURA : 0;
+	if (captura && !flags && !(tipo == TP_PEAO && para == t->en_passant)) return SAN_ILEGAL;
+
+	// Origens possíveis do tipo pedido.
+	Bitboard origens = 0;
+	switch (tipo) {
+	case TP_CAVALO: origens = ataques_cavalo(alvo); break;
+	case TP_BISPO: origens = ataques_bispo(para, ocupadas); break;
+	case TP_TORRE: origens = ataques_torre(para, ocupadas); break;
+	case TP_RAINHA: origens = ataques_bispo(para, ocupadas) | ataques_torre(para, ocupadas); break;
+	case TP_REI: origens = ataques_rei(alvo); break;
+	default: {
+		int frente = nos == COR_BRANCA ? 8 : -8;
+		int ultima = nos == COR_BRANCA ? 7 : 0;
+		if ((para / 8 == ultima) != (promocao != 0)) return SAN_ILEGAL;
+		if (captura) {
+			if (para == t->en_passant) flags = LANCE_CAPTURA | LANCE_EN_PASSANT;
+			origens = ataques_peao(alvo, eles);
+		} else if (!(ocupadas & alvo)) {
+			// Avanço: simples, ou duplo a partir da fileira inicial.
+			int de = para - frente;
+			if (coluna >= 0 && coluna != para % 8) return SAN_SINTAXE;
+			if (de >= 0 && de < 64 && (p[TP_PEAO] & BB_CASA(de))) {
+				origens = BB_CASA(de);
+			} else if (para / 8 == (nos == COR_BRANCA ? 3 : 4) && !(ocupadas & BB_CASA(de))) {
+				origens = BB_CASA(de - frente);
+				flags = LANCE_DUPLO;
+			}
+		}
+	}
+	}
+	origens &= p[tipo];
+	if (coluna >= 0) origens &= BB_COLUNA_A << coluna;
+	if (fileira >= 0) origens &= 0xFFULL << (8 * fileira);
+
+	int achados = 0;
+	for (; origens; origens &= origens - 1) {
+		Lance l = { (uint8_t)__builtin_ctzll(origens), (uint8_t)para, (uint8_t)promocao, (uint8_t)flags };
+		if (!deixa_rei_seguro(t, l)) continue;
+		*out = l;
+		achados++;
+	}
+	return achados == 1 ? SAN_OK : achados ? SAN_AMBIGUO : SAN_ILEGAL;
+}
@@ -0,0 +1,121 @@
+#ifndef XADREZ_LANCES_H
+#define XADREZ_LANCES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xadrez_posicao.h"
+
+// Gerador de lances legais sobre o Tabuleiro (xadrez_posicao.h), com as
+// regras completas: roques, en passant, promoções e a proibição de deixar
+// o próprio rei em xeque. Os ataques saem dos bitboards: saltos por
+// deslocamentos e deslizantes por preenchimento Kogge-Stone
+// (xadrez_bitboard.h). A legalidade é testada aplicando o lance numa cópia
+// do tabuleiro (copy-make).
+
+#define LANCE_CAPTURA     1
+#define LANCE_EN_PASSANT  2
+#define LANCE_ROQUE       4
+#define LANCE_DUPLO       8   // avanço duplo de peão
+
+typedef struct {
+	uint8_t de;
+	uint8_t para;
+	uint8_t promocao;  // TipoPeca da promoção ou 0 (TP_PEAO) se não há
+	uint8_t flags;     // LANCE_*
+} Lance;
+
+#define MAX_LANCES 256
+#define SAN_MAX 8   // "Qa1xb2+" + '\0'
+
+typedef struct {
+	int n;
+	Lance l[MAX_LANCES];
+} ListaLances;
+
+// Direitos de roque perdidos quando um lance toca a casa (saindo ou
+// chegando): mexer no rei ou numa torre de canto, ou capturar a torre.
+extern const uint8_t ROQUE_PERDIDO[64];
+
+// Ataques de um conjunto de casas (set-wise).
+static inline Bitboard ataques_cavalo(Bitboard b) {
+	Bitboard l1 = (b >> 1) & ~BB_COLUNA_H, l2 = (b >> 2) & ~(BB_COLUNA_H | (BB_COLUNA_H >> 1));
+	Bitboard r1 = (b << 1) & ~BB_COLUNA_A, r2 = (b << 2) & ~(BB_COLUNA_A | (BB_COLUNA_A << 1));
+	Bitboard h1 = l1 | r1, h2 = l2 | r2;
+	return (h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8);
+}
+
+static inline Bitboard ataques_rei(Bitboard b) {
+	Bitboard linha = b | ((b << 1) & ~BB_COLUNA_A) | ((b >> 1) & ~BB_COLUNA_H);
+	return (linha | (linha << 8) | (linha >> 8)) & ~b;
+}
+
+static inline Bitboard ataques_peao(Bitboard b, Cor cor) {
+	if (cor == COR_BRANCA) return ((b << 7) & ~BB_COLUNA_H) | ((b << 9) & ~BB_COLUNA_A);
+	return ((b >> 9) & ~BB_COLUNA_H) | ((b >> 7) & ~BB_COLUNA_A);
+}
+
+// 1 se 'casa' é atacada por alguma peça da cor 'por'.
+int casa_atacada(const Tabuleiro* t, int casa, Cor por);
+
+// 1 se o lado a jogar está em xeque.
+int em_xeque(const Tabuleiro* t);
+
+// Gerador preguiçoso (pull) de lances legais, em etapas: primeiro as
+// capturas e promoções, depois os lances quietos. Cada lances_proximo
+// testa a legalidade só do lance que entrega, e a etapa dos quietos só é
+// gerada quando as capturas acabam; quem para cedo (primeiro lance legal,
+// corte numa busca) não paga pelo resto.
+typedef enum {
+	ETAPA_CAPTURAS,
+	ETAPA_QUIETOS
+} EtapaLances;
+
+typedef struct {
+	const Tabuleiro* t;
+	EtapaLances etapa;
+	int i;                   // próximo de 'pendentes'
+	ListaLances pendentes;   // pseudo-legais da etapa atual
+	int rei;
+	int xeque;
+	Bitboard linhas_do_rei;
+	int n_pecas;             // ataques das peças (sem peões), da 1ª etapa
+	uint8_t origem[16];
+	Bitboard ataques[16];
+} IterLances;
+
+void lances_iniciar(IterLances* it, const Tabuleiro* t);
+
+// Entrega o próximo lance legal em *out; 0 quando acabou. it->etapa diz
+// de qual etapa ele veio.
+int lances_proximo(IterLances* it, Lance* out);
+
+// Lances legais do lado a jogar (capturas primeiro); retorna a quantidade.
+int gerar_lances(const Tabuleiro* t, ListaLances* lista);
+
+// 1 se há algum lance legal (para no primeiro).
+int tem_lance_legal(const Tabuleiro* t);
+
+// Aplica um lance (supostamente legal) e passa a vez.
+void aplicar_lance(Tabuleiro* t, Lance l);
+
+// Notação algébrica curta (SAN) de um lance legal de t, com
+// desambiguação e sufixo '+'/'#'. 'legais' são os lances de t (evita
+// gerar de novo). Retorna o tamanho escrito em dst (SAN_MAX bytes).
+size_t lance_para_san(const Tabuleiro* t, const ListaLances* legais, Lance l, char* dst);
+
+typedef enum {
+	SAN_OK,
+	SAN_SINTAXE,    // texto não é SAN
+	SAN_ILEGAL,     // nenhum lance legal corresponde
+	SAN_AMBIGUO     // mais de um lance legal corresponde
+} SanResultado;
+
+// Resolve o SAN em [ini, fim) contra os lances legais de t: o lance
+// precisa existir, ser único e, com 'x', ser uma captura.
+SanResultado san_resolver(const Tabuleiro* t, const char* ini, const char* fim, Lance* out);
+
+// Nós folha a 'profundidade' lances de t (contagem "perft").
+uint64_t perft(const Tabuleiro* t, int profundidade);
+
+#endif
@@ -0,0 +1,108 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "xadrez_latencia.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void histograma_zerar(Histograma* h) {
+	memset(h, 0, sizeof *h);
+}
+
+void histograma_juntar(Histograma* destino, const Histograma* h) {
+	for (unsigned i = 0; i < LATENCIA_BALDES; i++) destino->contagem[i] += h->contagem[i];
+	destino->total += h->total;
+	destino->soma_ns += h->soma_ns;
+	if (h->max_ns > destino->max_ns) destino->max_ns = h->max_ns;
+}
+
+// Maior valor que cai no balde i.
+static uint64_t teto_balde(unsigned i) {
+	if (i < LATENCIA_SUB) return i;
+	unsigned desl = i / LATENCIA_SUB - 1;
+	uint64_t base = (uint64_t)(i % LATENCIA_SUB + LATENCIA_SUB) << desl;
+	return base + ((1ull << desl) - 1);
+}
+
+uint64_t histograma_percentil(const Histograma* h, double p) {
+	if (h->total == 0) return 0;
+	if (p >= 1.0) return h->max_ns;
+	uint64_t ordem = (uint64_t)(p * (double)h->total);
+	if ((double)ordem < p * (double)h->total) ordem++;
+	if (ordem == 0) ordem = 1;
+	uint64_t acumulado = 0;
+	for (unsigned i = 0; i < LATENCIA_BALDES; i++) {
+		acumulado += h->contagem[i];
+		if (acumulado >= ordem) {
+			uint64_t v = teto_balde(i);
+			return v < h->max_ns ? v : h->max_ns;
+		}
+	}
+	return h->max_ns;
+}
+
+void histograma_exportar(FILE* f, const char* origem, const char* fase, const Histograma* h, int json) {
+	static const double PERCENTIS[] = { 0.50, 0.90, 0.99, 0.999 };
+	static const char* const NOMES[] = { "p50", "p90", "p99", "p999" };
+	uint64_t media = h->total ? h->soma_ns / h->total : 0;
+	if (json) {
+		fprintf(f, "{\"origem\":\"%s\",\"fase\":\"%s\",\"n\":%llu,\"media_ns\":%llu", origem ? origem : "final", fase,
+			(unsigned long long)h->total, (unsigned long long)media);
+		for (int i = 0; i < 4; i++) fprintf(f, ",\"%s_ns\":%llu", NOMES[i], (unsigned long long)histograma_percentil(h, PERCENTIS[i]));
+		fprintf(f, ",\"max_ns\":%llu}\n", (unsigned long long)h->max_ns);
+	} else {
+		fprintf(f, "[latência%s%s] fase=%s n=%llu média=%lluns", origem ? " " : "", origem ? origem : "", fase,
+			(unsigned long long)h->total, (unsigned long long)media);
+		for (int i = 0; i < 4; i++) fprintf(f, " %s=%lluns", NOMES[i], (unsigned long long)histograma_percentil(h, PERCENTIS[i]));
+		fprintf(f, " máx=%lluns\n", (unsigned long long)h->max_ns);
+	}
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ SAÍDA CRONOMETRADA
+────────────────────────────────────────────────────────────────────────────
+*/
+
+// Entrega o bloco inteiro ao destino (escrever + flush): os blocos do
+// destino continuam com as mesmas fronteiras de cap, então compressão e
+// anel veem a mesma sequência que sem o cronômetro.
+static int descarregar_cronometrado(Saida* s) {
+	CronometroSaida* c = s->ctx;
+	if (s->len == 0) return !s->erro;
+	uint64_t t0 = latencia_agora();
+	saida_escrever(c->destino, s->buf, s->len);
+	if (!saida_flush(c->destino)) s->erro = c->destino->erro ? c->destino->erro : 1;
+	c->ns += latencia_agora() - t0;
+	if (!s->erro) s->total += s->len;
+	s->len = 0;
+	return !s->erro;
+}
+
+static int encerrar_cronometro(Saida* s) {
+	int ok = descarregar_cronometrado(s);
+	free(s->buf);
+	s->buf = NULL;
+	s->cap = 0;
+	s->descarregar = NULL;
+	s->encerrar = NULL;
+	return ok;
+}
+
+int saida_abrir_cronometrada(Saida* s, CronometroSaida* c, Saida* destino, size_t cap) {
+	if (!s || !c || !destino) return 0;
+	if (cap < 64) cap = SAIDA_CAP_PADRAO;
+	s->buf = malloc(cap);
+	if (!s->buf) return 0;
+	c->destino = destino;
+	c->ns = 0;
+	s->fd = destino->fd;
+	s->cap = cap;
+	s->len = 0;
+	s->total = 0;
+	s->erro = 0;
+	s->descarregar = descarregar_cronometrado;
+	s->encerrar = encerrar_cronometro;
+	s->ctx = c;
+	return 1;
+}
@@ -0,0 +1,72 @@
+#ifndef XADREZ_LATENCIA_H
+#define XADREZ_LATENCIA_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "xadrez_saida.h"
+
+// Histograma de latências com baldes logarítmicos (estilo HDR): cada
+// potência de 2 é dividida em LATENCIA_SUB baldes lineares, então o erro
+// relativo de qualquer percentil fica abaixo de 1/LATENCIA_SUB (~3%) de
+// 1 ns a 2^64 ns, com um vetor fixo de contadores. Registrar é um clz, um
+// deslocamento e um incremento: barato o bastante para ficar ligado em
+// produção. Histogramas de threads/processos diferentes se juntam somando
+// os contadores.
+
+#define LATENCIA_SUB_BITS 5
+#define LATENCIA_SUB (1u << LATENCIA_SUB_BITS)
+#define LATENCIA_BALDES ((64 - LATENCIA_SUB_BITS + 1) * LATENCIA_SUB)
+
+typedef struct {
+	uint64_t contagem[LATENCIA_BALDES];
+	uint64_t total;   // amostras registradas
+	uint64_t soma_ns; // para a média
+	uint64_t max_ns;
+} Histograma;
+
+static inline uint64_t latencia_agora(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline unsigned latencia_balde(uint64_t ns) {
+	if (ns < LATENCIA_SUB) return (unsigned)ns;
+	unsigned e = 63u - (unsigned)__builtin_clzll(ns); // e >= LATENCIA_SUB_BITS
+	unsigned desl = e - LATENCIA_SUB_BITS;
+	return (desl + 1) * LATENCIA_SUB + (unsigned)(ns >> desl) - LATENCIA_SUB;
+}
+
+static inline void histograma_registrar(Histograma* h, uint64_t ns) {
+	h->contagem[latencia_balde(ns)]++;
+	h->total++;
+	h->soma_ns += ns;
+	if (ns > h->max_ns) h->max_ns = ns;
+}
+
+void histograma_zerar(Histograma* h);
+void histograma_juntar(Histograma* destino, const Histograma* h);
+
+// Valor do percentil p (0..1): o maior valor do balde onde cai a amostra
+// de ordem ceil(p * total), limitado ao máximo observado; 0 sem amostras.
+uint64_t histograma_percentil(const Histograma* h, double p);
+
+// Uma linha com n, média, p50/p90/p99/p99.9 e máximo (ns) da 'fase'.
+// Texto: "[latência <origem>] fase=... p50=...ns ..."; json: um objeto por
+// linha com os mesmos campos. 'origem' NULL = relatório final.
+void histograma_exportar(FILE* f, const char* origem, const char* fase, const Histograma* h, int json);
+
+// Saída cronometrada: tudo o que passa por s segue para 'destino', e o
+// tempo gasto entregando cada bloco (incluindo o write(2) ou a espera do
+// destino) acumula em 'ns'. Serve para separar a emissão da geração sem
+// mexer nos emissores. saida_fechar(s) não fecha 'destino'.
+typedef struct {
+	Saida* destino;
+	uint64_t ns;
+} CronometroSaida;
+
+int saida_abrir_cronometrada(Saida* s, CronometroSaida* c, Saida* destino, size_t cap);
+
+#endif
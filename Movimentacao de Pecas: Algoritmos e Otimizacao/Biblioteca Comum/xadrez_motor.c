@@ -0,0 +1,116 @@
+#include "xadrez_motor.h"
+
+#include <string.h>
+
+// Expansão dos componentes da X-macro em inicializadores de Vetor.
+#define VET(t, x, y) { (x), (y), (t) },
+#define ORTO(t, n) VET(t, n, 0) VET(t, -(n), 0) VET(t, 0, n) VET(t, 0, -(n))
+#define DIAG(t, n) VET(t, n, n) VET(t, -(n), n) VET(t, n, -(n)) VET(t, -(n), -(n))
+#define OBLIQUO(t, a, b) \
+	VET(t, a, b) VET(t, -(a), b) VET(t, a, -(b)) VET(t, -(a), -(b)) \
+	VET(t, b, a) VET(t, -(b), a) VET(t, b, -(a)) VET(t, -(b), -(a))
+
+const DefPeca MOTOR_DEF[ID_QTD] = {
+#define X(id, chave, nome, comps) \
+	[ID_##id] = { chave, nome, (int)(sizeof((const Vetor[]){ comps }) / sizeof(Vetor)), { comps } },
+	MOTOR_PECAS(X)
+#undef X
+};
+
+int motor_peca_de_chave(const char* chave) {
+	for (int i = 0; i < ID_QTD; i++) {
+		if (!strcmp(chave, MOTOR_DEF[i].chave)) return i;
+	}
+	return -1;
+}
+
+// Um raio: saltos testam só a casa de destino; corridas deslizam até a
+// borda (recorte aritmético) ou o primeiro obstáculo.
+static inline Raio raio_de(const Ocupacao* o, Posicao p, int dx, int dy, TipoMovimento t) {
+	Raio r = { (int8_t)dx, (int8_t)dy, 0 };
+	if (t == MOV_SALTO) {
+		r.passos = geometria_dentro(o->geo, (int64_t)p.x + dx, (int64_t)p.y + dy) &&
+		           !ocupacao_contem(o, (int64_t)p.x + dx, (int64_t)p.y + dy);
+	} else {
+		r.passos = ocupacao_deslizar(o, p, dx, dy, INT64_MAX);
+	}
+	return r;
+}
+
+size_t motor_gerar(const DefPeca* def, const Ocupacao* o, Posicao p, Raio* out) {
+	for (int i = 0; i < def->qtd; i++) {
+		const Vetor* v = &def->vet[i];
+		out[i] = raio_de(o, p, v->dx, v->dy, (TipoMovimento)v->tipo);
+	}
+	return (size_t)def->qtd;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ KERNELS ESPECIALIZADOS
+
+ Um por peça de MOTOR_PECAS: os vetores são constantes e o laço é
+ desenrolado, então cada raio vira código reto com o tipo (salto ou
+ corrida) resolvido em tempo de compilação.
+────────────────────────────────────────────────────────────────────────────
+*/
+#define X(id, chave, nome, comps) \
+	static size_t gerar_##id(const Ocupacao* o, Posicao p, Raio* out) { \
+		static const Vetor V[] = { comps }; \
+		_Pragma("GCC unroll 32") \
+		for (size_t i = 0; i < sizeof V / sizeof V[0]; i++) \
+			out[i] = raio_de(o, p, V[i].dx, V[i].dy, (TipoMovimento)V[i].tipo); \
+		return sizeof V / sizeof V[0]; \
+	}
+MOTOR_PECAS(X)
+#undef X
+
+typedef size_t (*KernelPeca)(const Ocupacao* o, Posicao p, Raio* out);
+
+static const KernelPeca KERNELS[ID_QTD] = {
+#define X(id, chave, nome, comps) [ID_##id] = gerar_##id,
+	MOTOR_PECAS(X)
+#undef X
+};
+
+size_t motor_gerar_id(IdPeca id, const Ocupacao* o, Posicao p, Raio* out) {
+	return KERNELS[id](o, p, out);
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ DEFINIÇÃO EM TEMPO DE EXECUÇÃO
+────────────────────────────────────────────────────────────────────────────
+*/
+static void adicionar_vetor(DefPeca* def, int dx, int dy, TipoMovimento t) {
+	for (int i = 0; i < def->qtd; i++) {
+		if (def->vet[i].dx == dx && def->vet[i].dy == dy) return;
+	}
+	def->vet[def->qtd++] = (Vetor){ (int8_t)dx, (int8_t)dy, (uint8_t)t };
+}
+
+int motor_definir(DefPeca* def, const char* nome, const char* spec) {
+	memset(def, 0, sizeof *def);
+	def->chave = nome;
+	def->nome = nome;
+	const char* p = spec;
+	for (;;) {
+		TipoMovimento t;
+		if (*p == 'S') t = MOV_SALTO;
+		else if (*p == 'C') t = MOV_CORRIDA;
+		else return 0;
+		if (p[1] != '(' || p[2] < '0' || p[2] > '7' || p[3] != ',' ||
+		    p[4] < '0' || p[4] > '7' || p[5] != ')') return 0;
+		int a = p[2] - '0', b = p[4] - '0';
+		if (a == 0 && b == 0) return 0;
+		if (def->qtd + 8 > MOTOR_MAX_VETORES) return 0;
+		for (int s = 0; s < 4; s++) {
+			int sa = (s & 1) ? -a : a, sb = (s & 2) ? -b : b;
+			adicionar_vetor(def, sa, sb, t);
+			adicionar_vetor(def, sb, sa, t);
+		}
+		p += 6;
+		if (*p == '\0') return 1;
+		if (*p++ != '+') return 0;
+	}
+}
@@ -0,0 +1,91 @@
+#ifndef XADREZ_MOTOR_H
+#define XADREZ_MOTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xadrez_geometria.h"
+
+// Motor genérico de movimento: toda peça é uma lista de componentes
+// (a, b) simétricos, cada um SALTO (leaper: vai direto ao destino) ou
+// CORRIDA (rider: repete o passo até a borda ou um obstáculo).
+//   Cavalo = SALTO(1, 2); Torre = CORRIDA(1, 0); Rainha = Torre + Bispo...
+// As peças comuns são listadas uma única vez em MOTOR_PECAS (X-macro), que
+// gera a tabela de definições e um kernel especializado por peça, com os
+// vetores constantes em tempo de compilação. Peças feéricas definidas em
+// tempo de execução ("S(1,3)+C(1,1)") passam pelo caminho genérico.
+
+typedef enum {
+	MOV_SALTO,
+	MOV_CORRIDA
+} TipoMovimento;
+
+// Componentes da X-macro: ORTO(t, n) = (n, 0) nas 4 direções ortogonais,
+// DIAG(t, n) = (n, n) nas 4 diagonais, OBLIQUO(t, a, b) = (a, b) nas 8
+// combinações de sinal e troca de eixos (a != b, ambos > 0).
+#define MOTOR_PECAS(X) \
+	X(REI,        "rei",        "Rei",        ORTO(MOV_SALTO, 1) DIAG(MOV_SALTO, 1)) \
+	X(TORRE,      "torre",      "Torre",      ORTO(MOV_CORRIDA, 1)) \
+	X(BISPO,      "bispo",      "Bispo",      DIAG(MOV_CORRIDA, 1)) \
+	X(RAINHA,     "rainha",     "Rainha",     ORTO(MOV_CORRIDA, 1) DIAG(MOV_CORRIDA, 1)) \
+	X(CAVALO,     "cavalo",     "Cavalo",     OBLIQUO(MOV_SALTO, 1, 2)) \
+	X(ARCEBISPO,  "arcebispo",  "Arcebispo",  DIAG(MOV_CORRIDA, 1) OBLIQUO(MOV_SALTO, 1, 2)) \
+	X(CHANCELER,  "chanceler",  "Chanceler",  ORTO(MOV_CORRIDA, 1) OBLIQUO(MOV_SALTO, 1, 2)) \
+	X(CAMELO,     "camelo",     "Camelo",     OBLIQUO(MOV_SALTO, 1, 3)) \
+	X(ZEBRA,      "zebra",      "Zebra",      OBLIQUO(MOV_SALTO, 2, 3)) \
+	X(NOTURNO,    "noturno",    "Cavaleiro Noturno", OBLIQUO(MOV_CORRIDA, 1, 2))
+
+typedef enum {
+#define X(id, chave, nome, comps) ID_##id,
+	MOTOR_PECAS(X)
+#undef X
+	ID_QTD
+} IdPeca;
+
+#define MOTOR_MAX_VETORES 32
+
+typedef struct {
+	int8_t dx;
+	int8_t dy;
+	uint8_t tipo;   // TipoMovimento
+} Vetor;
+
+typedef struct {
+	const char* chave;
+	const char* nome;
+	int qtd;                          // vetores distintos
+	Vetor vet[MOTOR_MAX_VETORES];
+} DefPeca;
+
+// Resultado de uma geração: um raio por vetor, com quantos passos são
+// possíveis (0 ou 1 para saltos). O tamanho não depende do tabuleiro; os
+// destinos são p + k * (dx, dy) para k = 1..passos.
+typedef struct {
+	int8_t dx;
+	int8_t dy;
+	int64_t passos;
+} Raio;
+
+extern const DefPeca MOTOR_DEF[ID_QTD];
+
+// "cavalo" -> ID_CAVALO; -1 se desconhecido.
+int motor_peca_de_chave(const char* chave);
+
+// Componentes separados por '+': S(a,b) = salto, C(a,b) = corrida, com
+// 0 <= a, b <= 7 e (a, b) != (0, 0). Retorna 0 se a definição é inválida.
+int motor_definir(DefPeca* def, const char* nome, const char* spec);
+
+// Caminho genérico: percorre a tabela de vetores da definição.
+size_t motor_gerar(const DefPeca* def, const Ocupacao* o, Posicao p, Raio* out);
+
+// Caminho especializado: kernel gerado pela X-macro para a peça 'id'.
+size_t motor_gerar_id(IdPeca id, const Ocupacao* o, Posicao p, Raio* out);
+
+// Total de destinos em uma geração.
+static inline int64_t motor_destinos(const Raio* raios, size_t n) {
+	int64_t total = 0;
+	for (size_t i = 0; i < n; i++) total += raios[i].passos;
+	return total;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef XADREZ_POSICAO_H
+#define XADREZ_POSICAO_H
+
+#include <stdint.h>
+
+#include "xadrez_bitboard.h"
+
+// Posição de xadrez completa: um bitboard por cor e tipo de peça, mais a
+// visão por casa (mailbox) para consultas "o que há em e4?" em O(1).
+
+typedef enum {
+	COR_BRANCA,
+	COR_PRETA
+} Cor;
+
+typedef enum {
+	TP_PEAO,
+	TP_CAVALO,
+	TP_BISPO,
+	TP_TORRE,
+	TP_RAINHA,
+	TP_REI,
+	TP_QTD
+} TipoPeca;
+
+// Conteúdo de uma casa: cor * TP_QTD + tipo, ou CASA_VAZIA.
+#define CASA_VAZIA 0xFF
+#define PECA_COD(cor, tipo) ((uint8_t)((cor) * TP_QTD + (tipo)))
+#define COD_COR(cod) ((Cor)((cod) / TP_QTD))
+#define COD_TIPO(cod) ((TipoPeca)((cod) % TP_QTD))
+
+// Direitos de roque
+#define ROQUE_K 1   // branco, lado do rei
+#define ROQUE_Q 2   // branco, lado da dama
+#define ROQUE_k 4   // preto, lado do rei
+#define ROQUE_q 8   // preto, lado da dama
+
+#define SEM_EN_PASSANT (-1)
+
+typedef struct {
+	Bitboard pecas[2][TP_QTD];
+	Bitboard cor[2];
+	uint8_t casa[64];
+	uint8_t lado;          // Cor que joga
+	uint8_t roques;        // ROQUE_*
+	int8_t en_passant;     // casa alvo ou SEM_EN_PASSANT
+	uint16_t meio_lance;   // lances desde a última captura/peão
+	uint32_t lance;        // número do lance (começa em 1)
+} Tabuleiro;
+
+static inline void tabuleiro_limpar(Tabuleiro* t) {
+	for (int c = 0; c < 2; c++) {
+		for (int p = 0; p < TP_QTD; p++) t->pecas[c][p] = 0;
+		t->cor[c] = 0;
+	}
+	for (int i = 0; i < 64; i++) t->casa[i] = CASA_VAZIA;
+	t->lado = COR_BRANCA;
+	t->roques = 0;
+	t->en_passant = SEM_EN_PASSANT;
+	t->meio_lance = 0;
+	t->lance = 1;
+}
+
+static inline void tabuleiro_por(Tabuleiro* t, int casa, uint8_t cod) {
+	Bitboard b = BB_CASA(casa);
+	t->pecas[COD_COR(cod)][COD_TIPO(cod)] |= b;
+	t->cor[COD_COR(cod)] |= b;
+	t->casa[casa] = cod;
+}
+
+static inline void tabuleiro_tirar(Tabuleiro* t, int casa) {
+	uint8_t cod = t->casa[casa];
+	Bitboard b = BB_CASA(casa);
+	t->pecas[COD_COR(cod)][COD_TIPO(cod)] &= ~b;
+	t->cor[COD_COR(cod)] &= ~b;
+	t->casa[casa] = CASA_VAZIA;
+}
+
+static inline Bitboard tabuleiro_ocupadas(const Tabuleiro* t) {
+	return t->cor[COR_BRANCA] | t->cor[COR_PRETA];
+}
+
+#endif
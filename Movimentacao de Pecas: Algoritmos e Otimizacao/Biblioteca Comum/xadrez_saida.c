@@ -0,0 +1,132 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "xadrez_saida.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+int saida_abrir(Saida* s, int fd, size_t cap) {
+	if (!s) return 0;
+	if (cap < 64) cap = SAIDA_CAP_PADRAO;
+	s->buf = malloc(cap);
+	if (!s->buf) return 0;
+	s->fd = fd;
+	s->cap = cap;
+	s->len = 0;
+	s->total = 0;
+	s->erro = 0;
+	s->descarregar = NULL;
+	s->encerrar = NULL;
+	s->ctx = NULL;
+	return 1;
+}
+
+int saida_escrever_tudo(int fd, const void* dados, size_t n) {
+	const char* p = dados;
+	while (n > 0) {
+		ssize_t w = write(fd, p, n);
+		if (w < 0) {
+			if (errno == EINTR) continue;
+			return 0;
+		}
+		p += w;
+		n -= (size_t)w;
+	}
+	return 1;
+}
+
+int saida_flush(Saida* s) {
+	if (s->descarregar) return s->descarregar(s);
+	if (s->len == 0) return !s->erro;
+	if (!s->erro && !saida_escrever_tudo(s->fd, s->buf, s->len)) s->erro = errno ? errno : EIO;
+	if (!s->erro) s->total += s->len;
+	s->len = 0;
+	return !s->erro;
+}
+
+void saida_escrever_lento(Saida* s, const void* p, size_t n) {
+	const char* c = p;
+	saida_flush(s);
+	if (s->descarregar) {
+		// Destino trocado: o bloco passa pelo buffer em pedaços de cap,
+		// mantendo a ordem com o que já foi entregue.
+		while (n > s->cap) {
+			memcpy(s->buf, c, s->cap);
+			s->len = s->cap;
+			c += s->cap;
+			n -= s->cap;
+			saida_flush(s);
+		}
+	} else if (n >= s->cap) {
+		// Bloco maior que o buffer: vai direto ao destino, sem cópia.
+		if (!s->erro && !saida_escrever_tudo(s->fd, c, n)) s->erro = errno ? errno : EIO;
+		if (!s->erro) s->total += n;
+		return;
+	}
+	memcpy(s->buf, c, n);
+	s->len = n;
+}
+
+int saida_fechar(Saida* s) {
+	if (s->encerrar) return s->encerrar(s);
+	int ok = saida_flush(s);
+	free(s->buf);
+	s->buf = NULL;
+	s->cap = 0;
+	return ok;
+}
+
+static const char DIGITOS_PARES[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const uint64_t POTENCIAS_10[20] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+	10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+	100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+	100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+	100000000000000000ULL, 1000000000000000000ULL,
+	10000000000000000000ULL
+};
+
+// Número de dígitos decimais: log10 aproximado pelo número de bits
+// (bits * 1233 / 4096) e correção por uma única comparação na tabela.
+static inline unsigned contar_digitos(uint64_t v) {
+	unsigned bits = 64u - (unsigned)__builtin_clzll(v | 1);
+	unsigned d = (bits * 1233u) >> 12;
+	d += (v >= POTENCIAS_10[d]);
+	return d ? d : 1; // zero ocupa um dígito
+}
+
+size_t formatar_u64(char* dst, uint64_t v) {
+	unsigned n = contar_digitos(v);
+	char* p = dst + n;
+	while (v >= 100) {
+		unsigned r = (unsigned)(v % 100) * 2;
+		v /= 100;
+		p -= 2;
+		memcpy(p, DIGITOS_PARES + r, 2);
+	}
+	if (v >= 10) {
+		p -= 2;
+		memcpy(p, DIGITOS_PARES + v * 2, 2);
+	} else {
+		*--p = (char)('0' + v);
+	}
+	return n;
+}
+
+size_t formatar_i64(char* dst, int64_t v) {
+	if (v >= 0) return formatar_u64(dst, (uint64_t)v);
+	dst[0] = '-';
+	return 1 + formatar_u64(dst + 1, 0 - (uint64_t)v);
+}
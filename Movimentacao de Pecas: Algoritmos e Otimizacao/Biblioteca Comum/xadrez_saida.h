@@ -0,0 +1,74 @@
+#ifndef XADREZ_SAIDA_H
+#define XADREZ_SAIDA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Escritor bufferizado compartilhado: acumula bytes em um buffer fixo e
+// descarrega direto no descritor (write(2)) quando ele enche.
+// Substitui printf/puts nos caminhos de alta vazão.
+// O destino é trocável: com os ganchos 'descarregar'/'encerrar' preenchidos
+// (ver xadrez_anel.h), o buffer cheio é entregue a outro consumidor em vez
+// de ir direto ao write(2); as funções inline abaixo não mudam.
+
+#define SAIDA_CAP_PADRAO (1 << 16) // 64 KiB
+
+typedef struct Saida Saida;
+
+struct Saida {
+	int fd;          // destino (1 = stdout)
+	char* buf;       // buffer de acumulação
+	size_t cap;      // capacidade do buffer
+	size_t len;      // bytes pendentes
+	uint64_t total;  // bytes entregues ao destino (após flush)
+	int erro;        // != 0 após falha de escrita
+	int (*descarregar)(Saida* s); // NULL = write(2) direto no fd
+	int (*encerrar)(Saida* s);    // NULL = flush + free(buf)
+	void* ctx;                    // estado do destino trocado
+};
+
+int saida_abrir(Saida* s, int fd, size_t cap);
+int saida_flush(Saida* s);
+int saida_fechar(Saida* s); // flush + libera o buffer
+void saida_escrever_lento(Saida* s, const void* p, size_t n);
+// write(2) de todos os n bytes, repetindo em escritas parciais e EINTR;
+// retorna 0 com errno da falha. Também usado pelo consumidor do anel.
+int saida_escrever_tudo(int fd, const void* p, size_t n);
+
+static inline void saida_escrever(Saida* s, const void* p, size_t n) {
+	if (n <= s->cap - s->len) {
+		memcpy(s->buf + s->len, p, n);
+		s->len += n;
+		return;
+	}
+	saida_escrever_lento(s, p, n);
+}
+
+static inline void saida_texto(Saida* s, const char* txt) {
+	saida_escrever(s, txt, strlen(txt));
+}
+
+static inline void saida_linha(Saida* s, const char* txt) {
+	saida_texto(s, txt);
+	saida_escrever(s, "\n", 1);
+}
+
+// Garante ao menos n bytes livres e devolve o ponteiro de escrita.
+// Após preencher, chamar saida_avancar(s, usados). n <= cap.
+static inline char* saida_reservar(Saida* s, size_t n) {
+	if (n > s->cap - s->len) saida_flush(s);
+	return s->buf + s->len;
+}
+
+static inline void saida_avancar(Saida* s, size_t n) {
+	s->len += n;
+}
+
+// Formatação de inteiros sem printf: tabela de pares de dígitos
+// ("00".."99") e contagem de dígitos por comparação. Retorna o número de
+// bytes escritos em dst (sem terminador). dst precisa de 20 (u64) ou 21 (i64) bytes.
+size_t formatar_u64(char* dst, uint64_t v);
+size_t formatar_i64(char* dst, int64_t v);
+
+#endif
@@ -0,0 +1,106 @@
+#define _GNU_SOURCE
+
+#include "xadrez_segmentos.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BLOCO_JUNCAO (1 << 20)
+
+const char* const NOME_JUNCAO[JUNCAO_QTD] = { "copy_file_range", "splice", "cópia" };
+
+int segmento_temporario(void) {
+	const char* dir = getenv("TMPDIR");
+	if (!dir || !*dir) dir = "/tmp";
+	char caminho[4096];
+	size_t n = strlen(dir);
+	if (n + sizeof "/xadrez_segmento_XXXXXX" > sizeof caminho) return -1;
+	memcpy(caminho, dir, n);
+	memcpy(caminho + n, "/xadrez_segmento_XXXXXX", sizeof "/xadrez_segmento_XXXXXX");
+	int fd = mkstemp(caminho);
+	if (fd >= 0) unlink(caminho);
+	return fd;
+}
+
+off_t alinhar_linha(int fd, off_t pos, off_t tamanho) {
+	if (pos <= 0) return 0;
+	char buf[4096];
+	// O byte anterior a pos decide: se for '\n', pos já começa uma linha.
+	for (off_t p = pos - 1; p < tamanho;) {
+		ssize_t r = pread(fd, buf, sizeof buf, p);
+		if (r <= 0) return tamanho;
+		char* nl = memchr(buf, '\n', (size_t)r);
+		if (nl) return p + (nl - buf) + 1;
+		p += r;
+	}
+	return tamanho;
+}
+
+static int copiar(int destino, int origem, off_t tamanho, uint64_t* copiados) {
+	char* buf = malloc(BLOCO_JUNCAO);
+	if (!buf) return 0;
+	off_t pos = (off_t)*copiados;
+	int ok = 1;
+	while (ok && pos < tamanho) {
+		ssize_t r = pread(origem, buf, BLOCO_JUNCAO, pos);
+		if (r < 0 && errno == EINTR) continue;
+		if (r <= 0) {
+			ok = 0;
+			break;
+		}
+		for (ssize_t feito = 0; feito < r;) {
+			ssize_t w = write(destino, buf + feito, (size_t)(r - feito));
+			if (w < 0 && errno == EINTR) continue;
+			if (w <= 0) {
+				ok = 0;
+				break;
+			}
+			feito += w;
+		}
+		pos += r;
+		*copiados = (uint64_t)pos;
+	}
+	free(buf);
+	return ok;
+}
+
+int segmento_anexar(int destino, int origem, JuncaoStats* stats) {
+	struct stat st;
+	if (fstat(origem, &st) != 0) return 0;
+	off_t tamanho = st.st_size;
+	uint64_t feitos[JUNCAO_QTD] = { 0 };
+	uint64_t copiados = 0;
+
+	// 1) copy_file_range: arquivo -> arquivo, dentro do kernel (ou por
+	// reflink, no mesmo sistema de arquivos).
+	off_t pos = 0;
+	while ((off_t)copiados < tamanho) {
+		ssize_t r = copy_file_range(origem, &pos, destino, NULL, (size_t)(tamanho - pos), 0);
+		if (r < 0 && errno == EINTR) continue;
+		if (r <= 0) break;
+		copiados += (uint64_t)r;
+		feitos[JUNCAO_COPY_FILE_RANGE] += (uint64_t)r;
+	}
+	// 2) splice: arquivo -> pipe.
+	while ((off_t)copiados < tamanho) {
+		pos = (off_t)copiados;
+		ssize_t r = splice(origem, &pos, destino, NULL, (size_t)(tamanho - pos), SPLICE_F_MOVE);
+		if (r < 0 && errno == EINTR) continue;
+		if (r <= 0) break;
+		copiados += (uint64_t)r;
+		feitos[JUNCAO_SPLICE] += (uint64_t)r;
+	}
+	// 3) read/write para o que sobrar.
+	uint64_t antes = copiados;
+	int ok = (off_t)copiados >= tamanho || copiar(destino, origem, tamanho, &copiados);
+	feitos[JUNCAO_COPIA] += copiados - antes;
+
+	if (stats) {
+		for (int m = 0; m < JUNCAO_QTD; m++) stats->bytes[m] += feitos[m];
+	}
+	return ok;
+}
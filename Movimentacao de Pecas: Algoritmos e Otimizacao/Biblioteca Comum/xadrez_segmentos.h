@@ -0,0 +1,38 @@
+#ifndef XADREZ_SEGMENTOS_H
+#define XADREZ_SEGMENTOS_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// Segmentos de saída para execução em vários processos: cada processo
+// escreve no seu arquivo temporário e o pai os junta, em ordem, no destino
+// sem passar os dados pelo espaço de usuário (copy_file_range entre
+// arquivos, splice de arquivo para pipe). Quando o kernel recusa os dois
+// (destino com O_APPEND, terminal, sistemas de arquivos diferentes em
+// kernels antigos), a junção cai para read/write com um buffer.
+
+typedef enum {
+	JUNCAO_COPY_FILE_RANGE,
+	JUNCAO_SPLICE,
+	JUNCAO_COPIA,
+	JUNCAO_QTD
+} MetodoJuncao;
+
+extern const char* const NOME_JUNCAO[JUNCAO_QTD];
+
+typedef struct {
+	uint64_t bytes[JUNCAO_QTD]; // bytes juntados por cada método
+} JuncaoStats;
+
+// Arquivo temporário anônimo (já removido do diretório); -1 em erro.
+int segmento_temporario(void);
+
+// Primeira posição >= pos que começa uma linha (logo após um '\n'), ou
+// 'tamanho' se não houver. pos = 0 é sempre início de linha.
+off_t alinhar_linha(int fd, off_t pos, off_t tamanho);
+
+// Anexa o conteúdo inteiro de 'origem' (do byte 0) na posição atual de
+// 'destino'. Retorna 1 em sucesso, 0 em erro de E/S (errno preservado).
+int segmento_anexar(int destino, int origem, JuncaoStats* stats);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef XADREZ_UTIL_H
+#define XADREZ_UTIL_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Utilitários comuns das ferramentas: inteiros da linha de comando,
+// relógio monotônico e o gerador pseudoaleatório das listas e amostras.
+// Só cabeçalho; quem usa clock_gettime define _POSIX_C_SOURCE antes.
+
+// Converte s em [min, max], exigindo que o número termine em 'fim'
+// ('\0' para o argumento inteiro); retorna 0 se inválido.
+static inline int parse_long_ate(const char* s, long min, long max, long* out, char fim) {
+	errno = 0;
+	char* end = NULL;
+	long v = strtol(s, &end, 10);
+	if (errno != 0 || end == s || *end != fim || v < min || v > max) return 0;
+	*out = v;
+	return 1;
+}
+
+static inline int parse_long(const char* s, long min, long max, long* out) {
+	return parse_long_ate(s, min, max, out, '\0');
+}
+
+static inline double agora_seg(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// xorshift64*: estado nunca nulo. rng_de_semente espalha a semente pela
+// razão áurea (ímpar: semente != 0 dá estado != 0).
+typedef struct {
+	uint64_t s;
+} Rng;
+
+static inline Rng rng_de_semente(uint64_t semente) {
+	return (Rng){ semente * 0x9E3779B97F4A7C15ULL };
+}
+
+static inline uint64_t rng_proximo(Rng* r) {
+	r->s ^= r->s >> 12;
+	r->s ^= r->s << 25;
+	r->s ^= r->s >> 27;
+	return r->s * 0x2545F4914F6CDD1DULL;
+}
+
+#endif
@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xadrez_bitboard.h"
+#include "xadrez_saida.h"
+#include "xadrez_util.h"
+
+// Casas alcançáveis em até k movimentos por Torre, Bispo ou Rainha em um
+// tabuleiro 8x8 com obstáculos. Todos os k saem de uma única BFS por
+// conjuntos (bb_alcance): cada iteração expande a fronteira inteira com
+// preenchimento Kogge-Stone, então uma consulta custa no máximo algumas
+// dezenas de operações de 64 bits, não importa quantas casas são alcançadas.
+// Uso: ./alcance_deslizante <torre|bispo|rainha> <casa> [--obstaculos=d4,e5] [--k=K]
+//      ./alcance_deslizante --lote=<arquivo|-> [--k=K] [--stats]
+// Formato do lote: "<peca> <casa> [obstáculos]" por linha; obstáculos como
+// lista "d4,e5,..." ou máscara "0x...". Resposta: "<peca> <casa>" seguido
+// do total acumulado por nível, ou, com --k, "<total> <máscara hex>".
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s <torre|bispo|rainha> <casa> [--obstaculos=d4,e5,...] [--k=K]\n"
+		"     %s --lote=<arquivo|-> [--k=K] [--stats]\n",
+		prog, prog);
+}
+
+static int peca_de_nome(const char* nome, size_t len, Peca* out) {
+	static const Peca DESLIZANTES[] = { PECA_TORRE, PECA_BISPO, PECA_RAINHA };
+	for (size_t i = 0; i < sizeof DESLIZANTES / sizeof DESLIZANTES[0]; i++) {
+		const char* chave = CHAVE_PECA[DESLIZANTES[i]];
+		if (strlen(chave) == len && !strncmp(nome, chave, len)) {
+			*out = DESLIZANTES[i];
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static inline int casa_de_chars(const char* c) {
+	unsigned col = (unsigned)(c[0] - 'a'), lin = (unsigned)(c[1] - '1');
+	return (col < 8 && lin < 8) ? (int)(lin * 8 + col) : -1;
+}
+
+// "d4,e5" ou "0x..." -> máscara de obstáculos; 0 se inválido.
+static int parse_obstaculos(const char* s, size_t len, Bitboard* out) {
+	Bitboard b = 0;
+	if (len > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+		if (len > 18) return 0;
+		for (size_t i = 2; i < len; i++) {
+			char c = s[i];
+			unsigned v;
+			if (c >= '0' && c <= '9') v = (unsigned)(c - '0');
+			else if (c >= 'a' && c <= 'f') v = (unsigned)(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F') v = (unsigned)(c - 'A' + 10);
+			else return 0;
+			b = (b << 4) | v;
+		}
+		*out = b;
+		return 1;
+	}
+	for (size_t i = 0; i < len;) {
+		if (len - i < 2) return 0;
+		int c = casa_de_chars(s + i);
+		if (c < 0) return 0;
+		b |= BB_CASA(c);
+		i += 2;
+		if (i < len && s[i++] != ',') return 0;
+	}
+	*out = b;
+	return 1;
+}
+
+static size_t formatar_hex(char* dst, Bitboard b) {
+	static const char DIGITOS[] = "0123456789abcdef";
+	dst[0] = '0';
+	dst[1] = 'x';
+	for (int i = 0; i < 16; i++) dst[2 + i] = DIGITOS[(b >> (60 - 4 * i)) & 0xF];
+	return 18;
+}
+
+// Processa uma linha do lote; retorna 1 se válida, 0 se inválida e -1 se
+// em branco.
+static int responder_linha(Saida* s, char* linha, long k) {
+	char* campos[3];
+	size_t tam[3];
+	int n = 0;
+	char* p = linha;
+	for (;;) {
+		while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+		if (!*p) break;
+		if (n == 3) return 0;
+		campos[n] = p;
+		while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+		tam[n] = (size_t)(p - campos[n]);
+		n++;
+	}
+	if (n == 0) return -1;
+	Peca peca;
+	Bitboard obst = 0;
+	if (n < 2 || !peca_de_nome(campos[0], tam[0], &peca) || tam[1] != 2) return 0;
+	int origem = casa_de_chars(campos[1]);
+	if (origem < 0) return 0;
+	if (n == 3 && !parse_obstaculos(campos[2], tam[2], &obst)) return 0;
+	if (obst & BB_CASA(origem)) return 0;
+
+	Bitboard niveis[64];
+	int qtd = bb_alcance(peca, origem, obst, niveis);
+
+	char* w = saida_reservar(s, 16 + 64 * 4);
+	size_t len = 0;
+	memcpy(w, campos[0], tam[0]);
+	len += tam[0];
+	w[len++] = ' ';
+	w[len++] = campos[1][0];
+	w[len++] = campos[1][1];
+	if (k > 0) {
+		Bitboard alvo = qtd == 0 ? 0 : niveis[(k < qtd ? k : qtd) - 1];
+		w[len++] = ' ';
+		len += formatar_u64(w + len, (uint64_t)__builtin_popcountll(alvo));
+		w[len++] = ' ';
+		len += formatar_hex(w + len, alvo);
+	} else {
+		for (int i = 0; i < qtd; i++) {
+			w[len++] = ' ';
+			len += formatar_u64(w + len, (uint64_t)__builtin_popcountll(niveis[i]));
+		}
+	}
+	w[len++] = '\n';
+	saida_avancar(s, len);
+	return 1;
+}
+
+static int rodar_lote(const char* caminho, long k, int stats) {
+	FILE* in = strcmp(caminho, "-") ? fopen(caminho, "r") : stdin;
+	if (!in) {
+		perror(caminho);
+		return 1;
+	}
+	Saida out;
+	if (!saida_abrir(&out, 1, SAIDA_CAP_PADRAO)) {
+		fprintf(stderr, "Erro: sem memória.\n");
+		if (in != stdin) fclose(in);
+		return 1;
+	}
+	char* linha = NULL;
+	size_t cap = 0;
+	uint64_t n_linha = 0, consultas = 0, erros = 0;
+	double t0 = agora_seg();
+	while (getline(&linha, &cap, in) != -1) {
+		n_linha++;
+		int r = responder_linha(&out, linha, k);
+		if (r > 0) {
+			consultas++;
+		} else if (r == 0 && ++erros <= 10) {
+			fprintf(stderr, "Linha %llu inválida\n", (unsigned long long)n_linha);
+		}
+	}
+	int ok = saida_fechar(&out);
+	double dt = agora_seg() - t0;
+	free(linha);
+	if (in != stdin) fclose(in);
+	if (dt <= 0) dt = 1e-9;
+	if (stats) {
+		fprintf(stderr, "[stats] consultas=%llu erros=%llu tempo=%.3fs consultas/s=%.0f us/consulta=%.3f\n",
+				(unsigned long long)consultas, (unsigned long long)erros, dt,
+				(double)consultas / dt, consultas ? dt * 1e6 / (double)consultas : 0.0);
+	}
+	return ok && erros == 0 ? 0 : 1;
+}
+
+// Mapa com o número mínimo de movimentos até cada casa.
+static void mostrar_mapa(Peca p, int origem, Bitboard obst, const Bitboard* niveis, int qtd) {
+	for (int lin = 7; lin >= 0; lin--) {
+		printf("%d ", lin + 1);
+		for (int col = 0; col < 8; col++) {
+			int c = lin * 8 + col;
+			char simbolo = '.';
+			if (c == origem) simbolo = NOME_PECA[p][0];
+			else if (obst & BB_CASA(c)) simbolo = '#';
+			else {
+				for (int i = 0; i < qtd; i++) {
+					if (niveis[i] & BB_CASA(c)) {
+						simbolo = (char)(i < 9 ? '1' + i : '+');
+						break;
+					}
+				}
+			}
+			printf(" %c", simbolo);
+		}
+		printf("\n");
+	}
+	printf("   a b c d e f g h\n");
+}
+
+int main(int argc, char** argv) {
+	const char* lote = NULL;
+	const char* args[2];
+	int nargs = 0, stats = 0;
+	long k = 0;
+	Bitboard obst = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--lote=", 7)) {
+			lote = a + 7;
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (!strncmp(a, "--k=", 4) && parse_long(a + 4, 1, 64, &k)) {
+		} else if (!strncmp(a, "--obstaculos=", 13) && parse_obstaculos(a + 13, strlen(a + 13), &obst)) {
+		} else if (a[0] != '-' && nargs < 2) {
+			args[nargs++] = a;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (lote) return rodar_lote(lote, k, stats);
+
+	Peca peca;
+	int origem = -1;
+	if (nargs != 2 || !peca_de_nome(args[0], strlen(args[0]), &peca) ||
+	    strlen(args[1]) != 2 || (origem = casa_de_chars(args[1])) < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+	if (obst & BB_CASA(origem)) {
+		fprintf(stderr, "Erro: a casa de origem %s tem um obstáculo.\n", args[1]);
+		return 1;
+	}
+
+	Bitboard niveis[64];
+	int qtd = bb_alcance(peca, origem, obst, niveis);
+	printf("%s em %s, %d obstáculo(s)\n\n", NOME_PECA[peca], args[1], __builtin_popcountll(obst));
+	mostrar_mapa(peca, origem, obst, niveis, qtd);
+	printf("\n");
+	for (int i = 0; i < qtd; i++) {
+		if (k > 0 && i + 1 != k) continue;
+		printf("Até %d movimento(s): %d casa(s)\n", i + 1, __builtin_popcountll(niveis[i]));
+	}
+	if (k > qtd) printf("Até %ld movimento(s): %d casa(s)\n", k, qtd ? __builtin_popcountll(niveis[qtd - 1]) : 0);
+	return 0;
+}
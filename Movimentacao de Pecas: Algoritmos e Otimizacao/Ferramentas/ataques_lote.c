@@ -0,0 +1,204 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "xadrez_ataques_lote.h"
+#include "xadrez_fen.h"
+#include "xadrez_hash.h"
+#include "xadrez_util.h"
+
+// Ataques de cavalos e deslizantes para um arquivo inteiro de posições FEN
+// (uma por linha), guardadas num LoteTabuleiros (estrutura de vetores) e
+// processadas 4 (AVX2) ou 8 (AVX-512) por instrução. A implementação é
+// escolhida pela CPU, ou forçada com --impl; o resultado é sempre
+// conferido com a referência escalar, tabuleiro a tabuleiro.
+// Uso: ./ataques_lote <arquivo> [--impl=auto|escalar|avx2|avx512] [--lado=brancas|pretas]
+//                     [--repeticoes=R] [--bench] [--stats]
+// --bench mede todas as implementações disponíveis (tabuleiros/s e ganho
+// sobre a escalar, que é o caminho de um tabuleiro por vez).
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s <arquivo> [--impl=auto|escalar|avx2|avx512] [--lado=brancas|pretas]\n"
+		"       [--repeticoes=R] [--bench] [--stats]\n",
+		prog);
+}
+
+// Lê as posições do arquivo para o lote; retorna 0 em erro (já reportado).
+static int carregar(const char* caminho, Cor lado, LoteTabuleiros* l) {
+	int fd = open(caminho, O_RDONLY);
+	if (fd < 0) {
+		perror(caminho);
+		return 0;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		perror(caminho);
+		close(fd);
+		return 0;
+	}
+	size_t tam = (size_t)st.st_size;
+	const char* dados = NULL;
+	if (tam > 0) {
+		dados = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (dados == MAP_FAILED) {
+			perror("mmap");
+			close(fd);
+			return 0;
+		}
+		madvise((void*)dados, tam, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	int ok = 1;
+	uint64_t linha = 0;
+	Tabuleiro t;
+	for (const char* p = dados; ok && p < dados + tam;) {
+		const char* nl = memchr(p, '\n', (size_t)(dados + tam - p));
+		const char* fim_linha = nl ? nl : dados + tam;
+		linha++;
+		const char* q = p;
+		while (q < fim_linha && (*q == ' ' || *q == '\t' || *q == '\r')) q++;
+		if (q < fim_linha) {
+			FenErro e = fen_ler(&t, p, fim_linha);
+			if (e != FEN_OK) {
+				fprintf(stderr, "Linha %llu: %s\n", (unsigned long long)linha, fen_erro_msg(e));
+				ok = 0;
+			} else if (!lote_adicionar(l, &t, lado)) {
+				fprintf(stderr, "Erro: sem memória para o lote.\n");
+				ok = 0;
+			}
+		}
+		p = fim_linha + 1;
+	}
+	if (dados) munmap((void*)dados, tam);
+	return ok;
+}
+
+// Roda 'impl' 'repeticoes' vezes; retorna os segundos da melhor rodada.
+static double medir(LoteTabuleiros* l, ImplAtaques impl, long repeticoes) {
+	double melhor = 0;
+	for (long r = 0; r < repeticoes; r++) {
+		double t0 = agora_seg();
+		ataques_lote(l, impl);
+		double dt = agora_seg() - t0;
+		if (r == 0 || dt < melhor) melhor = dt;
+	}
+	return melhor > 0 ? melhor : 1e-9;
+}
+
+// Confere l->ataques contra a referência; retorna o número de divergências.
+static size_t conferir(LoteTabuleiros* l, ImplAtaques impl, const Bitboard* referencia) {
+	size_t divergencias = 0;
+	for (size_t i = 0; i < l->n; i++) {
+		if (l->ataques[i] == referencia[i]) continue;
+		if (++divergencias <= 5) {
+			fprintf(stderr, "Divergência no tabuleiro %zu: escalar=%016llx %s=%016llx\n", i + 1,
+				(unsigned long long)referencia[i], CHAVE_ATAQUES[impl], (unsigned long long)l->ataques[i]);
+		}
+	}
+	return divergencias;
+}
+
+int main(int argc, char** argv) {
+	const char* caminho = NULL;
+	int impl = -1, bench = 0, stats = 0;
+	Cor lado = COR_BRANCA;
+	long repeticoes = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strcmp(a, "--impl=auto")) {
+			impl = -1;
+		} else if (!strncmp(a, "--impl=", 7) && (impl = ataques_de_chave(a + 7)) >= 0) {
+		} else if (!strcmp(a, "--lado=brancas")) {
+			lado = COR_BRANCA;
+		} else if (!strcmp(a, "--lado=pretas")) {
+			lado = COR_PRETA;
+		} else if (!strncmp(a, "--repeticoes=", 13) && parse_long(a + 13, 1, 1000000, &repeticoes)) {
+		} else if (!strcmp(a, "--bench")) {
+			bench = 1;
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (a[0] != '-' && !caminho) {
+			caminho = a;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (!caminho) {
+		usage(argv[0]);
+		return 1;
+	}
+	if (impl < 0) impl = ataques_melhor();
+	if (!ataques_disponivel((ImplAtaques)impl)) {
+		fprintf(stderr, "Erro: implementação '%s' não disponível nesta CPU.\n", CHAVE_ATAQUES[impl]);
+		return 1;
+	}
+
+	LoteTabuleiros l;
+	if (!lote_iniciar(&l, 1024)) {
+		fprintf(stderr, "Erro: sem memória para o lote.\n");
+		return 1;
+	}
+	if (!carregar(caminho, lado, &l)) {
+		lote_liberar(&l);
+		return 1;
+	}
+
+	// Referência escalar, guardada à parte para conferir as outras.
+	Bitboard* referencia = malloc((l.n ? l.n : 1) * sizeof(Bitboard));
+	if (!referencia) {
+		fprintf(stderr, "Erro: sem memória para o lote.\n");
+		lote_liberar(&l);
+		return 1;
+	}
+	double t_escalar = medir(&l, ATAQUES_ESCALAR, bench ? repeticoes : 1);
+	memcpy(referencia, l.ataques, l.n * sizeof(Bitboard));
+
+	int rc = 0;
+	if (bench) {
+		printf("Tabuleiros: %zu (%ld repetições, melhor rodada)\n", l.n, repeticoes);
+		for (int k = 0; k < ATAQUES_QTD; k++) {
+			if (!ataques_disponivel((ImplAtaques)k)) {
+				printf("  %-8s indisponível nesta CPU\n", CHAVE_ATAQUES[k]);
+				continue;
+			}
+			double dt = k == ATAQUES_ESCALAR ? t_escalar : medir(&l, (ImplAtaques)k, repeticoes);
+			size_t div = conferir(&l, (ImplAtaques)k, referencia);
+			printf("  %-8s %d por instrução: %12.0f tabuleiros/s (%.2fx) conferência: %s\n", CHAVE_ATAQUES[k],
+				LARGURA_ATAQUES[k], (double)l.n / dt, t_escalar / dt, div ? "DIVERGENTE" : "ok");
+			if (div) rc = 1;
+		}
+	} else {
+		double dt = medir(&l, (ImplAtaques)impl, repeticoes);
+		size_t div = conferir(&l, (ImplAtaques)impl, referencia);
+		uint64_t casas = 0;
+		for (size_t i = 0; i < l.n; i++) casas += (uint64_t)__builtin_popcountll(l.ataques[i]);
+		printf("Tabuleiros: %zu\n", l.n);
+		printf("Implementação: %s (%d por instrução)\n", CHAVE_ATAQUES[impl], LARGURA_ATAQUES[impl]);
+		printf("Casas atacadas: %llu\n", (unsigned long long)casas);
+		printf("Checksum: %016llx\n", (unsigned long long)hash64(l.ataques, l.n * sizeof(Bitboard), HASH64_SEMENTE));
+		printf("Conferência com a escalar: %s\n", div ? "DIVERGENTE" : "ok");
+		if (stats) {
+			fprintf(stderr, "[stats] impl=%s repetições=%ld tempo=%.6fs tabuleiros/s=%.0f escalar=%.0f ganho=%.2fx\n",
+				CHAVE_ATAQUES[impl], repeticoes, dt, (double)l.n / dt, (double)l.n / t_escalar, t_escalar / dt);
+		}
+		if (div) rc = 1;
+	}
+	free(referencia);
+	lote_liberar(&l);
+	return rc;
+}
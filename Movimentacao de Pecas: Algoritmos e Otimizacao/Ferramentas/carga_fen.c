@@ -0,0 +1,304 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "xadrez_avaliacao.h"
+#include "xadrez_fen.h"
+#include "xadrez_saida.h"
+#include "xadrez_util.h"
+
+// Carga de conjuntos grandes de posições FEN (uma por linha).
+// O arquivo é mapeado com mmap e dividido em T fatias alinhadas em '\n';
+// cada thread lê suas linhas para um único Tabuleiro reutilizado (nenhuma
+// alocação por linha). Erros saem com o número da linha global, obtido
+// somando as linhas das fatias anteriores depois do join.
+// Com --avaliar, cada posição lida passa também pela avaliação de
+// mobilidade (xadrez_avaliacao.h); as fatias somam os contadores e o
+// resultado não depende do número de threads.
+// Uso: ./carga_fen <arquivo> [--threads=T] [--stats] [--avaliar] [--popcount=software]
+//      ./carga_fen --gerar=N [--semente=S]   (N FENs aleatórias em stdout)
+
+#define MAX_THREADS 64
+#define MAX_ERROS_EXIBIDOS 10
+
+typedef struct {
+	uint64_t linha;   // local à fatia (1-based)
+	FenErro erro;
+} ErroLinha;
+
+typedef struct {
+	const char* ini;
+	const char* fim;
+	uint64_t linhas;
+	uint64_t posicoes;
+	uint64_t erros;
+	uint64_t checksum;
+	ErroLinha primeiros[MAX_ERROS_EXIBIDOS];
+	int qtd_primeiros;
+	FuncaoAvaliacao avaliar; // NULL sem --avaliar
+	uint64_t mobilidade[2][PECA_QTD];
+	uint64_t ataques[2][PECA_QTD];
+	int64_t soma_pontos;
+	uint64_t checksum_avaliacao;
+} Fatia;
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s <arquivo> [--threads=T] [--stats] [--avaliar] [--popcount=software]\n"
+		"     %s --gerar=N [--semente=S]\n",
+		prog, prog);
+}
+
+// Resumo da posição independente da ordem de leitura (somado entre linhas).
+static inline uint64_t resumo(const Tabuleiro* t) {
+	uint64_t h = (uint64_t)t->lado * 0x9E3779B97F4A7C15ULL ^ t->roques ^ ((uint64_t)(uint8_t)t->en_passant << 8);
+	for (int c = 0; c < 2; c++) {
+		for (int p = 0; p < TP_QTD; p++) h = (h ^ t->pecas[c][p]) * 0xFF51AFD7ED558CCDULL;
+	}
+	return h ^ (h >> 33);
+}
+
+static void acumular_avaliacao(Fatia* f, const Tabuleiro* t) {
+	Avaliacao a;
+	f->avaliar(t, &a);
+	for (int c = 0; c < 2; c++) {
+		for (int p = 0; p < PECA_QTD; p++) {
+			f->mobilidade[c][p] += a.mobilidade[c][p];
+			f->ataques[c][p] += a.ataques[c][p];
+		}
+	}
+	f->soma_pontos += a.pontos;
+	uint64_t h = (resumo(t) ^ (uint32_t)a.pontos) * 0x9E3779B97F4A7C15ULL;
+	f->checksum_avaliacao += h ^ (h >> 29);
+}
+
+static void* ler_fatia(void* arg) {
+	Fatia* f = arg;
+	Tabuleiro t;
+	const char* p = f->ini;
+	while (p < f->fim) {
+		const char* nl = memchr(p, '\n', (size_t)(f->fim - p));
+		const char* fim_linha = nl ? nl : f->fim;
+		f->linhas++;
+		const char* q = p;
+		while (q < fim_linha && (*q == ' ' || *q == '\t' || *q == '\r')) q++;
+		if (q < fim_linha) {
+			FenErro e = fen_ler(&t, p, fim_linha);
+			if (e == FEN_OK) {
+				f->posicoes++;
+				f->checksum += resumo(&t);
+				if (f->avaliar) acumular_avaliacao(f, &t);
+			} else {
+				if (f->qtd_primeiros < MAX_ERROS_EXIBIDOS)
+					f->primeiros[f->qtd_primeiros++] = (ErroLinha){ f->linhas, e };
+				f->erros++;
+			}
+		}
+		p = fim_linha + 1;
+	}
+	return NULL;
+}
+
+static int carregar(const char* caminho, int threads, int stats, FuncaoAvaliacao avaliar, const char* popcount) {
+	int fd = open(caminho, O_RDONLY);
+	if (fd < 0) {
+		perror(caminho);
+		return 1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		perror(caminho);
+		close(fd);
+		return 1;
+	}
+	size_t tam = (size_t)st.st_size;
+	const char* dados = NULL;
+	if (tam > 0) {
+		dados = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (dados == MAP_FAILED) {
+			perror("mmap");
+			close(fd);
+			return 1;
+		}
+		madvise((void*)dados, tam, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	Fatia fatias[MAX_THREADS];
+	pthread_t ids[MAX_THREADS];
+	memset(fatias, 0, sizeof fatias);
+	// Fronteiras: cada fatia começa logo após um '\n'.
+	const char* fim = dados + tam;
+	const char* ini = dados;
+	for (int i = 0; i < threads; i++) {
+		const char* corte = i + 1 == threads ? fim : dados + tam / (size_t)threads * (size_t)(i + 1);
+		if (corte < ini) corte = ini;
+		if (corte < fim) {
+			const char* nl = memchr(corte, '\n', (size_t)(fim - corte));
+			corte = nl ? nl + 1 : fim;
+		}
+		fatias[i].ini = ini;
+		fatias[i].fim = corte;
+		fatias[i].avaliar = avaliar;
+		ini = corte;
+	}
+
+	double t0 = agora_seg();
+	int criada[MAX_THREADS];
+	for (int i = 0; i < threads; i++) criada[i] = pthread_create(&ids[i], NULL, ler_fatia, &fatias[i]) == 0;
+	// Uma fatia sem thread é lida pela thread principal: o resultado não muda.
+	for (int i = 0; i < threads; i++) {
+		if (!criada[i]) ler_fatia(&fatias[i]);
+	}
+	for (int i = 0; i < threads; i++) {
+		if (criada[i]) pthread_join(ids[i], NULL);
+	}
+	double dt = agora_seg() - t0;
+	if (dt <= 0) dt = 1e-9;
+
+	uint64_t posicoes = 0, erros = 0, checksum = 0, base = 0;
+	uint64_t mobilidade[2][PECA_QTD] = { { 0 } }, ataques[2][PECA_QTD] = { { 0 } }, checksum_avaliacao = 0;
+	int64_t soma_pontos = 0;
+	int exibidos = 0;
+	for (int i = 0; i < threads; i++) {
+		const Fatia* f = &fatias[i];
+		for (int k = 0; k < f->qtd_primeiros && exibidos < MAX_ERROS_EXIBIDOS; k++, exibidos++) {
+			fprintf(stderr, "Linha %llu: %s\n", (unsigned long long)(base + f->primeiros[k].linha),
+					fen_erro_msg(f->primeiros[k].erro));
+		}
+		posicoes += f->posicoes;
+		erros += f->erros;
+		checksum += f->checksum;
+		base += f->linhas;
+		for (int c = 0; c < 2; c++) {
+			for (int p = 0; p < PECA_QTD; p++) {
+				mobilidade[c][p] += f->mobilidade[c][p];
+				ataques[c][p] += f->ataques[c][p];
+			}
+		}
+		soma_pontos += f->soma_pontos;
+		checksum_avaliacao += f->checksum_avaliacao;
+	}
+	if (erros > MAX_ERROS_EXIBIDOS) fprintf(stderr, "... e mais %llu erro(s)\n", (unsigned long long)(erros - MAX_ERROS_EXIBIDOS));
+
+	printf("Posições: %llu\n", (unsigned long long)posicoes);
+	printf("Erros: %llu\n", (unsigned long long)erros);
+	printf("Checksum: %016llx\n", (unsigned long long)checksum);
+	if (avaliar) {
+		// Somas sobre todas as posições, brancas/pretas.
+		const char* rotulos[2] = { "Mobilidade", "Ataques" };
+		for (int k = 0; k < 2; k++) {
+			printf("%s (brancas/pretas):", rotulos[k]);
+			for (int p = 0; p < PECA_QTD; p++) {
+				const uint64_t (*v)[PECA_QTD] = k ? ataques : mobilidade;
+				printf(" %s=%llu/%llu", CHAVE_PECA[p], (unsigned long long)v[COR_BRANCA][p],
+					(unsigned long long)v[COR_PRETA][p]);
+			}
+			printf("\n");
+		}
+		printf("Pontuação média: %+.2f (brancas - pretas)\n", posicoes ? (double)soma_pontos / (double)posicoes : 0.0);
+		printf("Checksum avaliação: %016llx\n", (unsigned long long)checksum_avaliacao);
+	}
+	if (stats) {
+		fprintf(stderr, "[stats] threads=%d bytes=%zu tempo=%.3fs posições/s=%.0f MB/s=%.1f\n",
+				threads, tam, dt, (double)posicoes / dt, (double)tam / dt / 1e6);
+		if (avaliar) fprintf(stderr, "[stats] avaliação: popcount=%s\n", popcount);
+	}
+	if (dados) munmap((void*)dados, tam);
+	return erros ? 1 : 0;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ GERADOR DE POSIÇÕES ALEATÓRIAS (para testes e benchmarks)
+
+ Dois reis em casas distintas e de 0 a 30 outras peças em casas livres,
+ sem peões na 1ª/8ª fileira. As posições são sintaticamente válidas; a
+ legalidade (rei em xeque etc.) não é verificada.
+────────────────────────────────────────────────────────────────────────────
+*/
+static Rng rng;
+
+static int casa_livre(const Tabuleiro* t) {
+	for (;;) {
+		int c = (int)(rng_proximo(&rng) & 63);
+		if (t->casa[c] == CASA_VAZIA) return c;
+	}
+}
+
+static int gerar(long n) {
+	Saida out;
+	if (!saida_abrir(&out, 1, SAIDA_CAP_PADRAO)) return 1;
+	Tabuleiro t;
+	for (long i = 0; i < n; i++) {
+		tabuleiro_limpar(&t);
+		tabuleiro_por(&t, casa_livre(&t), PECA_COD(COR_BRANCA, TP_REI));
+		tabuleiro_por(&t, casa_livre(&t), PECA_COD(COR_PRETA, TP_REI));
+		int extras = (int)(rng_proximo(&rng) % 31);
+		for (int k = 0; k < extras; k++) {
+			uint64_t r = rng_proximo(&rng);
+			Cor cor = (Cor)(r & 1);
+			TipoPeca tipo = (TipoPeca)((r >> 1) % TP_REI);
+			int c = casa_livre(&t);
+			if (tipo == TP_PEAO && (c < 8 || c >= 56)) continue;
+			tabuleiro_por(&t, c, PECA_COD(cor, tipo));
+		}
+		t.lado = (uint8_t)(rng_proximo(&rng) & 1);
+		t.meio_lance = (uint16_t)(rng_proximo(&rng) % 50);
+		t.lance = 1 + (uint32_t)(rng_proximo(&rng) % 120);
+		char* w = saida_reservar(&out, FEN_MAX);
+		size_t len = fen_escrever(&t, w);
+		w[len++] = '\n';
+		saida_avancar(&out, len);
+	}
+	return saida_fechar(&out) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+	const char* caminho = NULL;
+	long threads = 1, n_gerar = -1, semente = 1;
+	int stats = 0, avaliar = 0, popcount_hw = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--threads=", 10) && parse_long(a + 10, 1, MAX_THREADS, &threads)) {
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (!strcmp(a, "--avaliar")) {
+			avaliar = 1;
+		} else if (!strcmp(a, "--popcount=software")) {
+			popcount_hw = 0;
+		} else if (!strncmp(a, "--gerar=", 8) && parse_long(a + 8, 0, 1000000000L, &n_gerar)) {
+		} else if (!strncmp(a, "--semente=", 10) && parse_long(a + 10, 1, 2000000000L, &semente)) {
+		} else if (a[0] != '-' && !caminho) {
+			caminho = a;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (n_gerar >= 0) {
+		rng = rng_de_semente((uint64_t)semente);
+		return gerar(n_gerar);
+	}
+	if (!caminho) {
+		usage(argv[0]);
+		return 1;
+	}
+	const char* popcount = NULL;
+	FuncaoAvaliacao funcao = avaliar ? avaliacao_escolher(popcount_hw, &popcount) : NULL;
+	return carregar(caminho, (int)threads, stats, funcao, popcount);
+}
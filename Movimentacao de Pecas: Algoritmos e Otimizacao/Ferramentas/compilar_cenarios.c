@@ -0,0 +1,172 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "xadrez_cenarios.h"
+#include "xadrez_util.h"
+
+// Compilador de cenários: a lista em texto ("torre bispo rainha cavaloV
+// cavaloH" por linha, '#' para comentários, o mesmo formato de --lote)
+// vira um arquivo .xcn de registros fixos (xadrez_cenarios.h), que
+// otim_validacoes --cenarios=... mapeia e percorre sem parse.
+// Uso: ./compilar_cenarios <lista|-> <saida.xcn> [--stats]
+//      ./compilar_cenarios --listar <arquivo.xcn>   (de volta para texto, conferindo cada bloco)
+//      ./compilar_cenarios --gerar=N [--max=V] [--semente=S]   (lista aleatória em stdout)
+
+#define MAX_ERROS_EXIBIDOS 10
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s <lista|-> <saida.xcn> [--stats]\n"
+		"     %s --listar <arquivo.xcn>\n"
+		"     %s --gerar=N [--max=V] [--semente=S]\n",
+		prog, prog, prog);
+}
+
+static int compilar(const char* entrada, const char* saida, int stats) {
+	FILE* in = strcmp(entrada, "-") ? fopen(entrada, "r") : stdin;
+	if (!in) {
+		perror(entrada);
+		return 1;
+	}
+	// Grava em <saida>.tmp e só renomeia no sucesso: uma recompilação que
+	// falha não destrói o .xcn anterior.
+	char tmp[4096];
+	if (snprintf(tmp, sizeof tmp, "%s.tmp", saida) >= (int)sizeof tmp) {
+		fprintf(stderr, "Erro: caminho de saída longo demais.\n");
+		if (in != stdin) fclose(in);
+		return 1;
+	}
+	FILE* out = fopen(tmp, "wb");
+	if (!out) {
+		perror(tmp);
+		if (in != stdin) fclose(in);
+		return 1;
+	}
+	double t0 = agora_seg();
+	CenariosEscritor* w = malloc(sizeof *w);
+	int ok = w && cenarios_escritor_abrir(w, out);
+	char* linha = NULL;
+	size_t cap = 0;
+	ssize_t len;
+	uint64_t num = 0, erros = 0;
+	while (ok && (len = getline(&linha, &cap, in)) >= 0) {
+		num++;
+		CenarioRegistro r;
+		int v = cenario_ler_linha(linha, linha + len - (len > 0 && linha[len - 1] == '\n'), LIMITE_PASSOS, &r);
+		if (v > 0) {
+			ok = cenarios_escritor_adicionar(w, &r);
+		} else if (v == 0 && ++erros <= MAX_ERROS_EXIBIDOS) {
+			fprintf(stderr, "Linha %llu inválida\n", (unsigned long long)num);
+		}
+	}
+	free(linha);
+	int leitura = !ferror(in);
+	if (in != stdin) fclose(in);
+	uint64_t n = w ? w->n : 0, blocos = 0;
+	if (w && !cenarios_escritor_fechar(w)) ok = 0;
+	if (w) blocos = w->blocos;
+	free(w);
+	// O cabeçalho foi gravado por último, no início: o tamanho é o do fim.
+	long bytes = fseek(out, 0, SEEK_END) == 0 ? ftell(out) : -1;
+	if (fclose(out) != 0) ok = 0;
+
+	if (erros > MAX_ERROS_EXIBIDOS) fprintf(stderr, "... e mais %llu erro(s)\n", (unsigned long long)(erros - MAX_ERROS_EXIBIDOS));
+	if (!leitura) perror(entrada);
+	if (!ok) fprintf(stderr, "Erro: falha ao gravar '%s'.\n", tmp);
+	if (!ok || !leitura || erros) {
+		unlink(tmp);
+		return 1;
+	}
+	if (rename(tmp, saida) != 0) {
+		fprintf(stderr, "Erro: não foi possível renomear '%s' para '%s' (%s).\n", tmp, saida, strerror(errno));
+		unlink(tmp);
+		return 1;
+	}
+	printf("Cenários: %llu em %llu bloco(s), %ld bytes\n", (unsigned long long)n, (unsigned long long)blocos, bytes);
+	if (stats) {
+		double dt = agora_seg() - t0;
+		if (dt <= 0) dt = 1e-9;
+		fprintf(stderr, "[stats] linhas=%llu tempo=%.3fs cenários/s=%.0f\n", (unsigned long long)num, dt, (double)n / dt);
+	}
+	return 0;
+}
+
+static int listar(const char* caminho) {
+	Cenarios c;
+	if (!cenarios_abrir(&c, caminho)) {
+		fprintf(stderr, "Erro: não foi possível abrir '%s' (%s).\n", caminho, strerror(errno));
+		return 1;
+	}
+	int rc = 0;
+	for (uint64_t b = 0; b < c.blocos; b++) {
+		size_t qtd;
+		const CenarioRegistro* r = cenarios_bloco(&c, b, &qtd);
+		if (!r) {
+			fprintf(stderr, "Erro: bloco %llu corrompido (resumo não confere).\n", (unsigned long long)b);
+			rc = 1;
+			break;
+		}
+		for (size_t i = 0; i < qtd; i++) {
+			printf("%u %u %u %u %u\n", r[i].torre, r[i].bispo, r[i].rainha, r[i].cavalo_v, r[i].cavalo_h);
+		}
+	}
+	cenarios_fechar(&c);
+	if (fflush(stdout) != 0) rc = 1;
+	return rc;
+}
+
+static Rng rng;
+
+static int gerar(long n, long max) {
+	for (long i = 0; i < n; i++) {
+		uint64_t v[5];
+		for (int k = 0; k < 5; k++) v[k] = rng_proximo(&rng) % (uint64_t)(max + 1);
+		printf("%llu %llu %llu %llu %llu\n", (unsigned long long)v[0], (unsigned long long)v[1],
+			(unsigned long long)v[2], (unsigned long long)v[3], (unsigned long long)v[4]);
+	}
+	return fflush(stdout) == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+	const char* pos[2];
+	int npos = 0, stats = 0;
+	const char* listado = NULL;
+	long n_gerar = -1, max = 10, semente = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (!strcmp(a, "--listar") && i + 1 < argc) {
+			listado = argv[++i];
+		} else if (!strncmp(a, "--gerar=", 8) && parse_long(a + 8, 0, 1000000000L, &n_gerar)) {
+		} else if (!strncmp(a, "--max=", 6) && parse_long(a + 6, 0, LIMITE_PASSOS, &max)) {
+		} else if (!strncmp(a, "--semente=", 10) && parse_long(a + 10, 1, 2000000000L, &semente)) {
+		} else if ((a[0] != '-' || !strcmp(a, "-")) && npos < 2) {
+			pos[npos++] = a;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (n_gerar >= 0) {
+		rng = rng_de_semente((uint64_t)semente);
+		return gerar(n_gerar, max);
+	}
+	if (listado) return listar(listado);
+	if (npos != 2) {
+		usage(argv[0]);
+		return 1;
+	}
+	return compilar(pos[0], pos[1], stats);
+}
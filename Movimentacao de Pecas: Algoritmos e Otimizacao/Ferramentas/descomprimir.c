@@ -0,0 +1,136 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "xadrez_compressao.h"
+#include "xadrez_hash.h"
+#include "xadrez_saida.h"
+#include "xadrez_util.h"
+
+// Descompressor do fluxo .xzl gravado por --compress (xadrez_compressao.h).
+// Lê quadro a quadro (funciona em pipe) e descomprime cada bloco direto no
+// buffer da Saida, sem cópia intermediária. Quadro truncado, tamanho fora
+// do limite ou bloco inválido encerram com erro e código 1. Com --digest o
+// texto descomprimido não é escrito: sai só o resumo (xxh64 e bytes), o
+// mesmo que otim_validacoes --digest daria para o fluxo sem compressão.
+// Uso: ./descomprimir [arquivo] [--stats] [--digest]   (sem arquivo: stdin)
+
+static void usage(const char* prog) {
+	fprintf(stderr, "Uso: %s [arquivo.xzl] [--stats] [--digest]   (sem arquivo: lê stdin)\n", prog);
+}
+
+// Lê exatamente n bytes; retorna n, 0 no EOF limpo ou -1 (erro / EOF no meio).
+static long ler_tudo(int fd, void* dst, size_t n) {
+	size_t feito = 0;
+	while (feito < n) {
+		ssize_t r = read(fd, (char*)dst + feito, n - feito);
+		if (r < 0) {
+			if (errno == EINTR) continue;
+			return -1;
+		}
+		if (r == 0) return feito == 0 ? 0 : -1;
+		feito += (size_t)r;
+	}
+	return (long)n;
+}
+
+static inline uint32_t u32_le(const uint8_t* p) {
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+int main(int argc, char** argv) {
+	const char* caminho = NULL;
+	int stats = 0, resumir = 0;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strcmp(argv[i], "--stats")) {
+			stats = 1;
+		} else if (!strcmp(argv[i], "--digest")) {
+			resumir = 1;
+		} else if (!caminho && argv[i][0] != '-') {
+			caminho = argv[i];
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", argv[i]);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	int fd = 0;
+	if (caminho && (fd = open(caminho, O_RDONLY)) < 0) {
+		perror(caminho);
+		return 1;
+	}
+
+	Saida out;
+	DigestSaida digest;
+	uint8_t* comprimido = malloc(lz_limite(LZ_BLOCO_MAX));
+	int aberta = resumir ? saida_abrir_digest(&out, &digest, NULL, SAIDA_CAP_PADRAO)
+	                     : saida_abrir(&out, 1, SAIDA_CAP_PADRAO);
+	if (!comprimido || !aberta) {
+		fprintf(stderr, "Erro: sem memória.\n");
+		return 1;
+	}
+	double t0 = agora_seg();
+	uint64_t lidos = 0, quadros = 0;
+	const char* erro = NULL;
+
+	uint8_t cab[8];
+	if (ler_tudo(fd, cab, 4) != 4 || memcmp(cab, LZ_MAGICO, 4) != 0) erro = "cabeçalho XZL1 ausente";
+	lidos += 4;
+	while (!erro) {
+		if (ler_tudo(fd, cab, 8) != 8) {
+			erro = "fluxo truncado (sem quadro final)";
+			break;
+		}
+		lidos += 8;
+		uint32_t bruto = u32_le(cab), gravado = u32_le(cab + 4);
+		int cru = (gravado & LZ_QUADRO_CRU) != 0;
+		gravado &= ~LZ_QUADRO_CRU;
+		if (bruto == 0) break; // quadro final
+		if (bruto > LZ_BLOCO_MAX || gravado > lz_limite(LZ_BLOCO_MAX) || (cru && gravado != bruto)) {
+			erro = "tamanho de quadro inválido";
+			break;
+		}
+		char* dst = saida_reservar(&out, bruto);
+		if (cru) {
+			if (ler_tudo(fd, dst, bruto) != (long)bruto) erro = "quadro truncado";
+		} else if (ler_tudo(fd, comprimido, gravado) != (long)gravado) {
+			erro = "quadro truncado";
+		} else if (lz_descomprimir(comprimido, gravado, (uint8_t*)dst, bruto) != (long)bruto) {
+			erro = "bloco comprimido inválido";
+		}
+		if (erro) break;
+		saida_avancar(&out, bruto);
+		lidos += gravado;
+		quadros++;
+	}
+
+	int ok = saida_fechar(&out);
+	double dt = agora_seg() - t0;
+	free(comprimido);
+	if (fd != 0) close(fd);
+	if (erro) {
+		fprintf(stderr, "Erro: %s (quadro %llu).\n", erro, (unsigned long long)quadros + 1);
+		return 1;
+	}
+	if (!ok) {
+		fprintf(stderr, "Erro: falha ao escrever a saída.\n");
+		return 1;
+	}
+	if (resumir) printf("%016llx %llu\n", (unsigned long long)hash64_final(&digest.hash), (unsigned long long)out.total);
+	if (stats) {
+		if (dt <= 0) dt = 1e-9;
+		fprintf(stderr, "[stats] quadros=%llu comprimido=%llu bruto=%llu razão=%.1fx tempo=%.6fs MB/s=%.1f\n",
+			(unsigned long long)quadros, (unsigned long long)lidos, (unsigned long long)out.total,
+			lidos ? (double)out.total / (double)lidos : 0.0, dt, (double)out.total / dt / 1e6);
+	}
+	return 0;
+}
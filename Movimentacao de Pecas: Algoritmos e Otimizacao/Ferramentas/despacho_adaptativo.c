@@ -0,0 +1,446 @@
+#define _POSIX_C_SOURCE 200809L
+
+// Despacho adaptativo entre implementações equivalentes de cada peça: os
+// laços e as recursões de xadrez_completo.c (stdio, um fwrite por passo),
+// o emissor da biblioteca sobre Saida (write(2) a cada 64 KiB) e o mesmo
+// emissor sobre o anel com thread consumidora (xadrez_anel.h). Todas
+// produzem as mesmas linhas; qual é mais rápida depende de n e do destino
+// da saída (arquivo, pipe ou dispositivo como terminal e /dev/null).
+//
+// Regras "destino peça n_min implementação": o pedido usa a regra de maior
+// n_min <= n. Elas vêm de uma autocalibração rápida (cada implementação
+// cronometrada em alguns n, escrevendo num destino do mesmo tipo que o
+// stdout) ou de um perfil salvo (--perfil=arquivo: lido se tiver regras
+// para o destino atual, senão calibrado e gravado). Recursão nunca é usada
+// acima da profundidade segura (metade do limite de pilha / 256 B por
+// quadro, ou --profundidade-max): nesse caso o laço equivalente atende.
+// --stats registra em stderr qual implementação atendeu cada pedido.
+// Uso: ./despacho_adaptativo [--perfil=arquivo] [--calibrar] [--profundidade-max=N] [--stats]
+//                            [torre:N] [bispo:N] [rainha:N] [cavalo:V,H] ...
+
+#define XADREZ_COMPLETO_SEM_MAIN
+#include "xadrez_completo.c"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include "xadrez_anel.h"
+#include "xadrez_formatos.h"
+#include "xadrez_saida.h"
+#include "xadrez_util.h"
+
+#define MAX_PEDIDOS 256
+#define MAX_REGRAS 64
+#define LIMITE_PASSOS 100000000L
+#define BYTES_POR_QUADRO_MAX 256   // estimativa conservadora de um quadro recursivo
+#define PROFUNDIDADE_TETO (1L << 20)
+#define CALIBRACAO_SEG 0.002       // tempo mínimo por medida
+
+typedef enum { IMPL_LACO, IMPL_RECURSIVA, IMPL_BUFFERIZADA, IMPL_ANEL, IMPL_QTD } Impl;
+typedef enum { DESTINO_ARQUIVO, DESTINO_PIPE, DESTINO_DISPOSITIVO, DESTINO_QTD } Destino;
+
+static const char* const NOME_IMPL[IMPL_QTD] = { "laco", "recursiva", "bufferizada", "anel" };
+static const char* const NOME_DESTINO[DESTINO_QTD] = { "arquivo", "pipe", "dispositivo" };
+
+// Funções concretas por peça, para o registro em --stats.
+static const char* const FUNCAO_IMPL[PECA_QTD][IMPL_QTD] = {
+	[PECA_TORRE] = { "torre_for", "torre_recursiva", "emitir_passos+Saida", "emitir_passos+anel" },
+	[PECA_BISPO] = { "bispo_while", "bispo_recursivo", "emitir_passos+Saida", "emitir_passos+anel" },
+	[PECA_RAINHA] = { "rainha_dowhile", "rainha_recursiva", "emitir_passos+Saida", "emitir_passos+anel" },
+	[PECA_CAVALO] = { "cavalo_loops_complexos", NULL, "emitir_passos+Saida", "emitir_passos+anel" },
+};
+
+// n da calibração (o cavalo usa V = n - 1, H = 1).
+static const long AMOSTRAS_N[] = { 1, 64, 4096, 262144 };
+#define QTD_AMOSTRAS (sizeof AMOSTRAS_N / sizeof AMOSTRAS_N[0])
+
+typedef struct {
+	Peca peca;
+	long n;       // passos (Cavalo: v + h)
+	long v, h;    // só Cavalo
+} Pedido;
+
+typedef struct {
+	Destino destino;
+	Peca peca;
+	long n_min;
+	Impl impl;
+} Regra;
+
+static Regra regras[MAX_REGRAS];
+static int qtd_regras;
+static long profundidade_segura;
+static Saida saida_buf;
+
+static Destino destino_de(int fd) {
+	struct stat st;
+	if (fstat(fd, &st) != 0) return DESTINO_DISPOSITIVO;
+	if (S_ISREG(st.st_mode)) return DESTINO_ARQUIVO;
+	if (S_ISFIFO(st.st_mode) || S_ISSOCK(st.st_mode)) return DESTINO_PIPE;
+	return DESTINO_DISPOSITIVO;
+}
+
+// Metade da pilha disponível, a no máximo BYTES_POR_QUADRO_MAX por nível.
+static long calcular_profundidade_segura(void) {
+	struct rlimit rl;
+	if (getrlimit(RLIMIT_STACK, &rl) != 0 || rl.rlim_cur == RLIM_INFINITY) return PROFUNDIDADE_TETO;
+	long p = (long)(rl.rlim_cur / 2 / BYTES_POR_QUADRO_MAX);
+	return p < PROFUNDIDADE_TETO ? p : PROFUNDIDADE_TETO;
+}
+
+static int elegivel(Impl impl, const Pedido* p) {
+	if (impl == IMPL_RECURSIVA) return p->peca != PECA_CAVALO && p->n <= profundidade_segura;
+	return 1;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ IMPLEMENTAÇÕES
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static void emitir_pedido(Saida* s, const Pedido* p) {
+	static const Direcao DIRECAO[PECA_QTD] = { DIR_DIREITA, DIR_CIMA_DIREITA, DIR_ESQUERDA, DIR_CIMA };
+	Posicao at = { 0, 0 };
+	uint64_t k = 0;
+	if (p->peca == PECA_CAVALO) {
+		emitir_passos(s, FORMATO_TEXTO, PECA_CAVALO, DIR_CIMA, (int)p->v, &at, &k);
+		emitir_passos(s, FORMATO_TEXTO, PECA_CAVALO, DIR_DIREITA, (int)p->h, &at, &k);
+	} else {
+		emitir_passos(s, FORMATO_TEXTO, p->peca, DIRECAO[p->peca], (int)p->n, &at, &k);
+	}
+}
+
+static void servir(Impl impl, const Pedido* p) {
+	int n = (int)p->n;
+	switch (impl) {
+	case IMPL_LACO:
+		posicionar_peca(INICIO_TORRE);
+		switch (p->peca) {
+		case PECA_TORRE: torre_for(n); break;
+		case PECA_BISPO: bispo_while(n); break;
+		case PECA_RAINHA: rainha_dowhile(n); break;
+		default: cavalo_loops_complexos((int)p->v, (int)p->h); break;
+		}
+		fflush(stdout);
+		break;
+	case IMPL_RECURSIVA:
+		posicionar_peca(INICIO_TORRE);
+		switch (p->peca) {
+		case PECA_TORRE: torre_recursiva(n); break;
+		case PECA_BISPO: bispo_recursivo(n); break;
+		default: rainha_recursiva(n); break;
+		}
+		fflush(stdout);
+		break;
+	case IMPL_ANEL: {
+		fflush(stdout); // cabeçalho do pedido vem do stdio
+		Saida s;
+		AnelSaida anel;
+		if (saida_abrir_anel(&s, &anel, 1, SAIDA_CAP_PADRAO, ANEL_BLOCOS_PADRAO)) {
+			emitir_pedido(&s, p);
+			if (!saida_fechar(&s)) saida_buf.erro = s.erro;
+			break;
+		}
+	}
+		// sem thread: atende pela Saida comum
+		// fallthrough
+	default:
+		fflush(stdout);
+		emitir_pedido(&saida_buf, p);
+		saida_flush(&saida_buf);
+		break;
+	}
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ CALIBRAÇÃO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+// Drena um pipe de calibração (a leitura faz parte do custo real de um pipe).
+static void* drenar(void* arg) {
+	int fd = *(int*)arg;
+	char buf[1 << 16];
+	while (read(fd, buf, sizeof buf) > 0) {
+	}
+	return NULL;
+}
+
+static void adicionar_regra(Destino d, Peca peca, long n_min, Impl impl) {
+	if (qtd_regras >= MAX_REGRAS) return;
+	// Regra vizinha com a mesma implementação é redundante.
+	for (int i = qtd_regras - 1; i >= 0; i--) {
+		if (regras[i].destino == d && regras[i].peca == peca) {
+			if (regras[i].impl == impl) return;
+			break;
+		}
+	}
+	regras[qtd_regras++] = (Regra){ d, peca, n_min, impl };
+}
+
+// Cronometra cada implementação elegível em AMOSTRAS_N com o fd 1 apontando
+// para um destino do mesmo tipo do stdout real, e grava a vencedora de
+// cada amostra como regra.
+static int calibrar(Destino destino) {
+	fflush(stdout);
+	int salvo = dup(1);
+	int alvo = -1, tubo[2] = { -1, -1 };
+	pthread_t dreno;
+	char modelo[] = "/tmp/despacho_calibracaoXXXXXX";
+	if (destino == DESTINO_PIPE) {
+		if (pipe(tubo) != 0 || pthread_create(&dreno, NULL, drenar, &tubo[0]) != 0) return 0;
+		alvo = tubo[1];
+	} else if (destino == DESTINO_ARQUIVO) {
+		alvo = mkstemp(modelo);
+		if (alvo >= 0) unlink(modelo);
+	} else {
+		alvo = open("/dev/null", O_WRONLY);
+	}
+	if (salvo < 0 || alvo < 0 || dup2(alvo, 1) < 0) return 0;
+
+	for (int pc = 0; pc < PECA_QTD; pc++) {
+		for (size_t a = 0; a < QTD_AMOSTRAS; a++) {
+			long n = AMOSTRAS_N[a];
+			Pedido p = { (Peca)pc, n, n - 1, 1 };
+			Impl melhor = IMPL_BUFFERIZADA;
+			double melhor_ns = 0;
+			for (int i = 0; i < IMPL_QTD; i++) {
+				if (!elegivel((Impl)i, &p)) continue;
+				long reps = 0;
+				double t0 = agora_seg(), dt;
+				do {
+					servir((Impl)i, &p);
+					reps++;
+					dt = agora_seg() - t0;
+				} while (dt < CALIBRACAO_SEG);
+				double ns = dt * 1e9 / (double)reps / (double)n;
+				if (melhor_ns == 0 || ns < melhor_ns) {
+					melhor_ns = ns;
+					melhor = (Impl)i;
+				}
+			}
+			adicionar_regra(destino, (Peca)pc, a == 0 ? 0 : n, melhor);
+		}
+	}
+
+	fflush(stdout);
+	dup2(salvo, 1);
+	close(salvo);
+	close(alvo);
+	if (destino == DESTINO_PIPE) {
+		pthread_join(dreno, NULL);
+		close(tubo[0]);
+	}
+	return 1;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ PERFIL
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static int indice_de(const char* nome, const char* const* nomes, int qtd) {
+	for (int i = 0; i < qtd; i++) {
+		if (nomes[i] && !strcmp(nome, nomes[i])) return i;
+	}
+	return -1;
+}
+
+// Lê as regras do perfil; retorna quantas são do destino pedido ou -1 se
+// o arquivo não abre. Linhas inválidas encerram com erro (linha informada).
+static int carregar_perfil(const char* caminho, Destino destino) {
+	FILE* f = fopen(caminho, "r");
+	if (!f) return -1;
+	char linha[256];
+	int num = 0, do_destino = 0;
+	while (fgets(linha, sizeof linha, f)) {
+		num++;
+		if (linha[0] == '#' || linha[0] == '\n') continue;
+		char d[32], pc[32], im[32];
+		long n_min;
+		int id, ip, ii;
+		if (sscanf(linha, "%31s %31s %ld %31s", d, pc, &n_min, im) != 4 ||
+		    (id = indice_de(d, NOME_DESTINO, DESTINO_QTD)) < 0 ||
+		    (ip = indice_de(pc, CHAVE_PECA, PECA_QTD)) < 0 ||
+		    (ii = indice_de(im, NOME_IMPL, IMPL_QTD)) < 0 || n_min < 0 ||
+		    (ip == PECA_CAVALO && ii == IMPL_RECURSIVA)) {
+			fprintf(stderr, "Erro: perfil %s, linha %d inválida.\n", caminho, num);
+			fclose(f);
+			exit(1);
+		}
+		if (qtd_regras < MAX_REGRAS) regras[qtd_regras++] = (Regra){ (Destino)id, (Peca)ip, n_min, (Impl)ii };
+		if (id == (int)destino) do_destino++;
+	}
+	fclose(f);
+	return do_destino;
+}
+
+static int salvar_perfil(const char* caminho) {
+	FILE* f = fopen(caminho, "w");
+	if (!f) return 0;
+	fprintf(f, "# despacho_adaptativo: destino peça n_min implementação\n");
+	fprintf(f, "# (o pedido usa a regra de maior n_min <= n)\n");
+	for (int i = 0; i < qtd_regras; i++) {
+		fprintf(f, "%s %s %ld %s\n", NOME_DESTINO[regras[i].destino], CHAVE_PECA[regras[i].peca],
+			regras[i].n_min, NOME_IMPL[regras[i].impl]);
+	}
+	return fclose(f) == 0;
+}
+
+static void descartar_destino(Destino destino) {
+	int j = 0;
+	for (int i = 0; i < qtd_regras; i++) {
+		if (regras[i].destino != destino) regras[j++] = regras[i];
+	}
+	qtd_regras = j;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ DESPACHO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+// Regra de maior n_min <= n (ou a de menor n_min, se todas forem maiores).
+static const Regra* regra_para(Destino destino, const Pedido* p) {
+	const Regra* melhor = NULL;
+	const Regra* menor = NULL;
+	for (int i = 0; i < qtd_regras; i++) {
+		const Regra* r = &regras[i];
+		if (r->destino != destino || r->peca != p->peca) continue;
+		if (!menor || r->n_min < menor->n_min) menor = r;
+		if (r->n_min <= p->n && (!melhor || r->n_min > melhor->n_min)) melhor = r;
+	}
+	return melhor ? melhor : menor;
+}
+
+// "torre:5", "bispo:5", "rainha:8", "cavalo:2,1".
+static int parse_pedido(const char* s, Pedido* p) {
+	const char* dois = strchr(s, ':');
+	if (!dois) return 0;
+	char nome[16];
+	size_t len = (size_t)(dois - s);
+	if (len == 0 || len >= sizeof nome) return 0;
+	memcpy(nome, s, len);
+	nome[len] = '\0';
+	int pc = indice_de(nome, CHAVE_PECA, PECA_QTD);
+	if (pc < 0) return 0;
+	p->peca = (Peca)pc;
+	p->v = p->h = 0;
+	if (pc == PECA_CAVALO) {
+		const char* virgula = strchr(dois + 1, ',');
+		if (!virgula || !parse_long_ate(dois + 1, 0, LIMITE_PASSOS, &p->v, ',') ||
+		    !parse_long(virgula + 1, 0, LIMITE_PASSOS, &p->h))
+			return 0;
+		p->n = p->v + p->h;
+		return p->n <= LIMITE_PASSOS;
+	}
+	return parse_long(dois + 1, 0, LIMITE_PASSOS, &p->n);
+}
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s [--perfil=arquivo] [--calibrar] [--profundidade-max=N] [--stats]\n"
+		"       [torre:N] [bispo:N] [rainha:N] [cavalo:V,H] ...\n"
+		"Sem pedidos: torre:5 bispo:5 rainha:8 cavalo:2,1\n",
+		prog);
+}
+
+int main(int argc, char** argv) {
+	const char* perfil = NULL;
+	int forcar_calibracao = 0, stats = 0;
+	long prof_max = -1;
+	static Pedido pedidos[MAX_PEDIDOS];
+	int qtd = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--perfil=", 9) && a[9]) {
+			perfil = a + 9;
+		} else if (!strcmp(a, "--calibrar")) {
+			forcar_calibracao = 1;
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (!strncmp(a, "--profundidade-max=", 19) && parse_long(a + 19, 0, PROFUNDIDADE_TETO, &prof_max)) {
+		} else if (qtd < MAX_PEDIDOS && parse_pedido(a, &pedidos[qtd])) {
+			qtd++;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (qtd == 0) {
+		static const char* const PADRAO[] = { "torre:5", "bispo:5", "rainha:8", "cavalo:2,1" };
+		for (int i = 0; i < 4; i++) parse_pedido(PADRAO[i], &pedidos[qtd++]);
+	}
+
+	profundidade_segura = calcular_profundidade_segura();
+	if (prof_max >= 0 && prof_max < profundidade_segura) profundidade_segura = prof_max;
+	if (!saida_abrir(&saida_buf, 1, SAIDA_CAP_PADRAO)) {
+		fprintf(stderr, "Erro: sem memória para o buffer de saída.\n");
+		return 1;
+	}
+
+	Destino destino = destino_de(1);
+	const char* origem = "carregado do perfil";
+	double t_cal = 0;
+	int do_destino = perfil ? carregar_perfil(perfil, destino) : -1;
+	if (forcar_calibracao || do_destino <= 0) {
+		descartar_destino(destino);
+		double t0 = agora_seg();
+		if (!calibrar(destino)) {
+			fprintf(stderr, "Erro: falha ao preparar a calibração.\n");
+			return 1;
+		}
+		t_cal = agora_seg() - t0;
+		origem = "calibrado agora";
+		if (perfil && !salvar_perfil(perfil)) fprintf(stderr, "Aviso: não foi possível gravar o perfil %s.\n", perfil);
+	}
+	if (stats) {
+		fprintf(stderr, "[stats] destino=%s regras: %s", NOME_DESTINO[destino], origem);
+		if (t_cal > 0) fprintf(stderr, " (%.3fs)", t_cal);
+		fprintf(stderr, " profundidade segura=%ld\n", profundidade_segura);
+	}
+
+	for (int i = 0; i < qtd; i++) {
+		const Pedido* p = &pedidos[i];
+		const Regra* r = regra_para(destino, p);
+		Impl impl = r ? r->impl : IMPL_BUFFERIZADA;
+		const char* motivo = "";
+		if (impl == IMPL_RECURSIVA && !elegivel(impl, p)) {
+			impl = IMPL_LACO;
+			motivo = " (recursiva vetada: n acima da profundidade segura)";
+		}
+
+		printf("%s:\n", NOME_PECA[p->peca]);
+		double t0 = agora_seg();
+		// n = 0 não passa por nenhuma (o do-while daria um passo).
+		if (p->n > 0) servir(impl, p);
+		double dt = agora_seg() - t0;
+		printf("\n");
+		if (stats) {
+			fprintf(stderr, "[stats] %s n=%ld -> %s [%s, regra n>=%ld]%s %.6fs\n", CHAVE_PECA[p->peca], p->n,
+				p->n > 0 ? FUNCAO_IMPL[p->peca][impl] : "nenhuma", NOME_IMPL[impl], r ? r->n_min : 0L,
+				motivo, dt);
+		}
+	}
+	fflush(stdout);
+	int ok = saida_fechar(&saida_buf) && !ferror(stdout);
+	if (!ok) {
+		fprintf(stderr, "Erro: falha ao escrever a saída.\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,75 @@
+// Alvo do teste diferencial: xadrez_completo.c com o stdio desviado para a
+// Saida da thread. posicao_atual é global, então as chamadas deste programa
+// passam pela mesma trava.
+
+#include "desvio_saida.h"
+
+#define XADREZ_COMPLETO_SEM_MAIN
+#include "xadrez_completo.c"
+
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+static void torre_for_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_TORRE);
+	torre_for(n);
+}
+
+static void torre_recursiva_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_TORRE);
+	torre_recursiva(n);
+}
+
+static void bispo_while_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_BISPO);
+	bispo_while(n);
+}
+
+static void bispo_recursivo_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_BISPO);
+	bispo_recursivo(n);
+}
+
+static void bispo_decompostos_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_BISPO);
+	bispo_loops_decompostos(n);
+}
+
+static void rainha_dowhile_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_RAINHA);
+	rainha_dowhile(n);
+}
+
+static void rainha_recursiva_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_RAINHA);
+	rainha_recursiva(n);
+}
+
+static void cavalo_aninhados_d(int v, int h) {
+	posicionar_peca(INICIO_CAVALO_AVENTUREIRO);
+	cavalo_loops_aninhados(v, h);
+}
+
+static void cavalo_complexos_d(int v, int h) {
+	posicionar_peca(INICIO_CAVALO_MESTRE);
+	cavalo_loops_complexos(v, h);
+}
+
+const Implementacao IMPL_COMPLETO[] = {
+	{ "torre_for", "xadrez_completo", PADRAO_TORRE, 0, torre_for_d, &trava, 0 },
+	{ "torre_recursiva", "xadrez_completo", PADRAO_TORRE, 0, torre_recursiva_d, &trava, 1 },
+	{ "bispo_while", "xadrez_completo", PADRAO_BISPO, 0, bispo_while_d, &trava, 0 },
+	{ "bispo_recursivo", "xadrez_completo", PADRAO_BISPO, 0, bispo_recursivo_d, &trava, 1 },
+	{ "bispo_loops_decompostos", "xadrez_completo", PADRAO_BISPO_DECOMPOSTO, 0, bispo_decompostos_d, &trava, 0 },
+	{ "rainha_dowhile", "xadrez_completo", PADRAO_RAINHA, 1, rainha_dowhile_d, &trava, 0 },
+	{ "rainha_recursiva", "xadrez_completo", PADRAO_RAINHA, 0, rainha_recursiva_d, &trava, 1 },
+	{ "cavalo_loops_aninhados", "xadrez_completo", PADRAO_CAVALO_AVENTUREIRO, 0, cavalo_aninhados_d, &trava, 0 },
+	{ "cavalo_loops_complexos", "xadrez_completo", PADRAO_CAVALO_MESTRE, 0, cavalo_complexos_d, &trava, 0 },
+};
+const int QTD_IMPL_COMPLETO = (int)(sizeof IMPL_COMPLETO / sizeof IMPL_COMPLETO[0]);
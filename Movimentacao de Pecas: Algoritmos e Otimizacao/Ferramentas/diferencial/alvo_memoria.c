@@ -0,0 +1,42 @@
+// Alvo do teste diferencial: xadrez_otimizado_memoria.c com o stdio
+// desviado. O buffer OUT é global: uma chamada por vez, e cada uma termina
+// descarregando o que sobrou nele.
+
+#include "desvio_saida.h"
+
+#define main memoria_main
+#include "Movimentacao de Pecas: Algoritmos e Otimizacao/Versoes Otimizadas/xadrez_otimizado_memoria.c"
+
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+static void torre_d(int n, int b) {
+	(void)b;
+	repetir("Direita", n);
+	descarregar();
+}
+
+static void bispo_d(int n, int b) {
+	(void)b;
+	repetir("Cima Direita", n);
+	descarregar();
+}
+
+static void rainha_d(int n, int b) {
+	(void)b;
+	repetir("Esquerda", n);
+	descarregar();
+}
+
+static void cavalo_d(int v, int h) {
+	repetir("Cima", v);
+	repetir("Direita", h);
+	descarregar();
+}
+
+const Implementacao IMPL_MEMORIA[] = {
+	{ "repetir(Direita)", "otim_memoria", PADRAO_TORRE, 0, torre_d, &trava, 0 },
+	{ "repetir(Cima Direita)", "otim_memoria", PADRAO_BISPO, 0, bispo_d, &trava, 0 },
+	{ "repetir(Esquerda)", "otim_memoria", PADRAO_RAINHA, 0, rainha_d, &trava, 0 },
+	{ "repetir(Cima; Direita)", "otim_memoria", PADRAO_CAVALO_MESTRE, 0, cavalo_d, &trava, 0 },
+};
+const int QTD_IMPL_MEMORIA = (int)(sizeof IMPL_MEMORIA / sizeof IMPL_MEMORIA[0]);
@@ -0,0 +1,42 @@
+// Alvo do teste diferencial: mestre_recursividade_avancada.c com o stdio
+// desviado. O rastreamento de posição dele é estático (xadrez_casa.h e
+// funções internas); só main é renomeado.
+
+#include "desvio_saida.h"
+
+#define main mestre_main
+#include "Movimentacao de Pecas: Estruturas de Repeticao/Implementacao dos Niveis/mestre_recursividade_avancada.c"
+
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+static void torre_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_TORRE);
+	mover_torre_recursivo(n);
+}
+
+static void bispo_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_BISPO);
+	mover_bispo_recursivo(n);
+}
+
+static void rainha_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_RAINHA);
+	mover_rainha_recursivo(n);
+}
+
+static void bispo_aninhados_d(int n, int b) {
+	(void)b;
+	posicionar_peca(INICIO_BISPO);
+	mover_bispo_loops_aninhados(n, n);
+}
+
+const Implementacao IMPL_MESTRE[] = {
+	{ "mover_torre_recursivo", "mestre", PADRAO_TORRE, 0, torre_d, &trava, 1 },
+	{ "mover_bispo_recursivo", "mestre", PADRAO_BISPO, 0, bispo_d, &trava, 1 },
+	{ "mover_rainha_recursivo", "mestre", PADRAO_RAINHA, 0, rainha_d, &trava, 1 },
+	{ "mover_bispo_loops_aninhados", "mestre", PADRAO_BISPO_DECOMPOSTO, 0, bispo_aninhados_d, &trava, 0 },
+};
+const int QTD_IMPL_MESTRE = (int)(sizeof IMPL_MESTRE / sizeof IMPL_MESTRE[0]);
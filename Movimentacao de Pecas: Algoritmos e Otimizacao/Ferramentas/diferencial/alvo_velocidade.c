@@ -0,0 +1,35 @@
+// Alvo do teste diferencial: xadrez_otimizado_velocidade.c com o stdio
+// desviado. Sem estado global: chamadas em paralelo.
+
+#include "desvio_saida.h"
+
+#define main velocidade_main
+#include "Movimentacao de Pecas: Algoritmos e Otimizacao/Versoes Otimizadas/xadrez_otimizado_velocidade.c"
+
+static void torre_d(int n, int b) {
+	(void)b;
+	repetir_puts("Direita", n);
+}
+
+static void bispo_d(int n, int b) {
+	(void)b;
+	repetir_puts("Cima Direita", n);
+}
+
+static void rainha_d(int n, int b) {
+	(void)b;
+	repetir_puts("Esquerda", n);
+}
+
+static void cavalo_d(int v, int h) {
+	repetir_puts("Cima", v);
+	repetir_puts("Direita", h);
+}
+
+const Implementacao IMPL_VELOCIDADE[] = {
+	{ "repetir_puts(Direita)", "otim_velocidade", PADRAO_TORRE, 0, torre_d, NULL, 0 },
+	{ "repetir_puts(Cima Direita)", "otim_velocidade", PADRAO_BISPO, 0, bispo_d, NULL, 0 },
+	{ "repetir_puts(Esquerda)", "otim_velocidade", PADRAO_RAINHA, 0, rainha_d, NULL, 0 },
+	{ "repetir_puts(Cima; Direita)", "otim_velocidade", PADRAO_CAVALO_MESTRE, 0, cavalo_d, NULL, 0 },
+};
+const int QTD_IMPL_VELOCIDADE = (int)(sizeof IMPL_VELOCIDADE / sizeof IMPL_VELOCIDADE[0]);
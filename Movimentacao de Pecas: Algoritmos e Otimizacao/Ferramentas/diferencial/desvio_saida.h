@@ -0,0 +1,33 @@
+#ifndef DESVIO_SAIDA_H
+#define DESVIO_SAIDA_H
+
+// Incluído antes do fonte de um programa (alvo_*.c): depois daqui, printf,
+// puts e fwrite escrevem na Saida da thread (saida_desviada) em vez do
+// stdout. Os cabeçalhos do sistema já foram lidos, então as declarações
+// originais não são afetadas; o FILE* recebido é ignorado (os programas só
+// escrevem no stdout).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "diferencial.h"
+
+int desvio_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static inline size_t desvio_fwrite(const void* p, size_t tam, size_t n, FILE* f) {
+	(void)f;
+	saida_escrever(saida_desviada, p, tam * n);
+	return n;
+}
+
+static inline int desvio_puts(const char* s) {
+	saida_linha(saida_desviada, s);
+	return 1;
+}
+
+#define printf(...) desvio_printf(__VA_ARGS__)
+#define puts(s) desvio_puts(s)
+#define fwrite(p, tam, n, f) desvio_fwrite(p, tam, n, f)
+
+#endif
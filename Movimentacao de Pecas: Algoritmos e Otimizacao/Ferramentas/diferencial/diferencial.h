@@ -0,0 +1,47 @@
+#ifndef DIFERENCIAL_H
+#define DIFERENCIAL_H
+
+#include <pthread.h>
+
+#include "xadrez_saida.h"
+
+// Teste diferencial: implementações equivalentes de cada movimento, vindas
+// de programas diferentes, chamadas no mesmo processo. Cada programa é uma
+// unidade de tradução própria (alvo_*.c) compilada com desvio_saida.h, que
+// troca printf/puts/fwrite pela Saida da thread; o executor compara o que
+// chega nela com o fluxo esperado.
+
+// Fluxo esperado de cada grupo de implementações equivalentes.
+typedef enum {
+	PADRAO_TORRE,              // n x "Direita"
+	PADRAO_BISPO,              // n x "Cima Direita"
+	PADRAO_RAINHA,             // n x "Esquerda"
+	PADRAO_CAVALO_MESTRE,      // a x "Cima", b x "Direita"
+	PADRAO_CAVALO_AVENTUREIRO, // a x "Baixo", b x "Esquerda"
+	PADRAO_BISPO_DECOMPOSTO,   // n x ("Cima", "Direita")
+	PADRAO_QTD
+} Padrao;
+
+typedef struct {
+	const char* nome;       // função comparada
+	const char* programa;   // binário de origem
+	Padrao padrao;
+	int n_min;              // menor n aceito (o do-while emite 1 passo com n = 0)
+	void (*executar)(int a, int b); // Cavalo: a verticais, b horizontais; demais: n = a
+	pthread_mutex_t* trava; // estado global do programa; NULL = reentrante
+	int recursiva;          // pilha O(n): roda na thread de pilha grande
+} Implementacao;
+
+// Destino do stdio desviado (definido no executor).
+extern _Thread_local Saida* saida_desviada;
+
+extern const Implementacao IMPL_COMPLETO[];
+extern const int QTD_IMPL_COMPLETO;
+extern const Implementacao IMPL_MESTRE[];
+extern const int QTD_IMPL_MESTRE;
+extern const Implementacao IMPL_MEMORIA[];
+extern const int QTD_IMPL_MEMORIA;
+extern const Implementacao IMPL_VELOCIDADE[];
+extern const int QTD_IMPL_VELOCIDADE;
+
+#endif
@@ -0,0 +1,481 @@
+#define _POSIX_C_SOURCE 200809L
+
+// Teste diferencial das implementações equivalentes de cada movimento:
+// torre_for ≡ torre_recursiva ≡ mover_torre_recursivo ≡ repetir ≡
+// repetir_puts ≡ emitir_passos, e assim por diante para Bispo, Rainha e os
+// dois Cavalos. Todas rodam neste processo, sorteando n (log-uniforme até
+// --max, mais os extremos 0, 1, 2 e --max), em paralelo, uma thread por
+// núcleo. O fluxo de cada chamada vai para uma Saida cujo descarregar
+// confere cada bloco contra o fluxo esperado, sem guardar a saída inteira.
+// Relata a primeira divergência (byte, tamanhos) por implementação e caso.
+// Uso: ./teste_diferencial [--max=N] [--casos=K] [--semente=S] [--threads=T] [--stats]
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "diferencial.h"
+#include "xadrez_formatos.h"
+#include "xadrez_util.h"
+
+#define N_MAX_PADRAO 10000000L
+#define CASOS_PADRAO 4
+#define SEMENTE_PADRAO 1
+#define THREADS_MAX 64
+#define QUADRO_MAX 64 // bytes de pilha por passo se a recursão não virar laço
+
+_Thread_local Saida* saida_desviada;
+
+int desvio_printf(const char* fmt, ...) {
+	char tmp[512];
+	va_list ap;
+	va_start(ap, fmt);
+	int n = vsnprintf(tmp, sizeof tmp, fmt, ap);
+	va_end(ap);
+	if (n < 0) return n;
+	if ((size_t)n < sizeof tmp) {
+		saida_escrever(saida_desviada, tmp, (size_t)n);
+		return n;
+	}
+	char* longo = malloc((size_t)n + 1);
+	if (!longo) return -1;
+	va_start(ap, fmt);
+	vsnprintf(longo, (size_t)n + 1, fmt, ap);
+	va_end(ap);
+	saida_escrever(saida_desviada, longo, (size_t)n);
+	free(longo);
+	return n;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ EMISSORES DA BIBLIOTECA (xadrez_com_validacoes)
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static void emitir_texto(Peca p, Direcao d1, int n1, Direcao d2, int n2) {
+	Posicao pos = { 0, 0 };
+	uint64_t indice = 0;
+	emitir_passos(saida_desviada, FORMATO_TEXTO, p, d1, n1, &pos, &indice);
+	if (n2 > 0) emitir_passos(saida_desviada, FORMATO_TEXTO, p, d2, n2, &pos, &indice);
+}
+
+static void torre_d(int n, int b) {
+	(void)b;
+	emitir_texto(PECA_TORRE, DIR_DIREITA, n, DIR_DIREITA, 0);
+}
+
+static void bispo_d(int n, int b) {
+	(void)b;
+	emitir_texto(PECA_BISPO, DIR_CIMA_DIREITA, n, DIR_CIMA_DIREITA, 0);
+}
+
+static void rainha_d(int n, int b) {
+	(void)b;
+	emitir_texto(PECA_RAINHA, DIR_ESQUERDA, n, DIR_ESQUERDA, 0);
+}
+
+static void cavalo_mestre_d(int v, int h) {
+	emitir_texto(PECA_CAVALO, DIR_CIMA, v, DIR_DIREITA, h);
+}
+
+static void cavalo_aventureiro_d(int v, int h) {
+	emitir_texto(PECA_CAVALO, DIR_BAIXO, v, DIR_ESQUERDA, h);
+}
+
+static const Implementacao IMPL_VALIDACOES[] = {
+	{ "emitir_passos(Direita)", "otim_validacoes", PADRAO_TORRE, 0, torre_d, NULL, 0 },
+	{ "emitir_passos(Cima Direita)", "otim_validacoes", PADRAO_BISPO, 0, bispo_d, NULL, 0 },
+	{ "emitir_passos(Esquerda)", "otim_validacoes", PADRAO_RAINHA, 0, rainha_d, NULL, 0 },
+	{ "emitir_passos(Cima; Direita)", "otim_validacoes", PADRAO_CAVALO_MESTRE, 0, cavalo_mestre_d, NULL, 0 },
+	{ "emitir_passos(Baixo; Esquerda)", "otim_validacoes", PADRAO_CAVALO_AVENTUREIRO, 0, cavalo_aventureiro_d, NULL, 0 },
+};
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ FLUXO ESPERADO E CONFERÊNCIA
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static const char* const NOME_PADRAO[PADRAO_QTD] = {
+	"TORRE", "BISPO", "RAINHA", "CAVALO (Cima, Direita)", "CAVALO (Baixo, Esquerda)", "BISPO (decomposto)",
+};
+
+// Cada padrão é um ou dois segmentos: um bloco de linhas repetido.
+typedef struct {
+	const char* bloco;
+	long vezes;
+} Segmento;
+
+static int segmentos(Padrao p, int a, int b, Segmento seg[2]) {
+	switch (p) {
+	case PADRAO_TORRE: seg[0] = (Segmento){ "Direita\n", a }; return 1;
+	case PADRAO_BISPO: seg[0] = (Segmento){ "Cima Direita\n", a }; return 1;
+	case PADRAO_RAINHA: seg[0] = (Segmento){ "Esquerda\n", a }; return 1;
+	case PADRAO_BISPO_DECOMPOSTO: seg[0] = (Segmento){ "Cima\nDireita\n", a }; return 1;
+	case PADRAO_CAVALO_MESTRE:
+		seg[0] = (Segmento){ "Cima\n", a };
+		seg[1] = (Segmento){ "Direita\n", b };
+		return 2;
+	default:
+		seg[0] = (Segmento){ "Baixo\n", a };
+		seg[1] = (Segmento){ "Esquerda\n", b };
+		return 2;
+	}
+}
+
+// Janela: o bloco repetido até cobrir um buffer cheio a partir de qualquer
+// fase, para conferir com um memcmp por bloco descarregado em vez de um por
+// linha. Montada sob demanda e mantida por thread.
+typedef struct {
+	const char* bloco;
+	size_t tam_bloco;
+	char* dados;
+} Janela;
+
+#define JANELAS_MAX 8
+
+typedef struct {
+	Segmento seg[2];
+	Janela* janela[2];
+	int qtd;
+	int atual;
+	uint64_t feito;        // bytes conferidos do segmento atual
+	uint64_t conferidos;   // bytes recebidos no total
+	uint64_t esperados;
+	int64_t divergencia;   // primeiro byte divergente; -1 = nenhum
+} Conferencia;
+
+typedef struct {
+	Janela janelas[JANELAS_MAX];
+	int qtd_janelas;
+	Saida saida;
+	Conferencia conf;
+} Bancada;
+
+static Janela* janela_de(Bancada* b, const char* bloco) {
+	for (int i = 0; i < b->qtd_janelas; i++) {
+		if (b->janelas[i].bloco == bloco) return &b->janelas[i];
+	}
+	if (b->qtd_janelas == JANELAS_MAX) return NULL;
+	size_t tam = strlen(bloco);
+	size_t total = b->saida.cap + 2 * tam;
+	char* dados = malloc(total);
+	if (!dados) return NULL;
+	for (size_t i = 0; i < total; i++) dados[i] = bloco[i % tam];
+	Janela* j = &b->janelas[b->qtd_janelas++];
+	*j = (Janela){ bloco, tam, dados };
+	return j;
+}
+
+static void marcar(Conferencia* c, uint64_t offset) {
+	if (c->divergencia < 0) c->divergencia = (int64_t)offset;
+}
+
+static void conferir(Conferencia* c, const char* p, size_t n) {
+	uint64_t inicio = c->conferidos;
+	c->conferidos += n;
+	if (c->divergencia >= 0) return;
+	while (n > 0) {
+		while (c->atual < c->qtd && c->feito == (uint64_t)c->seg[c->atual].vezes * c->janela[c->atual]->tam_bloco) {
+			c->atual++;
+			c->feito = 0;
+		}
+		if (c->atual == c->qtd) {
+			marcar(c, inicio); // bytes além do esperado
+			return;
+		}
+		const Janela* j = c->janela[c->atual];
+		uint64_t resta = (uint64_t)c->seg[c->atual].vezes * j->tam_bloco - c->feito;
+		size_t pedaco = n < resta ? n : (size_t)resta;
+		const char* esperado = j->dados + c->feito % j->tam_bloco;
+		if (memcmp(p, esperado, pedaco) != 0) {
+			size_t i = 0;
+			while (p[i] == esperado[i]) i++;
+			marcar(c, inicio + i);
+			return;
+		}
+		c->feito += pedaco;
+		inicio += pedaco;
+		p += pedaco;
+		n -= pedaco;
+	}
+}
+
+static int descarregar_conferindo(Saida* s) {
+	conferir(s->ctx, s->buf, s->len);
+	s->total += s->len;
+	s->len = 0;
+	return 1;
+}
+
+static int bancada_abrir(Bancada* b) {
+	memset(b, 0, sizeof *b);
+	if (!saida_abrir(&b->saida, -1, SAIDA_CAP_PADRAO)) return -1;
+	b->saida.descarregar = descarregar_conferindo;
+	b->saida.ctx = &b->conf;
+	return 0;
+}
+
+static void bancada_fechar(Bancada* b) {
+	b->saida.descarregar = NULL;
+	b->saida.len = 0;
+	saida_fechar(&b->saida);
+	for (int i = 0; i < b->qtd_janelas; i++) free(b->janelas[i].dados);
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ CASOS, TAREFAS E THREADS
+────────────────────────────────────────────────────────────────────────────
+*/
+
+typedef struct {
+	Padrao padrao;
+	int a, b;
+} Caso;
+
+typedef struct {
+	const Implementacao* impl;
+	const Caso* caso;
+	int64_t divergencia;
+	uint64_t obtidos, esperados;
+	int erro;
+} Tarefa;
+
+typedef struct Fila {
+	Tarefa* tarefas;
+	int qtd;
+	atomic_int proxima;
+	struct Fila* depois; // esvaziada esta, a thread ajuda na seguinte
+} Fila;
+
+static void executar(Bancada* b, Tarefa* t) {
+	Conferencia* c = &b->conf;
+	memset(c, 0, sizeof *c);
+	c->divergencia = -1;
+	c->qtd = segmentos(t->caso->padrao, t->caso->a, t->caso->b, c->seg);
+	for (int i = 0; i < c->qtd; i++) {
+		c->janela[i] = janela_de(b, c->seg[i].bloco);
+		if (!c->janela[i]) {
+			t->erro = 1;
+			return;
+		}
+		c->esperados += (uint64_t)c->seg[i].vezes * c->janela[i]->tam_bloco;
+	}
+	b->saida.total = 0;
+	b->saida.len = 0;
+	b->saida.erro = 0;
+	saida_desviada = &b->saida;
+
+	if (t->impl->trava) pthread_mutex_lock(t->impl->trava);
+	t->impl->executar(t->caso->a, t->caso->b);
+	saida_flush(&b->saida);
+	if (t->impl->trava) pthread_mutex_unlock(t->impl->trava);
+
+	if (c->divergencia < 0 && c->conferidos != c->esperados) marcar(c, c->conferidos); // saída curta
+	t->divergencia = c->divergencia;
+	t->obtidos = c->conferidos;
+	t->esperados = c->esperados;
+}
+
+static void* trabalhar(void* arg) {
+	Fila* f = arg;
+	Bancada b;
+	if (bancada_abrir(&b) != 0) return (void*)1;
+	for (; f; f = f->depois) {
+		for (;;) {
+			int i = atomic_fetch_add(&f->proxima, 1);
+			if (i >= f->qtd) break;
+			executar(&b, &f->tarefas[i]);
+		}
+	}
+	bancada_fechar(&b);
+	return NULL;
+}
+
+static uint64_t splitmix64(uint64_t* s) {
+	uint64_t z = (*s += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// n log-uniforme em [1, max]: década sorteada, depois n uniforme dentro dela.
+static long sortear_n(uint64_t* s, long max) {
+	int decadas = 0;
+	for (long p = 1; p * 10 <= max; p *= 10) decadas++;
+	int d = (int)(splitmix64(s) % (uint64_t)(decadas + 1));
+	long lo = 1;
+	for (int i = 0; i < d; i++) lo *= 10;
+	long hi = lo * 10 - 1 < max ? lo * 10 - 1 : max;
+	return lo + (long)(splitmix64(s) % (uint64_t)(hi - lo + 1));
+}
+
+static Caso caso_de(Padrao p, long n, uint64_t* s) {
+	if (p == PADRAO_CAVALO_MESTRE || p == PADRAO_CAVALO_AVENTUREIRO) {
+		long h = (long)(splitmix64(s) % (uint64_t)(n + 1));
+		return (Caso){ p, (int)(n - h), (int)h };
+	}
+	return (Caso){ p, (int)n, 0 };
+}
+
+static int comparar_tarefas(const void* x, const void* y) {
+	const Tarefa* a = x;
+	const Tarefa* b = y;
+	if (a->impl->recursiva != b->impl->recursiva) return b->impl->recursiva - a->impl->recursiva;
+	long na = (long)a->caso->a + a->caso->b, nb = (long)b->caso->a + b->caso->b;
+	return (na < nb) - (na > nb); // maiores primeiro: equilibra as threads
+}
+
+static void descrever_caso(const Caso* c, char* buf, size_t cap) {
+	if (c->padrao == PADRAO_CAVALO_MESTRE || c->padrao == PADRAO_CAVALO_AVENTUREIRO) {
+		snprintf(buf, cap, "v=%d h=%d", c->a, c->b);
+	} else {
+		snprintf(buf, cap, "n=%d", c->a);
+	}
+}
+
+int main(int argc, char** argv) {
+	long n_max = N_MAX_PADRAO, casos = CASOS_PADRAO, semente = SEMENTE_PADRAO, threads = 0;
+	int stats = 0;
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strncmp(a, "--max=", 6) && parse_long(a + 6, 2, 100000000L, &n_max)) {
+		} else if (!strncmp(a, "--casos=", 8) && parse_long(a + 8, 0, 1000, &casos)) {
+		} else if (!strncmp(a, "--semente=", 10) && parse_long(a + 10, 0, 2147483647L, &semente)) {
+		} else if (!strncmp(a, "--threads=", 10) && parse_long(a + 10, 1, THREADS_MAX, &threads)) {
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else {
+			fprintf(stderr, "Uso: %s [--max=N] [--casos=K] [--semente=S] [--threads=T] [--stats]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (threads == 0) {
+		long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = nucleos < 1 ? 1 : nucleos > THREADS_MAX ? THREADS_MAX : nucleos;
+	}
+
+	const Implementacao* impls[128];
+	int qtd_impls = 0;
+	struct { const Implementacao* v; int n; } grupos[] = {
+		{ IMPL_COMPLETO, QTD_IMPL_COMPLETO },
+		{ IMPL_MESTRE, QTD_IMPL_MESTRE },
+		{ IMPL_MEMORIA, QTD_IMPL_MEMORIA },
+		{ IMPL_VELOCIDADE, QTD_IMPL_VELOCIDADE },
+		{ IMPL_VALIDACOES, (int)(sizeof IMPL_VALIDACOES / sizeof IMPL_VALIDACOES[0]) },
+	};
+	for (size_t g = 0; g < sizeof grupos / sizeof grupos[0]; g++) {
+		for (int i = 0; i < grupos[g].n; i++) impls[qtd_impls++] = &grupos[g].v[i];
+	}
+
+	// Casos por padrão: os extremos fixos e depois os sorteados.
+	int por_padrao = 4 + (int)casos;
+	Caso* lista = malloc(sizeof *lista * (size_t)por_padrao * PADRAO_QTD);
+	Tarefa* tarefas = malloc(sizeof *tarefas * (size_t)por_padrao * PADRAO_QTD * (size_t)qtd_impls);
+	if (!lista || !tarefas) {
+		fprintf(stderr, "Erro: memória insuficiente.\n");
+		return 1;
+	}
+	uint64_t s = (uint64_t)semente;
+	int qtd_casos = 0, qtd_tarefas = 0;
+	for (int p = 0; p < PADRAO_QTD; p++) {
+		long fixos[4] = { 0, 1, 2, n_max };
+		for (int k = 0; k < por_padrao; k++) {
+			long n = k < 4 ? fixos[k] : sortear_n(&s, n_max);
+			Caso* c = &lista[qtd_casos++];
+			*c = caso_de((Padrao)p, n, &s);
+			for (int i = 0; i < qtd_impls; i++) {
+				if (impls[i]->padrao != (Padrao)p || c->a + c->b < impls[i]->n_min) continue;
+				tarefas[qtd_tarefas++] = (Tarefa){ impls[i], c, -1, 0, 0, 0 };
+			}
+		}
+	}
+	qsort(tarefas, (size_t)qtd_tarefas, sizeof *tarefas, comparar_tarefas);
+
+	printf("=== Teste diferencial (%d implementações, n até %ld, semente %ld, %ld threads) ===\n", qtd_impls, n_max,
+		   semente, threads);
+
+	// As recursivas (no início, pela ordenação) vão para uma única thread com
+	// pilha para n_max quadros, mesmo sem eliminação da chamada de cauda;
+	// as demais threads ficam com a pilha padrão.
+	int qtd_recursivas = 0;
+	while (qtd_recursivas < qtd_tarefas && tarefas[qtd_recursivas].impl->recursiva) qtd_recursivas++;
+	Fila comuns = { tarefas + qtd_recursivas, qtd_tarefas - qtd_recursivas, 0, NULL };
+	Fila recursivas = { tarefas, qtd_recursivas, 0, &comuns };
+	pthread_t th[THREADS_MAX];
+	int criadas = 0;
+	double t0 = agora_seg();
+	if (qtd_recursivas > 0) {
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+		pthread_attr_setstacksize(&attr, (size_t)n_max * QUADRO_MAX + (8u << 20));
+		int rc = pthread_create(&th[0], &attr, trabalhar, &recursivas);
+		pthread_attr_destroy(&attr);
+		if (rc != 0) {
+			fprintf(stderr, "Erro: não foi possível criar a thread das recursivas (%s).\n", strerror(rc));
+			return 1;
+		}
+		criadas = 1;
+	}
+	for (long i = criadas; i < threads; i++) {
+		if (pthread_create(&th[criadas], NULL, trabalhar, &comuns) == 0) criadas++;
+	}
+	if (criadas == 0) {
+		fprintf(stderr, "Erro: não foi possível criar threads.\n");
+		return 1;
+	}
+	int falha_thread = 0;
+	for (int i = 0; i < criadas; i++) {
+		void* r;
+		pthread_join(th[i], &r);
+		if (r) falha_thread = 1;
+	}
+	double dt = agora_seg() - t0;
+	if (falha_thread || atomic_load(&recursivas.proxima) < recursivas.qtd ||
+	    atomic_load(&comuns.proxima) < comuns.qtd) {
+		fprintf(stderr, "Erro: threads de teste falharam.\n");
+		return 1;
+	}
+
+	int divergencias = 0;
+	uint64_t bytes = 0;
+	for (int p = 0; p < PADRAO_QTD; p++) {
+		int n_impl = 0, n_tarefas = 0, n_div = 0;
+		for (int i = 0; i < qtd_impls; i++) n_impl += impls[i]->padrao == (Padrao)p;
+		for (int i = 0; i < qtd_tarefas; i++) {
+			const Tarefa* t = &tarefas[i];
+			if (t->caso->padrao != (Padrao)p) continue;
+			n_tarefas++;
+			bytes += t->obtidos;
+			if (t->divergencia < 0 && !t->erro) continue;
+			n_div++;
+			char caso[48];
+			descrever_caso(t->caso, caso, sizeof caso);
+			if (t->erro) {
+				printf("  ERRO: %s [%s] %s: sem memória para conferir\n", t->impl->nome, t->impl->programa, caso);
+			} else {
+				printf("  DIVERGÊNCIA: %s [%s] %s: byte %lld (esperados %llu bytes, obtidos %llu)\n", t->impl->nome,
+					   t->impl->programa, caso, (long long)t->divergencia, (unsigned long long)t->esperados,
+					   (unsigned long long)t->obtidos);
+			}
+		}
+		printf("%-26s %d implementações, %d comparações: %s\n", NOME_PADRAO[p], n_impl, n_tarefas,
+			   n_div ? "DIVERGENTE" : "idênticas");
+		divergencias += n_div;
+	}
+	printf("Comparações: %d  Divergências: %d\n", qtd_tarefas, divergencias);
+	if (stats) {
+		if (dt <= 0) dt = 1e-9;
+		fprintf(stderr, "[stats] tarefas=%d bytes=%llu tempo=%.3fs vazão=%.1f MB/s threads=%d\n", qtd_tarefas,
+				(unsigned long long)bytes, dt, (double)bytes / dt / 1e6, criadas);
+	}
+	free(lista);
+	free(tarefas);
+	return divergencias ? 1 : 0;
+}
@@ -0,0 +1,226 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xadrez_cavalo.h"
+#include "xadrez_saida.h"
+#include "xadrez_util.h"
+
+// Distância mínima do Cavalo entre duas casas do tabuleiro 8x8.
+// A tabela 64x64 é preenchida por BFS na inicialização; cada consulta é
+// uma leitura de tabela. No modo lote, a linha de resposta de cada par
+// também é pré-montada, então o custo por par é: parse de 2 casas + memcpy.
+// Uso: ./distancia_cavalo <de> <para>
+//      ./distancia_cavalo --de=<casa>                   (mapa de distâncias)
+//      ./distancia_cavalo --lote=<arquivo|-> [--caminho] [--stats]
+// Formato do lote: uma consulta por linha, "a1 h8" (espaço, tab ou vírgula).
+
+#define BLOCO_LEITURA (1 << 20)
+#define RESPOSTA_MAX 40 // "a1 h8 6 a1-b3-...-h8\n" (no máximo 7 casas)
+
+typedef struct {
+	uint8_t len;
+	char txt[RESPOSTA_MAX];
+} Resposta;
+
+static TabelaCavalo TAB;
+static DistanciasCavalo DIST;
+static Resposta RESPOSTAS[TAB_MAX_CASAS][TAB_MAX_CASAS];
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s <de> <para>\n"
+		"     %s --de=<casa>\n"
+		"     %s --lote=<arquivo|-> [--caminho] [--stats]\n",
+		prog, prog, prog);
+}
+
+// Escreve "a1-b3-c5" em dst; retorna bytes escritos.
+static size_t formatar_caminho(int de, int para, char* dst) {
+	uint8_t caminho[TAB_MAX_CASAS];
+	int n = caminho_cavalo(&DIST, de, para, caminho);
+	size_t len = 0;
+	for (int i = 0; i < n; i++) {
+		if (i) dst[len++] = '-';
+		nome_casa_tab(&TAB, caminho[i], dst + len);
+		len += 2;
+	}
+	return len;
+}
+
+static void montar_respostas(int com_caminho) {
+	for (int de = 0; de < TAB.casas; de++) {
+		for (int para = 0; para < TAB.casas; para++) {
+			Resposta* r = &RESPOSTAS[de][para];
+			char* p = r->txt;
+			nome_casa_tab(&TAB, de, p);
+			p[2] = ' ';
+			nome_casa_tab(&TAB, para, p + 3);
+			p[5] = ' ';
+			p[6] = (char)('0' + distancia_cavalo(&DIST, de, para));
+			size_t len = 7;
+			if (com_caminho) {
+				p[len++] = ' ';
+				len += formatar_caminho(de, para, p + len);
+			}
+			p[len++] = '\n';
+			r->len = (uint8_t)len;
+		}
+	}
+}
+
+// Índice da casa a partir de 2 caracteres; -1 se inválido.
+static inline int casa_de_chars(const char* c) {
+	unsigned col = (unsigned)(c[0] - 'a'), lin = (unsigned)(c[1] - '1');
+	return (col < 8 && lin < 8) ? (int)(lin * 8 + col) : -1;
+}
+
+static inline int separador(char c) {
+	return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+// Processa uma linha [ini, fim); retorna 1 se válida, 0 se inválida e
+// -1 se em branco (ignorada).
+static int responder_linha(Saida* s, const char* ini, const char* fim) {
+	while (ini < fim && separador(*ini)) ini++;
+	if (ini == fim) return -1;
+	if (fim - ini < 2) return 0;
+	int de = casa_de_chars(ini);
+	ini += 2;
+	if (ini >= fim || !separador(*ini)) return 0;
+	while (ini < fim && separador(*ini)) ini++;
+	if (fim - ini < 2) return 0;
+	int para = casa_de_chars(ini);
+	ini += 2;
+	while (ini < fim && separador(*ini)) ini++;
+	if (de < 0 || para < 0 || ini != fim) return 0;
+	const Resposta* r = &RESPOSTAS[de][para];
+	saida_escrever(s, r->txt, r->len);
+	return 1;
+}
+
+static int rodar_lote(const char* caminho, int com_caminho, int stats) {
+	FILE* in = strcmp(caminho, "-") ? fopen(caminho, "rb") : stdin;
+	if (!in) {
+		perror(caminho);
+		return 1;
+	}
+	char* buf = malloc(BLOCO_LEITURA + 64);
+	Saida out;
+	if (!buf || !saida_abrir(&out, 1, SAIDA_CAP_PADRAO)) {
+		fprintf(stderr, "Erro: sem memória.\n");
+		free(buf);
+		if (in != stdin) fclose(in);
+		return 1;
+	}
+	montar_respostas(com_caminho);
+
+	double t0 = agora_seg();
+	uint64_t linhas = 0, consultas = 0, erros = 0;
+	size_t pendente = 0; // bytes de uma linha incompleta do bloco anterior
+	for (;;) {
+		size_t lidos = fread(buf + pendente, 1, BLOCO_LEITURA - pendente, in);
+		if (lidos == 0 && ferror(in)) break; // erro de leitura, não EOF: reportado abaixo
+		int eof = lidos == 0;
+		char* p = buf;
+		char* fim = buf + pendente + lidos;
+		while (p < fim) {
+			char* nl = memchr(p, '\n', (size_t)(fim - p));
+			if (!nl) {
+				if (!eof) break;
+				nl = fim; // última linha sem '\n'
+			}
+			linhas++;
+			int r = responder_linha(&out, p, nl);
+			if (r > 0) {
+				consultas++;
+			} else if (r == 0 && ++erros <= 10) {
+				fprintf(stderr, "Linha %llu inválida\n", (unsigned long long)linhas);
+			}
+			p = nl + 1;
+		}
+		if (eof) break;
+		pendente = (size_t)(fim - p);
+		if (pendente == BLOCO_LEITURA) {
+			fprintf(stderr, "Erro: linha maior que %d bytes.\n", BLOCO_LEITURA);
+			erros++;
+			break;
+		}
+		memmove(buf, p, pendente);
+	}
+	int ok = saida_fechar(&out);
+	double dt = agora_seg() - t0;
+	int leitura = !ferror(in);
+	if (!leitura) perror(caminho);
+	if (in != stdin) fclose(in);
+	free(buf);
+	if (dt <= 0) dt = 1e-9;
+	if (stats) {
+		fprintf(stderr, "[stats] consultas=%llu erros=%llu tempo=%.3fs consultas/s=%.0f\n",
+				(unsigned long long)consultas, (unsigned long long)erros, dt, (double)consultas / dt);
+	}
+	return ok && leitura && erros == 0 ? 0 : 1;
+}
+
+static void mapa_de(int de) {
+	char nome[3];
+	nome_casa_tab(&TAB, de, nome);
+	printf("Saltos mínimos do Cavalo a partir de %s:\n\n", nome);
+	for (int lin = TAB.altura - 1; lin >= 0; lin--) {
+		printf("%d ", lin + 1);
+		for (int col = 0; col < TAB.largura; col++)
+			printf(" %d", distancia_cavalo(&DIST, de, lin * TAB.largura + col));
+		printf("\n");
+	}
+	printf("   a b c d e f g h\n");
+}
+
+int main(int argc, char** argv) {
+	const char* lote = NULL;
+	const char* casas[2];
+	int ncasas = 0, com_caminho = 0, stats = 0, de_mapa = -1;
+
+	tabela_cavalo_iniciar(&TAB, 8, 8);
+	distancias_cavalo_iniciar(&DIST, &TAB);
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--lote=", 7)) {
+			lote = a + 7;
+		} else if (!strcmp(a, "--caminho")) {
+			com_caminho = 1;
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (!strncmp(a, "--de=", 5) && (de_mapa = casa_tab_de_nome(&TAB, a + 5)) >= 0) {
+		} else if (a[0] != '-' && ncasas < 2 && casa_tab_de_nome(&TAB, a) >= 0) {
+			casas[ncasas++] = a;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (lote) return rodar_lote(lote, com_caminho, stats);
+	if (de_mapa >= 0) {
+		mapa_de(de_mapa);
+		return 0;
+	}
+	if (ncasas != 2) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	int de = casa_tab_de_nome(&TAB, casas[0]);
+	int para = casa_tab_de_nome(&TAB, casas[1]);
+	char txt[RESPOSTA_MAX];
+	txt[formatar_caminho(de, para, txt)] = '\0';
+	printf("Distância do Cavalo %s → %s: %d salto(s)\n", casas[0], casas[1], distancia_cavalo(&DIST, de, para));
+	printf("Caminho mínimo: %s\n", txt);
+	return 0;
+}
@@ -0,0 +1,211 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "xadrez_motor.h"
+#include "xadrez_util.h"
+
+// Geração de movimentos pelo motor genérico (xadrez_motor.h) para peças
+// comuns e feéricas em tabuleiros de qualquer tamanho.
+// Uso: ./motor_pecas --peca=<chave> [--tamanho=LxA] [--inicio=x,y] [--pecas=K]
+//      ./motor_pecas --definir="S(1,3)+C(1,1)" [...]   (peça feérica)
+//      ./motor_pecas --peca=<chave> --bench=M          (especializado x genérico)
+//      ./motor_pecas --listar
+
+static int parse_par(const char* s, char sep, int64_t* a, int64_t* b) {
+	errno = 0;
+	char* end = NULL;
+	long long x = strtoll(s, &end, 10);
+	if (errno || end == s || *end != sep) return 0;
+	const char* s2 = end + 1;
+	long long y = strtoll(s2, &end, 10);
+	if (errno || end == s2 || *end != '\0') return 0;
+	*a = x;
+	*b = y;
+	return 1;
+}
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s --peca=<chave> | --definir=<spec> [opções]\n"
+		"  --tamanho=LxA    dimensões do tabuleiro (padrão 8x8)\n"
+		"  --inicio=x,y     casa da peça, 0-based (padrão: centro)\n"
+		"  --pecas=K        obstáculos aleatórios (padrão 0)\n"
+		"  --semente=S      semente dos obstáculos (padrão 1)\n"
+		"  --bench=M        M gerações: kernel especializado x caminho genérico\n"
+		"  --listar         peças da tabela\n"
+		"  spec: componentes S(a,b) (salto) ou C(a,b) (corrida) unidos por '+'\n",
+		prog);
+}
+
+static void listar_pecas(void) {
+	printf("%-12s %-20s %8s %s\n", "chave", "nome", "vetores", "tipo");
+	for (int i = 0; i < ID_QTD; i++) {
+		const DefPeca* d = &MOTOR_DEF[i];
+		int saltos = 0;
+		for (int v = 0; v < d->qtd; v++) saltos += d->vet[v].tipo == MOV_SALTO;
+		const char* tipo = saltos == d->qtd ? "salto" : saltos == 0 ? "corrida" : "composta";
+		printf("%-12s %-20s %8d %s\n", d->chave, d->nome, d->qtd, tipo);
+	}
+}
+
+static void mostrar_mapa(const Ocupacao* o, Posicao p, const Raio* raios, size_t n) {
+	const Geometria* g = o->geo;
+	for (int64_t y = g->altura - 1; y >= 0; y--) {
+		printf("%3lld ", (long long)y);
+		for (int64_t x = 0; x < g->largura; x++) {
+			char c = ocupacao_contem(o, x, y) ? '#' : '.';
+			if (x == p.x && y == p.y) c = 'P';
+			for (size_t i = 0; i < n && c == '.'; i++) {
+				int64_t ddx = x - p.x, ddy = y - p.y;
+				int64_t k = raios[i].dx ? ddx / raios[i].dx : ddy / raios[i].dy;
+				if (k >= 1 && k <= raios[i].passos && ddx == k * raios[i].dx && ddy == k * raios[i].dy) c = '*';
+			}
+			printf(" %c", c);
+		}
+		printf("\n");
+	}
+}
+
+static int bench(int id, const DefPeca* def, const Ocupacao* o, long m) {
+	const Geometria* g = o->geo;
+	Posicao* pos = malloc((size_t)m * sizeof *pos);
+	if (!pos) {
+		fprintf(stderr, "Erro: sem memória.\n");
+		return 1;
+	}
+	Rng rng = { 0x853c49e6748fea9bULL };
+	for (long i = 0; i < m; i++) {
+		pos[i].x = (int32_t)(rng_proximo(&rng) % (uint64_t)g->largura);
+		pos[i].y = (int32_t)(rng_proximo(&rng) % (uint64_t)g->altura);
+	}
+	Raio raios[MOTOR_MAX_VETORES];
+	int64_t total_esp = 0, total_gen = 0;
+
+	double t0 = agora_seg();
+	if (id >= 0) {
+		for (long i = 0; i < m; i++)
+			total_esp += motor_destinos(raios, motor_gerar_id((IdPeca)id, o, pos[i], raios));
+	}
+	double t1 = agora_seg();
+	for (long i = 0; i < m; i++)
+		total_gen += motor_destinos(raios, motor_gerar(def, o, pos[i], raios));
+	double t2 = agora_seg();
+	free(pos);
+
+	double de = t1 - t0 > 0 ? t1 - t0 : 1e-9, dg = t2 - t1 > 0 ? t2 - t1 : 1e-9;
+	printf("%-14s %12s %14s %16s\n", "caminho", "gerações", "destinos", "gerações/s");
+	if (id >= 0) printf("%-14s %12ld %14lld %16.0f\n", "especializado", m, (long long)total_esp, (double)m / de);
+	printf("%-14s %12ld %14lld %16.0f\n", "genérico", m, (long long)total_gen, (double)m / dg);
+	if (id >= 0) {
+		printf("\nSpeedup do kernel especializado: %.2fx\n", dg / de);
+		if (total_esp != total_gen) {
+			fprintf(stderr, "Erro: caminhos divergem (%lld x %lld).\n", (long long)total_esp, (long long)total_gen);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	int64_t largura = 8, altura = 8, ix = -1, iy = -1;
+	long pecas = 0, semente = 1, m = 0;
+	const char* chave = NULL;
+	const char* spec = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strcmp(a, "--listar")) {
+			listar_pecas();
+			return 0;
+		} else if (!strncmp(a, "--peca=", 7)) {
+			chave = a + 7;
+		} else if (!strncmp(a, "--definir=", 10)) {
+			spec = a + 10;
+		} else if (!strncmp(a, "--tamanho=", 10) && parse_par(a + 10, 'x', &largura, &altura)) {
+		} else if (!strncmp(a, "--inicio=", 9) && parse_par(a + 9, ',', &ix, &iy)) {
+		} else if (!strncmp(a, "--pecas=", 8) && parse_long(a + 8, 0, 10000000L, &pecas)) {
+		} else if (!strncmp(a, "--semente=", 10) && parse_long(a + 10, 1, 2000000000L, &semente)) {
+		} else if (!strncmp(a, "--bench=", 8) && parse_long(a + 8, 1, 100000000L, &m)) {
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	DefPeca custom;
+	const DefPeca* def;
+	int id = -1;
+	if (spec) {
+		if (!motor_definir(&custom, "feérica", spec)) {
+			fprintf(stderr, "Erro: definição inválida '%s'.\n", spec);
+			return 1;
+		}
+		def = &custom;
+	} else if (chave && (id = motor_peca_de_chave(chave)) >= 0) {
+		def = &MOTOR_DEF[id];
+	} else {
+		if (chave) fprintf(stderr, "Erro: peça desconhecida '%s' (veja --listar).\n", chave);
+		usage(argv[0]);
+		return 1;
+	}
+
+	Geometria geo;
+	Ocupacao ocup;
+	if (!geometria_iniciar(&geo, largura, altura)) {
+		fprintf(stderr, "Erro: tamanho inválido.\n");
+		return 1;
+	}
+	if (ix < 0 && iy < 0) {
+		ix = largura / 2;
+		iy = altura / 2;
+	}
+	if (!geometria_dentro(&geo, ix, iy)) {
+		fprintf(stderr, "Erro: casa inicial fora do tabuleiro.\n");
+		return 1;
+	}
+	if (!ocupacao_iniciar(&ocup, &geo)) {
+		fprintf(stderr, "Erro: sem memória.\n");
+		return 1;
+	}
+	Posicao p = { (int32_t)ix, (int32_t)iy };
+	if ((uint64_t)pecas >= (uint64_t)largura * (uint64_t)altura) {
+		fprintf(stderr, "Erro: obstáculos demais para o tabuleiro.\n");
+		ocupacao_liberar(&ocup);
+		return 1;
+	}
+	Rng rng = rng_de_semente((uint64_t)semente);
+	while (ocup.qtd < (size_t)pecas) {
+		int64_t x = (int64_t)(rng_proximo(&rng) % (uint64_t)largura);
+		int64_t y = (int64_t)(rng_proximo(&rng) % (uint64_t)altura);
+		if (x != p.x || y != p.y) ocupacao_inserir(&ocup, x, y);
+	}
+
+	int rc = 0;
+	printf("=== MOTOR DE PEÇAS: %s (%d vetores) ===\n", def->nome, def->qtd);
+	printf("Tabuleiro %lldx%lld | Obstáculos: %zu\n\n", (long long)largura, (long long)altura, ocup.qtd);
+	if (m > 0) {
+		rc = bench(id, def, &ocup, m);
+	} else {
+		Raio raios[MOTOR_MAX_VETORES];
+		size_t n = id >= 0 ? motor_gerar_id((IdPeca)id, &ocup, p, raios) : motor_gerar(def, &ocup, p, raios);
+		if (largura <= 32 && altura <= 32) {
+			mostrar_mapa(&ocup, p, raios, n);
+			printf("\n");
+		}
+		printf("Casa (%d, %d): %lld destino(s)\n", p.x, p.y, (long long)motor_destinos(raios, n));
+		for (size_t i = 0; i < n; i++) {
+			if (raios[i].passos)
+				printf("  (%+d, %+d) x %lld\n", raios[i].dx, raios[i].dy, (long long)raios[i].passos);
+		}
+	}
+	ocupacao_liberar(&ocup);
+	return rc;
+}
@@ -0,0 +1,222 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "xadrez_util.h"
+
+// N-Rainhas por recursão com bitmasks de colunas e diagonais, a partir do
+// movimento da Rainha (linhas, colunas e diagonais atacadas).
+// - Redução por simetria: a rainha da 1ª linha só ocupa a metade esquerda
+//   (o espelho dobra a contagem); no N ímpar a coluna central é tratada à
+//   parte restringindo a 2ª linha.
+// - Paralelismo: os itens de trabalho são as posições das duas primeiras
+//   linhas, distribuídos entre threads por um contador atômico.
+// Uso: ./n_rainhas [N] [--threads=T] [--escala] [--listar=K]
+
+#define N_MAX 32
+#define MAX_THREADS 64
+
+typedef struct {
+	uint32_t cols, d1, d2;  // ocupação após as duas primeiras linhas
+	uint32_t peso;          // 2 se o espelho é contado implicitamente
+} Item;
+
+typedef struct {
+	const Item* itens;
+	size_t qtd;
+	uint32_t cheio;
+	atomic_size_t* proximo;
+	uint64_t nos;
+	uint64_t solucoes;
+} Trabalhador;
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s [N] [opções]\n"
+		"  N              tamanho do tabuleiro (1..%d, padrão 8)\n"
+		"  --threads=T    threads da busca (padrão 1)\n"
+		"  --escala       mede 1, 2, 4, ... T threads e mostra o speedup\n"
+		"  --listar=K     imprime as K primeiras soluções (busca completa)\n",
+		prog, N_MAX);
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ RECURSÃO COM BITMASKS
+
+ cols: colunas ocupadas; d1/d2: diagonais atacadas, já deslocadas para a
+ linha atual. Casas livres = ~(cols | d1 | d2); cada bit isolado é uma
+ rainha candidata. Caso base: todas as colunas ocupadas.
+────────────────────────────────────────────────────────────────────────────
+*/
+static uint64_t contar(uint32_t cols, uint32_t d1, uint32_t d2, uint32_t cheio, uint64_t* nos) {
+	if (cols == cheio) return 1;
+	uint64_t total = 0;
+	uint32_t livres = cheio & ~(cols | d1 | d2);
+	while (livres) {
+		uint32_t bit = livres & (0u - livres);
+		livres ^= bit;
+		(*nos)++;
+		total += contar(cols | bit, (d1 | bit) << 1, (d2 | bit) >> 1, cheio, nos);
+	}
+	return total;
+}
+
+// Monta os itens (linha 0, linha 1) com peso de simetria.
+static size_t gerar_itens(int n, Item* itens) {
+	uint32_t cheio = (n == 32) ? 0xFFFFFFFFu : ((1u << n) - 1);
+	size_t qtd = 0;
+	int meio = n / 2;
+	for (int c0 = 0; c0 < (n + 1) / 2; c0++) {
+		uint32_t b0 = 1u << c0;
+		int central = (n & 1) && c0 == meio;
+		uint32_t livres1 = cheio & ~(b0 | (b0 << 1) | (b0 >> 1));
+		if (n == 1) {
+			itens[qtd++] = (Item){ b0, 0, 0, 1 };
+			break;
+		}
+		for (int c1 = 0; c1 < n; c1++) {
+			uint32_t b1 = 1u << c1;
+			if (!(livres1 & b1)) continue;
+			if (central && c1 >= meio) continue; // espelho da metade esquerda
+			uint32_t cols = b0 | b1;
+			uint32_t d1 = (((b0 << 1) | b1) << 1) & cheio;
+			uint32_t d2 = ((b0 >> 1) | b1) >> 1;
+			itens[qtd++] = (Item){ cols, d1, d2, 2 };
+		}
+	}
+	return qtd;
+}
+
+static void* executar_trabalhador(void* arg) {
+	Trabalhador* w = arg;
+	for (;;) {
+		size_t i = atomic_fetch_add(w->proximo, 1);
+		if (i >= w->qtd) break;
+		const Item* it = &w->itens[i];
+		uint64_t nos = 0;
+		uint64_t s = contar(it->cols, it->d1, it->d2, w->cheio, &nos);
+		w->solucoes += s * it->peso;
+		w->nos += nos;
+	}
+	return NULL;
+}
+
+typedef struct {
+	uint64_t solucoes;
+	uint64_t nos;
+	double segundos;
+} Resultado;
+
+static Resultado resolver(int n, int threads) {
+	Resultado r = { 0, 0, 0 };
+	Item* itens = malloc((size_t)n * (size_t)n * sizeof *itens + sizeof *itens);
+	Trabalhador* ws = calloc((size_t)threads, sizeof *ws);
+	pthread_t* ids = calloc((size_t)threads, sizeof *ids);
+	if (!itens || !ws || !ids) {
+		fprintf(stderr, "Erro: sem memória.\n");
+		exit(1);
+	}
+	size_t qtd = gerar_itens(n, itens);
+	atomic_size_t proximo = 0;
+	uint32_t cheio = (n == 32) ? 0xFFFFFFFFu : ((1u << n) - 1);
+
+	double t0 = agora_seg();
+	int criadas = 0;
+	for (int i = 0; i < threads; i++) {
+		ws[i] = (Trabalhador){ .itens = itens, .qtd = qtd, .cheio = cheio, .proximo = &proximo };
+		if (pthread_create(&ids[criadas], NULL, executar_trabalhador, &ws[i]) == 0) criadas++;
+	}
+	// Os itens vêm de um contador comum: se nenhuma thread subiu, a main
+	// consome a fila inteira.
+	if (criadas == 0) executar_trabalhador(&ws[0]);
+	for (int i = 0; i < criadas; i++) pthread_join(ids[i], NULL);
+	for (int i = 0; i < threads; i++) {
+		r.solucoes += ws[i].solucoes;
+		r.nos += ws[i].nos;
+	}
+	r.segundos = agora_seg() - t0;
+	if (r.segundos <= 0) r.segundos = 1e-9;
+	free(itens);
+	free(ws);
+	free(ids);
+	return r;
+}
+
+// Busca completa, sem simetria, imprimindo as K primeiras soluções.
+static void listar(int n, uint32_t cheio, uint32_t cols, uint32_t d1, uint32_t d2,
+                   int linha, int* colunas, long* restantes) {
+	if (*restantes <= 0) return;
+	if (cols == cheio) {
+		for (int i = 0; i < n; i++) printf("%d%c", colunas[i] + 1, i + 1 < n ? ' ' : '\n');
+		(*restantes)--;
+		return;
+	}
+	uint32_t livres = cheio & ~(cols | d1 | d2);
+	while (livres && *restantes > 0) {
+		uint32_t bit = livres & (0u - livres);
+		livres ^= bit;
+		colunas[linha] = __builtin_ctz(bit);
+		listar(n, cheio, cols | bit, (d1 | bit) << 1, (d2 | bit) >> 1, linha + 1, colunas, restantes);
+	}
+}
+
+int main(int argc, char** argv) {
+	long n = 8, threads = 1, k = 0;
+	int escala = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--threads=", 10) && parse_long(a + 10, 1, MAX_THREADS, &threads)) {
+		} else if (!strcmp(a, "--escala")) {
+			escala = 1;
+		} else if (!strncmp(a, "--listar=", 9) && parse_long(a + 9, 0, 1L << 30, &k)) {
+		} else if (a[0] != '-' && parse_long(a, 1, N_MAX, &n)) {
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	printf("=== N-RAINHAS (bitmask) ===\n");
+	printf("N=%ld\n\n", n);
+
+	if (k > 0) {
+		int colunas[N_MAX];
+		long restantes = k;
+		uint32_t cheio = (n == 32) ? 0xFFFFFFFFu : ((1u << n) - 1);
+		printf("Primeiras %ld soluções (coluna da rainha em cada linha):\n", k);
+		listar((int)n, cheio, 0, 0, 0, 0, colunas, &restantes);
+		printf("\n");
+	}
+
+	if (!escala) {
+		Resultado r = resolver((int)n, (int)threads);
+		printf("Soluções: %llu\n", (unsigned long long)r.solucoes);
+		printf("Nós: %llu\n", (unsigned long long)r.nos);
+		printf("Threads: %ld | Tempo: %.3f s | Nós/s: %.0f\n", threads, r.segundos,
+			   (double)r.nos / r.segundos);
+		return 0;
+	}
+
+	printf("%8s %14s %16s %10s %14s %8s\n", "threads", "soluções", "nós", "tempo(s)", "nós/s", "speedup");
+	double base = 0;
+	// 1, 2, 4, ... e por fim o próprio T
+	for (long t = 1; t <= threads; t = (t < threads && t * 2 > threads) ? threads : t * 2) {
+		Resultado r = resolver((int)n, (int)t);
+		if (t == 1) base = r.segundos;
+		printf("%8ld %14llu %16llu %10.3f %14.0f %7.2fx\n", t,
+			   (unsigned long long)r.solucoes, (unsigned long long)r.nos,
+			   r.segundos, (double)r.nos / r.segundos, base / r.segundos);
+	}
+	return 0;
+}
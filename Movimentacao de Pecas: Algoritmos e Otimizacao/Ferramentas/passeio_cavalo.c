@@ -0,0 +1,399 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "xadrez_cavalo.h"
+#include "xadrez_saida.h"
+#include "xadrez_util.h"
+
+// Passeio do Cavalo sobre as tabelas de movimento em "L".
+// Modos:
+//   warnsdorff - primeira solução pela heurística de Warnsdorff (menor grau)
+//   contar     - backtracking exaustivo: conta todos os passeios abertos
+//   listar     - como contar, imprimindo até --limite passeios
+// O backtracking é dividido entre threads pelos prefixos de abertura.
+// Em tabuleiros com número ímpar de casas, partidas da cor minoritária
+// são recusadas antes da busca (não há passeio). --nos limita os nós
+// visitados: a busca para com erro em vez de rodar sem fim.
+// Uso: ./passeio_cavalo [--tamanho=5|5x6] [--inicio=a1] [--modo=...]
+//                       [--threads=N] [--profundidade=D] [--limite=K] [--fechados] [--nos=N]
+
+#define MAX_THREADS 64
+// 8^6 prefixos de 72 bytes = 18 MiB; acima disso a tabela explode (8^8 = 1,2 GB).
+#define MAX_PROFUNDIDADE 6
+#define NOS_WARNSDORFF_PADRAO 10000000L
+// O backtracking soma nós ao total compartilhado em lotes (limite aproximado).
+#define LOTE_NOS 65536
+
+typedef enum { MODO_WARNSDORFF, MODO_CONTAR, MODO_LISTAR } Modo;
+
+typedef struct {
+	int largura, altura;
+	int inicio;
+	Modo modo;
+	int threads;
+	int profundidade;  // passos do prefixo usado para dividir o trabalho
+	long limite;       // passeios impressos no modo listar
+	int fechados;      // conta apenas passeios fechados (reentrantes)
+	long nos_max;      // limite de nós visitados (0 = sem limite)
+} Config;
+
+typedef struct {
+	uint8_t caminho[TAB_MAX_CASAS];
+	uint64_t visitadas;
+} Prefixo;
+
+typedef struct {
+	const TabelaCavalo* tab;
+	const Config* cfg;
+	const Prefixo* prefixos;
+	size_t qtd_prefixos;
+	atomic_size_t* proximo;
+	atomic_long* impressos;
+	pthread_mutex_t* trava_saida;
+	Saida* saida;
+	atomic_ullong* nos_total;   // nós já somados por todas as threads
+	atomic_int* esgotado;       // 1 quando --nos foi atingido
+
+	// resultados da thread
+	uint64_t nos;
+	uint64_t solucoes;
+	uint8_t caminho[TAB_MAX_CASAS];
+} Trabalhador;
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s [opções]\n"
+		"  --tamanho=N | NxM        tabuleiro (1..8, padrão 5)\n"
+		"  --inicio=<casa>          casa inicial (padrão a1)\n"
+		"  --modo=warnsdorff|contar|listar (padrão warnsdorff)\n"
+		"  --threads=N              threads do backtracking (padrão 1)\n"
+		"  --profundidade=D         passos do prefixo de divisão (0..%d, padrão 3)\n"
+		"  --limite=K               passeios impressos em 'listar' (padrão 10)\n"
+		"  --fechados               considera apenas passeios fechados\n"
+		"  --nos=N                  limite de nós visitados (0 = sem limite; padrão\n"
+		"                           %ld em warnsdorff, sem limite em contar/listar)\n",
+		prog, MAX_PROFUNDIDADE, NOS_WARNSDORFF_PADRAO);
+}
+
+static inline int popcount64(uint64_t v) {
+	return __builtin_popcountll(v);
+}
+
+/* ─────────────────────────────────────────────────────────────────────────
+   WARNSDORFF: sempre salta para a casa com menos saídas livres.
+   Empate: menor soma dos graus das saídas (desempate de Pohl).
+   Se a heurística cair num beco sem saída, recua e tenta o próximo
+   candidato na mesma ordem. Onde há passeio ela recua pouco; onde não há
+   (4x4, ou uma casa sem saída), o recuo vira busca exaustiva, então a
+   busca para em 'limite' nós (0 = sem limite).
+   Retorna 1 (passeio em caminho), 0 (não há) ou -1 (limite esgotado).
+   ───────────────────────────────────────────────────────────────────────── */
+static int warnsdorff(const TabelaCavalo* t, int atual, uint64_t visitadas, int passo,
+                      uint8_t* caminho, uint64_t* nos, uint64_t* recuos, uint64_t limite) {
+	if (limite && *nos >= limite) return -1;
+	(*nos)++;
+	if (passo == t->casas) return 1;
+
+	int cand[CAVALO_DIRECOES], chave[CAVALO_DIRECOES], q = 0;
+	uint64_t livres = t->mascara[atual] & ~visitadas;
+	while (livres) {
+		int c = __builtin_ctzll(livres);
+		livres &= livres - 1;
+		uint64_t saidas = t->mascara[c] & ~visitadas;
+		if (!saidas && passo + 1 < t->casas) continue; // beco sem saída antecipado
+		int soma = 0;
+		for (uint64_t r = saidas; r; r &= r - 1)
+			soma += popcount64(t->mascara[__builtin_ctzll(r)] & ~visitadas & ~(1ULL << c));
+		int k = popcount64(saidas) * 64 + soma; // grau primeiro, soma desempata
+		int j = q++;
+		for (; j > 0 && chave[j - 1] > k; j--) {
+			cand[j] = cand[j - 1];
+			chave[j] = chave[j - 1];
+		}
+		cand[j] = c;
+		chave[j] = k;
+	}
+	for (int i = 0; i < q; i++) {
+		caminho[passo] = (uint8_t)cand[i];
+		int r = warnsdorff(t, cand[i], visitadas | (1ULL << cand[i]), passo + 1, caminho, nos, recuos, limite);
+		if (r) return r;
+		(*recuos)++;
+	}
+	return 0;
+}
+
+/* ─────────────────────────────────────────────────────────────────────────
+   BACKTRACKING EXAUSTIVO
+   ───────────────────────────────────────────────────────────────────────── */
+static void imprimir_caminho(Trabalhador* w, const uint8_t* caminho) {
+	const TabelaCavalo* t = w->tab;
+	char nome[3];
+	pthread_mutex_lock(w->trava_saida);
+	for (int i = 0; i < t->casas; i++) {
+		nome_casa_tab(t, caminho[i], nome);
+		saida_escrever(w->saida, nome, 2);
+		saida_escrever(w->saida, i + 1 < t->casas ? " " : "\n", 1);
+	}
+	pthread_mutex_unlock(w->trava_saida);
+}
+
+static void buscar(Trabalhador* w, int atual, uint64_t visitadas, int passo) {
+	const TabelaCavalo* t = w->tab;
+	if (atomic_load_explicit(w->esgotado, memory_order_relaxed)) return;
+	if ((++w->nos & (LOTE_NOS - 1)) == 0 && w->cfg->nos_max &&
+	    atomic_fetch_add_explicit(w->nos_total, LOTE_NOS, memory_order_relaxed) + LOTE_NOS >= (unsigned long long)w->cfg->nos_max) {
+		atomic_store_explicit(w->esgotado, 1, memory_order_relaxed);
+		return;
+	}
+	if (passo == t->casas) {
+		if (w->cfg->fechados && !(t->mascara[atual] & (1ULL << w->caminho[0]))) return;
+		w->solucoes++;
+		if (w->cfg->modo == MODO_LISTAR && atomic_fetch_add(w->impressos, 1) < w->cfg->limite)
+			imprimir_caminho(w, w->caminho);
+		return;
+	}
+	uint64_t livres = t->mascara[atual] & ~visitadas;
+	while (livres) {
+		int c = __builtin_ctzll(livres);
+		livres &= livres - 1;
+		w->caminho[passo] = (uint8_t)c;
+		buscar(w, c, visitadas | (1ULL << c), passo + 1);
+	}
+}
+
+static void* executar_trabalhador(void* arg) {
+	Trabalhador* w = arg;
+	int prof = w->cfg->profundidade;
+	for (;;) {
+		if (atomic_load_explicit(w->esgotado, memory_order_relaxed)) break;
+		size_t i = atomic_fetch_add(w->proximo, 1);
+		if (i >= w->qtd_prefixos) break;
+		const Prefixo* p = &w->prefixos[i];
+		memcpy(w->caminho, p->caminho, (size_t)prof + 1);
+		buscar(w, p->caminho[prof], p->visitadas, prof + 1);
+	}
+	return NULL;
+}
+
+// Enumera todos os caminhos de 'prof' passos a partir do início.
+static void gerar_prefixos(const TabelaCavalo* t, Prefixo* atual, int passo, int prof,
+                           Prefixo* lista, size_t* qtd) {
+	if (passo == prof) {
+		lista[(*qtd)++] = *atual;
+		return;
+	}
+	uint64_t livres = t->mascara[atual->caminho[passo]] & ~atual->visitadas;
+	while (livres) {
+		int c = __builtin_ctzll(livres);
+		livres &= livres - 1;
+		atual->caminho[passo + 1] = (uint8_t)c;
+		atual->visitadas |= 1ULL << c;
+		gerar_prefixos(t, atual, passo + 1, prof, lista, qtd);
+		atual->visitadas &= ~(1ULL << c);
+	}
+}
+
+static int rodar_backtracking(const TabelaCavalo* t, const Config* cfg) {
+	// Cada casa tem no máximo 8 saltos: 8^prof (prof <= MAX_PROFUNDIDADE)
+	// limita o número de prefixos.
+	size_t cap = 1;
+	for (int i = 0; i < cfg->profundidade; i++) cap *= CAVALO_DIRECOES;
+	Prefixo* prefixos = malloc(cap * sizeof *prefixos);
+	Trabalhador* ws = calloc((size_t)cfg->threads, sizeof *ws);
+	pthread_t* ids = calloc((size_t)cfg->threads, sizeof *ids);
+	if (!prefixos || !ws || !ids) {
+		fprintf(stderr, "Erro: sem memória para %zu prefixos.\n", cap);
+		free(prefixos);
+		free(ws);
+		free(ids);
+		return 1;
+	}
+
+	Prefixo raiz = { .visitadas = 1ULL << cfg->inicio };
+	raiz.caminho[0] = (uint8_t)cfg->inicio;
+	size_t qtd = 0;
+	gerar_prefixos(t, &raiz, 0, cfg->profundidade, prefixos, &qtd);
+
+	Saida saida;
+	if (!saida_abrir(&saida, 1, SAIDA_CAP_PADRAO)) {
+		fprintf(stderr, "Erro: sem memória para o buffer de saída.\n");
+		free(prefixos);
+		free(ws);
+		free(ids);
+		return 1;
+	}
+	atomic_size_t proximo = 0;
+	atomic_long impressos = 0;
+	atomic_ullong nos_total = 0;
+	atomic_int esgotado = 0;
+	pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+	double t0 = agora_seg();
+	int criadas = 0;
+	for (int i = 0; i < cfg->threads; i++) {
+		ws[i] = (Trabalhador){
+			.tab = t, .cfg = cfg, .prefixos = prefixos, .qtd_prefixos = qtd,
+			.proximo = &proximo, .impressos = &impressos,
+			.trava_saida = &trava, .saida = &saida,
+			.nos_total = &nos_total, .esgotado = &esgotado
+		};
+		if (pthread_create(&ids[criadas], NULL, executar_trabalhador, &ws[i]) == 0) criadas++;
+	}
+	// Os prefixos saem de um contador comum: sem thread nenhuma, a própria
+	// main esgota a fila (resultado igual, só mais lento).
+	if (criadas == 0) {
+		fprintf(stderr, "Aviso: nenhuma thread criada; busca na thread principal.\n");
+		executar_trabalhador(&ws[0]);
+	}
+	uint64_t nos = 0, solucoes = 0;
+	for (int i = 0; i < criadas; i++) pthread_join(ids[i], NULL);
+	for (int i = 0; i < cfg->threads; i++) {
+		nos += ws[i].nos;
+		solucoes += ws[i].solucoes;
+	}
+	double dt = agora_seg() - t0;
+	saida_fechar(&saida);
+	if (dt <= 0) dt = 1e-9;
+
+	printf("Passeios %s: %llu\n", cfg->fechados ? "fechados" : "encontrados",
+		   (unsigned long long)solucoes);
+	printf("Prefixos de abertura: %zu (profundidade %d)\n", qtd, cfg->profundidade);
+	for (int i = 0; i < cfg->threads; i++) {
+		printf("  thread %d: %llu nós, %llu passeios\n", i,
+			   (unsigned long long)ws[i].nos, (unsigned long long)ws[i].solucoes);
+	}
+	printf("Nós visitados: %llu\n", (unsigned long long)nos);
+	printf("Tempo: %.3f s | Nós/s: %.0f\n", dt, (double)nos / dt);
+
+	free(prefixos);
+	free(ws);
+	free(ids);
+	if (esgotado) {
+		fprintf(stderr, "Erro: limite de %ld nós esgotado; contagem parcial (aumente --nos ou use --nos=0).\n",
+			cfg->nos_max);
+		return 1;
+	}
+	return 0;
+}
+
+static int rodar_warnsdorff(const TabelaCavalo* t, const Config* cfg) {
+	uint8_t caminho[TAB_MAX_CASAS];
+	int ordem[TAB_MAX_CASAS];
+	uint64_t nos = 0;
+	uint64_t recuos = 0;
+	double t0 = agora_seg();
+	caminho[0] = (uint8_t)cfg->inicio;
+	int achou = warnsdorff(t, cfg->inicio, 1ULL << cfg->inicio, 1, caminho, &nos, &recuos, (uint64_t)cfg->nos_max);
+	double dt = agora_seg() - t0;
+	if (dt <= 0) dt = 1e-9;
+
+	if (achou < 0) {
+		fprintf(stderr, "Erro: limite de %ld nós esgotado sem passeio (%llu recuos); aumente --nos ou use --nos=0.\n",
+			cfg->nos_max, (unsigned long long)recuos);
+		return 1;
+	}
+	if (!achou) {
+		printf("Nenhum passeio a partir desta casa (%llu nós).\n", (unsigned long long)nos);
+		return 2;
+	}
+	for (int i = 0; i < t->casas; i++) ordem[caminho[i]] = i + 1;
+	for (int lin = t->altura - 1; lin >= 0; lin--) {
+		printf("%d ", lin + 1);
+		for (int col = 0; col < t->largura; col++) printf(" %3d", ordem[lin * t->largura + col]);
+		printf("\n");
+	}
+	printf("  ");
+	for (int col = 0; col < t->largura; col++) printf("   %c", 'a' + col);
+	printf("\n");
+	int fechado = (t->mascara[caminho[t->casas - 1]] >> caminho[0]) & 1;
+	printf("Passeio %s com %d casas (recuos: %llu)\n", fechado ? "fechado" : "aberto",
+		   t->casas, (unsigned long long)recuos);
+	printf("Tempo: %.6f s | Nós/s: %.0f\n", dt, (double)nos / dt);
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	Config cfg = { 5, 5, 0, MODO_WARNSDORFF, 1, 3, 10, 0, -1 };
+	const char* inicio = "a1";
+	long v;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--tamanho=", 10)) {
+			// Só "N" ou "LxA": nada antes do 'x' além de L, nada depois de A.
+			long l = 0, h = 0;
+			const char* x = strchr(a + 10, 'x');
+			int valido = x ? parse_long_ate(a + 10, 1, TAB_MAX_LADO, &l, 'x') && parse_long(x + 1, 1, TAB_MAX_LADO, &h)
+			               : parse_long(a + 10, 1, TAB_MAX_LADO, &l);
+			if (!valido) {
+				fprintf(stderr, "Erro: tamanho inválido '%s'.\n", a + 10);
+				return 1;
+			}
+			cfg.largura = (int)l;
+			cfg.altura = x ? (int)h : (int)l;
+		} else if (!strncmp(a, "--inicio=", 9)) {
+			inicio = a + 9;
+		} else if (!strcmp(a, "--modo=warnsdorff")) {
+			cfg.modo = MODO_WARNSDORFF;
+		} else if (!strcmp(a, "--modo=contar")) {
+			cfg.modo = MODO_CONTAR;
+		} else if (!strcmp(a, "--modo=listar")) {
+			cfg.modo = MODO_LISTAR;
+		} else if (!strncmp(a, "--threads=", 10) && parse_long(a + 10, 1, MAX_THREADS, &v)) {
+			cfg.threads = (int)v;
+		} else if (!strncmp(a, "--profundidade=", 15) && parse_long(a + 15, 0, MAX_PROFUNDIDADE, &v)) {
+			cfg.profundidade = (int)v;
+		} else if (!strncmp(a, "--limite=", 9) && parse_long(a + 9, 0, 1L << 30, &v)) {
+			cfg.limite = v;
+		} else if (!strcmp(a, "--fechados")) {
+			cfg.fechados = 1;
+		} else if (!strncmp(a, "--nos=", 6) && parse_long(a + 6, 0, LONG_MAX, &v)) {
+			cfg.nos_max = v;
+		} else {
+			fprintf(stderr, "Erro: opção inválida '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	TabelaCavalo tab;
+	tabela_cavalo_iniciar(&tab, cfg.largura, cfg.altura);
+	cfg.inicio = casa_tab_de_nome(&tab, inicio);
+	if (cfg.inicio < 0) {
+		fprintf(stderr, "Erro: casa inicial '%s' fora do tabuleiro %dx%d.\n",
+				inicio, cfg.largura, cfg.altura);
+		return 1;
+	}
+	// O prefixo não pode cobrir o passeio inteiro.
+	if (cfg.profundidade > tab.casas - 1) cfg.profundidade = tab.casas - 1;
+	if (cfg.nos_max < 0) cfg.nos_max = cfg.modo == MODO_WARNSDORFF ? NOS_WARNSDORFF_PADRAO : 0;
+
+	printf("=== PASSEIO DO CAVALO ===\n");
+	printf("Tabuleiro %dx%d, início %s, modo %s, threads %d\n\n",
+		   cfg.largura, cfg.altura, inicio,
+		   cfg.modo == MODO_WARNSDORFF ? "warnsdorff" : cfg.modo == MODO_CONTAR ? "contar" : "listar",
+		   cfg.modo == MODO_WARNSDORFF ? 1 : cfg.threads);
+	fflush(stdout);
+
+	// Cada salto troca a cor da casa: com um número ímpar de casas o passeio
+	// tem uma casa a mais da cor de partida, que então tem de ser a
+	// majoritária (a de a1). Da outra cor a busca só provaria isso devagar.
+	int cor_inicio = (cfg.inicio % cfg.largura + cfg.inicio / cfg.largura) & 1;
+	if (tab.casas % 2 == 1 && cor_inicio) {
+		printf("Nenhum passeio a partir desta casa: em %dx%d (%d casas) o passeio começa\n"
+			   "numa casa da cor de a1, que tem uma casa a mais.\n", cfg.largura, cfg.altura, tab.casas);
+		return 2;
+	}
+
+	if (cfg.modo == MODO_WARNSDORFF) return rodar_warnsdorff(&tab, &cfg);
+	return rodar_backtracking(&tab, &cfg);
+}
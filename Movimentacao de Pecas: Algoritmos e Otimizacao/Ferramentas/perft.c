@@ -0,0 +1,178 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xadrez_estado.h"
+#include "xadrez_fen.h"
+#include "xadrez_lances.h"
+#include "xadrez_util.h"
+
+// Contagem de nós do gerador de lances legais (perft): quantas sequências
+// de 'profundidade' lances existem a partir da posição. Os totais de
+// posições conhecidas validam roques, en passant, promoções e cravadas.
+// Com --incremental a árvore é percorrida com fazer/desfazer sobre um
+// Estado (chave Zobrist e mapas de ataque incrementais, xadrez_estado.h)
+// em vez de copiar o tabuleiro; --conferir recalcula tudo do zero depois de
+// cada fazer e de cada desfazer e para na primeira divergência.
+// --bench-fazer=M mede pares fazer/desfazer por segundo contra cópia +
+// recálculo completo.
+// Uso: ./perft <profundidade> [--fen="..."] [--divide] [--incremental] [--conferir] [--stats]
+//      ./perft --bench-fazer=M [--fen="..."]
+
+#define MAX_PROFUNDIDADE 10
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s <profundidade> [--fen=\"...\"] [--divide] [--incremental] [--conferir] [--stats]\n"
+		"     %s --bench-fazer=M [--fen=\"...\"]\n",
+		prog, prog);
+}
+
+static int conferir;
+
+static void divergencia(const Estado* e, Lance l, const char* etapa) {
+	char fen[FEN_MAX];
+	fen_escrever(&e->t, fen);
+	fprintf(stderr, "Divergência depois de %s %c%c%c%c: %s\n", etapa, 'a' + l.de % 8, '1' + l.de / 8,
+			'a' + l.para % 8, '1' + l.para / 8, fen);
+	exit(1);
+}
+
+static uint64_t perft_incremental(Estado* e, int profundidade) {
+	if (profundidade <= 0) return 1;
+	ListaLances lista;
+	int n = gerar_lances(&e->t, &lista);
+	if (profundidade == 1 && !conferir) return (uint64_t)n;
+	uint64_t total = 0;
+	for (int i = 0; i < n; i++) {
+		Desfazer d;
+		estado_fazer(e, lista.l[i], &d);
+		if (conferir && !estado_conferir(e)) divergencia(e, lista.l[i], "fazer");
+		total += perft_incremental(e, profundidade - 1);
+		estado_desfazer(e, &d);
+		if (conferir && !estado_conferir(e)) divergencia(e, lista.l[i], "desfazer");
+	}
+	return total;
+}
+
+// Pares fazer/desfazer por segundo sobre os lances legais da posição,
+// contra a alternativa sem estado incremental: copiar o tabuleiro, aplicar
+// e recalcular chave e mapas de ataque do zero.
+static int bench_fazer(const Tabuleiro* t, long m) {
+	ListaLances lista;
+	if (!gerar_lances(t, &lista)) {
+		fprintf(stderr, "Erro: posição sem lances legais.\n");
+		return 1;
+	}
+	Estado e;
+	estado_iniciar(&e, t);
+	uint64_t soma = 0;
+	double t0 = agora_seg();
+	for (long i = 0; i < m; i++) {
+		Desfazer d;
+		estado_fazer(&e, lista.l[i % lista.n], &d);
+		soma += e.chave ^ e.atacadas[0];
+		estado_desfazer(&e, &d);
+	}
+	double dt_inc = agora_seg() - t0;
+
+	t0 = agora_seg();
+	for (long i = 0; i < m; i++) {
+		Tabuleiro copia = *t;
+		aplicar_lance(&copia, lista.l[i % lista.n]);
+		Estado recalculado;
+		estado_iniciar(&recalculado, &copia);
+		soma -= recalculado.chave ^ recalculado.atacadas[0];
+	}
+	double dt_rec = agora_seg() - t0;
+	if (dt_inc <= 0) dt_inc = 1e-9;
+	if (dt_rec <= 0) dt_rec = 1e-9;
+
+	printf("Pares fazer/desfazer: %ld\n", m);
+	printf("Incremental: %.0f pares/s\n", (double)m / dt_inc);
+	printf("Cópia + recálculo: %.0f pares/s\n", (double)m / dt_rec);
+	printf("Aceleração: %.2fx\n", dt_rec / dt_inc);
+	// As duas somas se cancelam se os estados conferem.
+	printf("Conferência: %s\n", soma == 0 ? "ok" : "DIVERGENTE");
+	return soma == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+	const char* fen = FEN_INICIAL;
+	long profundidade = -1, bench = -1;
+	int divide = 0, stats = 0, incremental = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--fen=", 6)) {
+			fen = a + 6;
+		} else if (!strcmp(a, "--divide")) {
+			divide = 1;
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (!strcmp(a, "--incremental")) {
+			incremental = 1;
+		} else if (!strcmp(a, "--conferir")) {
+			incremental = conferir = 1;
+		} else if (!strncmp(a, "--bench-fazer=", 14) && parse_long(a + 14, 1, 2000000000L, &bench)) {
+		} else if (profundidade < 0 && parse_long(a, 1, MAX_PROFUNDIDADE, &profundidade)) {
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (profundidade < 0 && bench < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	Tabuleiro t;
+	FenErro e = fen_ler(&t, fen, fen + strlen(fen));
+	if (e != FEN_OK) {
+		fprintf(stderr, "Erro: FEN inválida (%s).\n", fen_erro_msg(e));
+		return 1;
+	}
+	if (bench >= 0) return bench_fazer(&t, bench);
+	Estado est;
+	estado_iniciar(&est, &t);
+
+	double t0 = agora_seg();
+	uint64_t total = 0;
+	if (divide) {
+		// Um total por lance da raiz, em notação de coordenadas (e2e4, e7e8q).
+		ListaLances lista;
+		gerar_lances(&t, &lista);
+		for (int i = 0; i < lista.n; i++) {
+			Lance l = lista.l[i];
+			uint64_t n;
+			if (incremental) {
+				Desfazer d;
+				estado_fazer(&est, l, &d);
+				n = perft_incremental(&est, (int)profundidade - 1);
+				estado_desfazer(&est, &d);
+			} else {
+				Tabuleiro filho = t;
+				aplicar_lance(&filho, l);
+				n = perft(&filho, (int)profundidade - 1);
+			}
+			total += n;
+			printf("%c%c%c%c%s: %llu\n", 'a' + l.de % 8, '1' + l.de / 8, 'a' + l.para % 8, '1' + l.para / 8,
+				   l.promocao ? (const char*[]){ "", "n", "b", "r", "q" }[l.promocao] : "",
+				   (unsigned long long)n);
+		}
+	} else {
+		total = incremental ? perft_incremental(&est, (int)profundidade) : perft(&t, (int)profundidade);
+	}
+	double dt = agora_seg() - t0;
+	if (dt <= 0) dt = 1e-9;
+
+	printf("Nós: %llu\n", (unsigned long long)total);
+	if (stats) fprintf(stderr, "[stats] profundidade=%ld tempo=%.3fs nós/s=%.0f\n", profundidade, dt, (double)total / dt);
+	return 0;
+}
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+// Recursão vs iteração medidas sobre as próprias funções de
+// xadrez_completo.c (incluído aqui com NO_OUTPUT: o passo vai para um
+// sumidouro nulo, sem formatação nem write). Para cada par e cada n em
+// 1, 10, ..., --max, mede ns/passo (melhor de 3 amostras), e para cada
+// função a pilha gasta por nível: uma sonda lê o endereço do quadro a cada
+// passo, e a distância entre o primeiro e o último passo dividida por
+// n - 1 dá os bytes por quadro. 0 B/quadro = o compilador eliminou a
+// chamada de cauda e a recursão virou laço.
+// O mesmo fonte é compilado em -O0, -O2 e -O3 (bin/recursao_iteracao_O*).
+// Uso: ./recursao_iteracao_O2 [--max=N] [--pilha-max=MiB]
+
+#define NO_OUTPUT
+#define XADREZ_COMPLETO_SEM_MAIN
+#include "xadrez_completo.c"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "xadrez_util.h"
+
+#ifndef NIVEL_OTIMIZACAO
+#define NIVEL_OTIMIZACAO "?"
+#endif
+
+#define N_MAX_PADRAO 10000000L
+#define PASSOS_POR_AMOSTRA 4000000L
+#define AMOSTRAS 3
+#define N_SONDA 1000
+
+typedef void (*FuncaoPeca)(int n);
+
+// O Cavalo recebe (vertical, horizontal): n passos = n - 1 verticais + 1
+// horizontal.
+static void cavalo_aninhados_n(int n) {
+	cavalo_loops_aninhados(n - 1, 1);
+}
+
+static void cavalo_complexos_n(int n) {
+	cavalo_loops_complexos(n - 1, 1);
+}
+
+typedef struct {
+	const char* nome[2];
+	FuncaoPeca funcao[2];
+} Par;
+
+static const Par PARES[] = {
+	{ { "torre_for", "torre_recursiva" }, { torre_for, torre_recursiva } },
+	{ { "bispo_while", "bispo_recursivo" }, { bispo_while, bispo_recursivo } },
+	{ { "rainha_dowhile", "rainha_recursiva" }, { rainha_dowhile, rainha_recursiva } },
+	{ { "cavalo_loops_aninhados", "cavalo_loops_complexos" }, { cavalo_aninhados_n, cavalo_complexos_n } },
+};
+
+static uintptr_t pilha_primeira, pilha_ultima;
+static unsigned long long sondagens;
+
+// Fora de linha para ficar um quadro abaixo de quem registrou o passo.
+__attribute__((noinline)) static void sondar(void) {
+	uintptr_t a = (uintptr_t)__builtin_frame_address(0);
+	if (sondagens++ == 0) pilha_primeira = a;
+	pilha_ultima = a;
+}
+
+// Bytes de pilha por passo (0 se a profundidade não cresce com n).
+static long bytes_por_quadro(FuncaoPeca f) {
+	sondagens = 0;
+	sonda_pilha = sondar;
+	posicionar_peca(INICIO_TORRE);
+	f(N_SONDA);
+	sonda_pilha = NULL;
+	if (sondagens != N_SONDA || pilha_ultima >= pilha_primeira) return 0;
+	return (long)((pilha_primeira - pilha_ultima) / (N_SONDA - 1));
+}
+
+typedef struct {
+	FuncaoPeca f;
+	long n;
+	double ns_passo;
+} Medida;
+
+// Roda na thread de pilha dimensionada: melhor de AMOSTRAS, cada uma com
+// repetições suficientes para PASSOS_POR_AMOSTRA passos.
+static void* medir(void* arg) {
+	Medida* m = arg;
+	long reps = PASSOS_POR_AMOSTRA / m->n;
+	if (reps < 1) reps = 1;
+	m->ns_passo = 0;
+	for (int a = 0; a < AMOSTRAS; a++) {
+		unsigned long long antes = passos_sumidouro;
+		double t0 = agora_seg();
+		for (long r = 0; r < reps; r++) {
+			posicionar_peca(INICIO_TORRE);
+			m->f((int)m->n);
+		}
+		double dt = agora_seg() - t0;
+		double ns = dt * 1e9 / (double)(passos_sumidouro - antes);
+		if (a == 0 || ns < m->ns_passo) m->ns_passo = ns;
+	}
+	return NULL;
+}
+
+// Mede f em n passos numa thread com pilha para n quadros; -1 se a pilha
+// necessária passa de pilha_max.
+static double ns_por_passo(FuncaoPeca f, long n, long quadro, size_t pilha_max) {
+	size_t pilha = (size_t)n * (size_t)quadro + ((size_t)n * (size_t)quadro) / 4 + (8u << 20);
+	if (pilha > pilha_max) return -1;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, pilha);
+	Medida m = { f, n, 0 };
+	pthread_t t;
+	int erro = pthread_create(&t, &attr, medir, &m);
+	pthread_attr_destroy(&attr);
+	if (erro) return -1;
+	pthread_join(t, NULL);
+	return m.ns_passo;
+}
+
+static void imprimir_ns(double ns) {
+	if (ns < 0) printf("  %20s", "pilha insuficiente");
+	else printf("  %20.2f", ns);
+}
+
+int main(int argc, char** argv) {
+	long n_max = N_MAX_PADRAO, pilha_mib = 1024;
+	for (int i = 1; i < argc; i++) {
+		if (!strncmp(argv[i], "--max=", 6) && parse_long(argv[i] + 6, 1, 100000000L, &n_max)) {
+		} else if (!strncmp(argv[i], "--pilha-max=", 12) && parse_long(argv[i] + 12, 8, 65536, &pilha_mib)) {
+		} else {
+			fprintf(stderr, "Uso: %s [--max=N] [--pilha-max=MiB]\n", argv[0]);
+			return 1;
+		}
+	}
+	size_t pilha_max = (size_t)pilha_mib << 20;
+
+	printf("=== Recursão vs iteração (%s, saída nula) ===\n", NIVEL_OTIMIZACAO);
+	for (size_t p = 0; p < sizeof PARES / sizeof PARES[0]; p++) {
+		const Par* par = &PARES[p];
+		long quadro[2];
+		printf("\n%s x %s\n", par->nome[0], par->nome[1]);
+		for (int k = 0; k < 2; k++) {
+			quadro[k] = bytes_por_quadro(par->funcao[k]);
+			printf("  %-24s pilha: %3ld B/quadro  %s\n", par->nome[k], quadro[k],
+				   quadro[k] ? "recursão mantida (pilha O(n))" : "sem crescimento de pilha (laço)");
+		}
+		printf("  %10s  %20s  %20s  %8s\n", "n", "ns/passo (1ª)", "ns/passo (2ª)", "razão");
+		for (long n = 1; n <= n_max; n *= 10) {
+			double ns[2];
+			for (int k = 0; k < 2; k++) ns[k] = ns_por_passo(par->funcao[k], n, quadro[k], pilha_max);
+			printf("  %10ld", n);
+			imprimir_ns(ns[0]);
+			imprimir_ns(ns[1]);
+			if (ns[0] > 0 && ns[1] > 0) printf("  %7.2fx", ns[1] / ns[0]);
+			printf("\n");
+		}
+	}
+	return 0;
+}
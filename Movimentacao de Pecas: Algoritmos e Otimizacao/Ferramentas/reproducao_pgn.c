@@ -0,0 +1,428 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "xadrez_fen.h"
+#include "xadrez_lances.h"
+#include "xadrez_saida.h"
+#include "xadrez_util.h"
+
+// Reprodução e validação de arquivos PGN inteiros: cada lance SAN é
+// resolvido contra o gerador de lances legais e aplicado; a partida que
+// tiver um lance ilegal, ambíguo ou malformado é marcada e o resto dela é
+// ignorado. O arquivo é mapeado com mmap e dividido em T fatias cortadas
+// no início de uma seção de tags (fronteira de partida); cada thread
+// reproduz as suas partidas e os números de partida/linha globais saem de
+// somas das fatias anteriores depois do join, como em carga_fen.
+// Uso: ./reproducao_pgn <arquivo> [--threads=T] [--stats]
+//      ./reproducao_pgn --gerar=N [--semente=S]   (N partidas aleatórias)
+
+#define MAX_THREADS 64
+#define MAX_ERROS_EXIBIDOS 10
+#define MAX_SAN_ERRO 16
+
+// Motivos de rejeição: os de SanResultado e mais a FEN da tag [FEN].
+#define MOTIVO_FEN (SAN_AMBIGUO + 1)
+
+static const char* const MSG_MOTIVO[] = {
+	[SAN_SINTAXE] = "lance malformado",
+	[SAN_ILEGAL] = "lance ilegal",
+	[SAN_AMBIGUO] = "lance ambíguo",
+	[MOTIVO_FEN] = "tag FEN inválida",
+};
+
+typedef struct {
+	uint64_t jogo;        // local à fatia (1-based)
+	const char* onde;     // início do lance no arquivo (linha calculada depois)
+	uint32_t lance;
+	uint8_t pretas;
+	uint8_t motivo;
+	char san[MAX_SAN_ERRO];
+} ErroJogo;
+
+typedef struct {
+	const char* ini;
+	const char* fim;
+	uint64_t jogos;
+	uint64_t lances;
+	uint64_t ilegais;
+	ErroJogo primeiros[MAX_ERROS_EXIBIDOS];
+	int qtd_primeiros;
+} Fatia;
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s <arquivo> [--threads=T] [--stats]\n"
+		"     %s --gerar=N [--semente=S]\n",
+		prog, prog);
+}
+
+static inline int eh_espaco(char c) {
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline const char* pular_espacos(const char* p, const char* fim) {
+	while (p < fim && eh_espaco(*p)) p++;
+	return p;
+}
+
+static inline const char* fim_da_linha(const char* p, const char* fim) {
+	const char* nl = memchr(p, '\n', (size_t)(fim - p));
+	return nl ? nl : fim;
+}
+
+// Token de resultado ("1-0", "0-1", "1/2-1/2", "*") em p? Retorna o tamanho.
+static size_t resultado(const char* p, const char* fim) {
+	size_t resto = (size_t)(fim - p);
+	size_t n = 0;
+	if (resto >= 1 && p[0] == '*') n = 1;
+	else if (resto >= 3 && (!memcmp(p, "1-0", 3) || !memcmp(p, "0-1", 3))) n = 3;
+	else if (resto >= 7 && !memcmp(p, "1/2-1/2", 7)) n = 7;
+	return n && (n == resto || eh_espaco(p[n])) ? n : 0;
+}
+
+// Pula um comentário/variação que começa em p. Variações "( ... )" podem
+// ter comentários e outras variações dentro.
+static const char* pular_comentario(const char* p, const char* fim) {
+	if (*p == '{') {
+		const char* f = memchr(p, '}', (size_t)(fim - p));
+		return f ? f + 1 : fim;
+	}
+	if (*p == ';') return fim_da_linha(p, fim);
+	int nivel = 0;
+	for (; p < fim; p++) {
+		if (*p == '{') {
+			p = pular_comentario(p, fim) - 1;
+		} else if (*p == '(') {
+			nivel++;
+		} else if (*p == ')' && --nivel == 0) {
+			return p + 1;
+		}
+	}
+	return fim;
+}
+
+// Valor da tag [FEN "..."] numa linha de tag, ou NULL.
+static const char* valor_fen(const char* p, const char* fim_linha, const char** fim_valor) {
+	if (fim_linha - p < 6 || memcmp(p, "[FEN ", 5)) return NULL;
+	const char* a = memchr(p, '"', (size_t)(fim_linha - p));
+	if (!a) return NULL;
+	const char* b = memchr(a + 1, '"', (size_t)(fim_linha - a - 1));
+	if (!b) return NULL;
+	*fim_valor = b;
+	return a + 1;
+}
+
+static void registrar_erro(Fatia* f, const Tabuleiro* t, const char* ini, const char* fim, int motivo) {
+	f->ilegais++;
+	if (f->qtd_primeiros >= MAX_ERROS_EXIBIDOS) return;
+	ErroJogo* e = &f->primeiros[f->qtd_primeiros++];
+	e->jogo = f->jogos;
+	e->onde = ini;
+	e->lance = t->lance;
+	e->pretas = t->lado == COR_PRETA;
+	e->motivo = (uint8_t)motivo;
+	size_t n = (size_t)(fim - ini);
+	if (n >= MAX_SAN_ERRO) n = MAX_SAN_ERRO - 1;
+	memcpy(e->san, ini, n);
+	e->san[n] = '\0';
+}
+
+// Reproduz uma partida a partir de p (já sem espaços à esquerda).
+// Retorna onde ela termina.
+static const char* reproduzir_partida(Fatia* f, const char* p, const char* fim) {
+	Tabuleiro t;
+	const char* fen = FEN_INICIAL;
+	const char* fim_fen = fen + strlen(fen);
+	const char* linha_fen = NULL;
+
+	// Seção de tags: só [FEN] interessa.
+	while (p < fim && *p == '[') {
+		const char* fl = fim_da_linha(p, fim);
+		const char* fv;
+		const char* v = valor_fen(p, fl, &fv);
+		if (v) {
+			fen = v;
+			fim_fen = fv;
+			linha_fen = p;
+		}
+		p = pular_espacos(fl, fim);
+	}
+	f->jogos++;
+	int valido = fen_ler(&t, fen, fim_fen) == FEN_OK;
+	if (!valido) registrar_erro(f, &t, linha_fen, linha_fen, MOTIVO_FEN);
+
+	while (p < fim) {
+		p = pular_espacos(p, fim);
+		if (p >= fim || *p == '[') break;   // partida sem resultado
+		char c = *p;
+		size_t r;
+		if (c == '{' || c == ';' || c == '(') {
+			p = pular_comentario(p, fim);
+		} else if (c == '$') {
+			for (p++; p < fim && *p >= '0' && *p <= '9'; p++) {}
+		} else if ((r = resultado(p, fim)) != 0) {
+			return p + r;
+		} else if (c >= '1' && c <= '9') {
+			// Número do lance: "12." ou "12..." (o lance pode vir colado).
+			while (p < fim && ((*p >= '0' && *p <= '9') || *p == '.')) p++;
+		} else {
+			const char* q = p;
+			while (q < fim && !eh_espaco(*q) && *q != '{' && *q != '(' && *q != ';' && *q != '$') q++;
+			if (q == p) q++;   // ')' solto: vira um lance malformado
+			if (valido) {
+				Lance l;
+				SanResultado s = san_resolver(&t, p, q, &l);
+				if (s == SAN_OK) {
+					aplicar_lance(&t, l);
+					f->lances++;
+				} else {
+					registrar_erro(f, &t, p, q, s);
+					valido = 0;
+				}
+			}
+			p = q;
+		}
+	}
+	return p;
+}
+
+static void* reproduzir_fatia(void* arg) {
+	Fatia* f = arg;
+	const char* p = pular_espacos(f->ini, f->fim);
+	while (p < f->fim) {
+		p = reproduzir_partida(f, p, f->fim);
+		p = pular_espacos(p, f->fim);
+	}
+	return NULL;
+}
+
+static uint64_t contar_linhas(const char* p, const char* fim) {
+	uint64_t n = 0;
+	while (p < fim && (p = memchr(p, '\n', (size_t)(fim - p))) != NULL) {
+		n++;
+		p++;
+	}
+	return n;
+}
+
+// Próxima fronteira de partida a partir de p: uma linha que começa com '['
+// logo depois de uma linha de lances (não de outra tag).
+static const char* proxima_partida(const char* dados, const char* p, const char* fim) {
+	while (p < fim) {
+		const char* nl = memchr(p, '\n', (size_t)(fim - p));
+		if (!nl) return fim;
+		p = nl + 1;
+		if (p < fim && *p == '[') {
+			const char* q = nl;
+			while (q > dados && eh_espaco(q[-1])) q--;
+			const char* ini_anterior = q;
+			while (ini_anterior > dados && ini_anterior[-1] != '\n') ini_anterior--;
+			if (q == dados || *ini_anterior != '[') return p;
+		}
+	}
+	return fim;
+}
+
+static int reproduzir(const char* caminho, int threads, int stats) {
+	int fd = open(caminho, O_RDONLY);
+	if (fd < 0) {
+		perror(caminho);
+		return 1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		perror(caminho);
+		close(fd);
+		return 1;
+	}
+	size_t tam = (size_t)st.st_size;
+	const char* dados = NULL;
+	if (tam > 0) {
+		dados = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (dados == MAP_FAILED) {
+			perror("mmap");
+			close(fd);
+			return 1;
+		}
+		madvise((void*)dados, tam, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	Fatia fatias[MAX_THREADS];
+	pthread_t ids[MAX_THREADS];
+	memset(fatias, 0, sizeof fatias);
+	const char* fim = dados + tam;
+	const char* ini = dados;
+	for (int i = 0; i < threads; i++) {
+		const char* corte = i + 1 == threads ? fim : dados + tam / (size_t)threads * (size_t)(i + 1);
+		if (corte < ini) corte = ini;
+		if (corte < fim) corte = proxima_partida(dados, corte, fim);
+		fatias[i].ini = ini;
+		fatias[i].fim = corte;
+		ini = corte;
+	}
+
+	double t0 = agora_seg();
+	int criada[MAX_THREADS];
+	for (int i = 0; i < threads; i++) criada[i] = pthread_create(&ids[i], NULL, reproduzir_fatia, &fatias[i]) == 0;
+	// Se pthread_create falhar, a fatia é reproduzida na thread principal.
+	for (int i = 0; i < threads; i++) {
+		if (!criada[i]) reproduzir_fatia(&fatias[i]);
+	}
+	for (int i = 0; i < threads; i++) {
+		if (criada[i]) pthread_join(ids[i], NULL);
+	}
+	double dt = agora_seg() - t0;
+	if (dt <= 0) dt = 1e-9;
+
+	uint64_t jogos = 0, lances = 0, ilegais = 0, base_linha = 0;
+	int exibidos = 0;
+	for (int i = 0; i < threads; i++) {
+		const Fatia* f = &fatias[i];
+		const char* marca = f->ini;
+		uint64_t linha = base_linha;
+		for (int k = 0; k < f->qtd_primeiros && exibidos < MAX_ERROS_EXIBIDOS; k++, exibidos++) {
+			const ErroJogo* e = &f->primeiros[k];
+			linha += contar_linhas(marca, e->onde);
+			marca = e->onde;
+			fprintf(stderr, "Partida %llu (linha %llu): %s", (unsigned long long)(jogos + e->jogo),
+					(unsigned long long)(linha + 1), MSG_MOTIVO[e->motivo]);
+			if (e->motivo == MOTIVO_FEN) fputc('\n', stderr);
+			else fprintf(stderr, " %u%s %s\n", e->lance, e->pretas ? "..." : ".", e->san);
+		}
+		jogos += f->jogos;
+		lances += f->lances;
+		ilegais += f->ilegais;
+		base_linha += contar_linhas(f->ini, f->fim);
+	}
+	if (ilegais > MAX_ERROS_EXIBIDOS) fprintf(stderr, "... e mais %llu partida(s) inválida(s)\n", (unsigned long long)(ilegais - MAX_ERROS_EXIBIDOS));
+
+	printf("Partidas: %llu\n", (unsigned long long)jogos);
+	printf("Lances: %llu\n", (unsigned long long)lances);
+	printf("Inválidas: %llu\n", (unsigned long long)ilegais);
+	if (stats) {
+		fprintf(stderr, "[stats] threads=%d bytes=%zu tempo=%.3fs partidas/s=%.0f lances/s=%.0f MB/s=%.1f\n",
+				threads, tam, dt, (double)jogos / dt, (double)lances / dt, (double)tam / dt / 1e6);
+	}
+	if (dados) munmap((void*)dados, tam);
+	return ilegais ? 1 : 0;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ GERADOR DE PARTIDAS ALEATÓRIAS (para testes e benchmarks)
+
+ Lances legais sorteados a partir da posição inicial até mate, afogamento,
+ regra dos 50 lances, só reis no tabuleiro ou MAX_MEIOS_LANCES.
+────────────────────────────────────────────────────────────────────────────
+*/
+#define MAX_MEIOS_LANCES 200
+#define LARGURA_LINHA 79
+
+static Rng rng;
+
+static int gerar(long n) {
+	Saida out;
+	if (!saida_abrir(&out, 1, SAIDA_CAP_PADRAO)) return 1;
+	static char sans[MAX_MEIOS_LANCES][SAN_MAX];
+	Tabuleiro t;
+	ListaLances legais;
+	char num[24];
+	for (long i = 0; i < n; i++) {
+		fen_ler(&t, FEN_INICIAL, FEN_INICIAL + strlen(FEN_INICIAL));
+		int meios = 0;
+		const char* res = "*";
+		for (;;) {
+			if (!gerar_lances(&t, &legais)) {
+				res = !em_xeque(&t) ? "1/2-1/2" : t.lado == COR_BRANCA ? "0-1" : "1-0";
+				break;
+			}
+			if (t.meio_lance >= 100 || tabuleiro_ocupadas(&t) == (t.pecas[0][TP_REI] | t.pecas[1][TP_REI])) {
+				res = "1/2-1/2";
+				break;
+			}
+			if (meios == MAX_MEIOS_LANCES) break;
+			Lance l = legais.l[rng_proximo(&rng) % (uint64_t)legais.n];
+			lance_para_san(&t, &legais, l, sans[meios++]);
+			aplicar_lance(&t, l);
+		}
+
+		saida_texto(&out, "[Event \"Partida aleatória\"]\n[Site \"?\"]\n[Date \"????.??.??\"]\n[Round \"");
+		saida_avancar(&out, formatar_u64(saida_reservar(&out, 24), (uint64_t)i + 1));
+		saida_texto(&out, "\"]\n[White \"?\"]\n[Black \"?\"]\n[Result \"");
+		saida_texto(&out, res);
+		saida_texto(&out, "\"]\n\n");
+		size_t coluna = 0;
+		for (int k = 0; k <= meios; k++) {
+			size_t len = 0;
+			if (k == meios) {
+				len = strlen(res);
+				memcpy(num, res, len);
+			} else {
+				if (k % 2 == 0) {
+					len = formatar_u64(num, (uint64_t)k / 2 + 1);
+					num[len++] = '.';
+					num[len++] = ' ';
+				}
+				size_t s = strlen(sans[k]);
+				memcpy(num + len, sans[k], s);
+				len += s;
+			}
+			if (coluna && coluna + 1 + len > LARGURA_LINHA) {
+				saida_escrever(&out, "\n", 1);
+				coluna = 0;
+			} else if (coluna) {
+				saida_escrever(&out, " ", 1);
+				coluna++;
+			}
+			saida_escrever(&out, num, len);
+			coluna += len;
+		}
+		saida_escrever(&out, "\n\n", 2);
+	}
+	return saida_fechar(&out) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+	const char* caminho = NULL;
+	long threads = 1, n_gerar = -1, semente = 1;
+	int stats = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--threads=", 10) && parse_long(a + 10, 1, MAX_THREADS, &threads)) {
+		} else if (!strcmp(a, "--stats")) {
+			stats = 1;
+		} else if (!strncmp(a, "--gerar=", 8) && parse_long(a + 8, 0, 100000000L, &n_gerar)) {
+		} else if (!strncmp(a, "--semente=", 10) && parse_long(a + 10, 1, 2000000000L, &semente)) {
+		} else if (a[0] != '-' && !caminho) {
+			caminho = a;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (n_gerar >= 0) {
+		rng = rng_de_semente((uint64_t)semente);
+		return gerar(n_gerar);
+	}
+	if (!caminho) {
+		usage(argv[0]);
+		return 1;
+	}
+	return reproduzir(caminho, (int)threads, stats);
+}
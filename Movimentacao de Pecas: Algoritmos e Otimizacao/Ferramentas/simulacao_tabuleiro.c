@@ -0,0 +1,128 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "xadrez_geometria.h"
+#include "xadrez_util.h"
+
+// Simulação de movimentos deslizantes em tabuleiros de tamanho arbitrário
+// (xadrez_geometria.h): uma Rainha faz M movimentos aleatórios entre K
+// obstáculos aleatórios, parando na borda ou antes do primeiro obstáculo.
+// Mede as duas representações de ocupação (bitset denso até 16x16, hash
+// esparso acima) e imprime um checksum da trajetória para comparar as duas.
+// Uso: ./simulacao_tabuleiro [--tamanho=LxA] [--pecas=K] [--movimentos=M]
+//                            [--representacao=auto|densa|esparsa] [--semente=S]
+
+static inline int64_t rng_intervalo(Rng* r, int64_t n) {
+	return (int64_t)(rng_proximo(r) % (uint64_t)n);
+}
+
+static int parse_tamanho(const char* s, int64_t* largura, int64_t* altura) {
+	errno = 0;
+	char* end = NULL;
+	long long l = strtoll(s, &end, 10);
+	if (errno || end == s || *end != 'x') return 0;
+	const char* s2 = end + 1;
+	long long a = strtoll(s2, &end, 10);
+	if (errno || end == s2 || *end != '\0') return 0;
+	if (l < 1 || l > GEO_MAX_LADO || a < 1 || a > GEO_MAX_LADO) return 0;
+	*largura = l;
+	*altura = a;
+	return 1;
+}
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s [opções]\n"
+		"  --tamanho=LxA           dimensões do tabuleiro (padrão 8x8, até %lldx%lld)\n"
+		"  --pecas=K               obstáculos aleatórios (padrão 8)\n"
+		"  --movimentos=M          movimentos da Rainha (padrão 1000000)\n"
+		"  --representacao=R       auto, densa (até %dx%d) ou esparsa\n"
+		"  --semente=S             semente do gerador (padrão 1)\n",
+		prog, GEO_MAX_LADO, GEO_MAX_LADO, GEO_DENSA_MAX_LADO, GEO_DENSA_MAX_LADO);
+}
+
+int main(int argc, char** argv) {
+	int64_t largura = 8, altura = 8;
+	long pecas = 8, movimentos = 1000000, semente = 1;
+	const char* repr = "auto";
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strncmp(a, "--tamanho=", 10) && parse_tamanho(a + 10, &largura, &altura)) {
+		} else if (!strncmp(a, "--pecas=", 8) && parse_long(a + 8, 0, 100000000L, &pecas)) {
+		} else if (!strncmp(a, "--movimentos=", 13) && parse_long(a + 13, 0, 2000000000L, &movimentos)) {
+		} else if (!strncmp(a, "--semente=", 10) && parse_long(a + 10, 1, 2000000000L, &semente)) {
+		} else if (!strncmp(a, "--representacao=", 16)) {
+			repr = a + 16;
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	Geometria geo;
+	Ocupacao ocup;
+	geometria_iniciar(&geo, largura, altura);
+	int ok;
+	if (!strcmp(repr, "auto")) ok = ocupacao_iniciar(&ocup, &geo);
+	else if (!strcmp(repr, "densa")) ok = ocupacao_iniciar_tipo(&ocup, &geo, OCUPACAO_DENSA);
+	else if (!strcmp(repr, "esparsa")) ok = ocupacao_iniciar_tipo(&ocup, &geo, OCUPACAO_ESPARSA);
+	else {
+		fprintf(stderr, "Erro: representação desconhecida '%s'.\n", repr);
+		return 1;
+	}
+	if (!ok) {
+		fprintf(stderr, "Erro: representação '%s' indisponível para %lldx%lld.\n",
+				repr, (long long)largura, (long long)altura);
+		ocupacao_liberar(&ocup);
+		return 1;
+	}
+
+	uint64_t casas = (uint64_t)largura * (uint64_t)altura;
+	if ((uint64_t)pecas >= casas) {
+		fprintf(stderr, "Erro: %ld obstáculo(s) não cabem em %llu casas.\n", pecas, (unsigned long long)casas);
+		ocupacao_liberar(&ocup);
+		return 1;
+	}
+
+	Rng rng = rng_de_semente((uint64_t)semente);
+	Posicao pos = { (int32_t)(largura / 2), (int32_t)(altura / 2) };
+	while (ocup.qtd < (size_t)pecas) {
+		int64_t x = rng_intervalo(&rng, largura), y = rng_intervalo(&rng, altura);
+		if (x == pos.x && y == pos.y) continue;
+		ocupacao_inserir(&ocup, x, y);
+	}
+
+	int64_t maior = largura > altura ? largura : altura;
+	uint64_t passos = 0, checksum = 0;
+	double t0 = agora_seg();
+	for (long m = 0; m < movimentos; m++) {
+		Direcao d = (Direcao)rng_intervalo(&rng, DIR_QTD);
+		int64_t n = 1 + rng_intervalo(&rng, maior);
+		int64_t k = ocupacao_deslizar(&ocup, pos, DIRECAO_DX[d], DIRECAO_DY[d], n);
+		pos.x = (int32_t)(pos.x + k * DIRECAO_DX[d]);
+		pos.y = (int32_t)(pos.y + k * DIRECAO_DY[d]);
+		passos += (uint64_t)k;
+		checksum = (checksum ^ geometria_casa(&geo, pos.x, pos.y)) * 0x100000001B3ULL;
+	}
+	double dt = agora_seg() - t0;
+	if (dt <= 0) dt = 1e-9;
+
+	printf("=== SIMULAÇÃO EM TABULEIRO %lldx%lld ===\n", (long long)largura, (long long)altura);
+	printf("Representação: %s | Obstáculos: %zu\n",
+		   ocup.tipo == OCUPACAO_DENSA ? "densa (bitset)" : "esparsa (hash)", ocup.qtd);
+	printf("Movimentos: %ld | Passos: %llu\n", movimentos, (unsigned long long)passos);
+	printf("Posição final: (%d, %d)\n", pos.x, pos.y);
+	printf("Checksum: %016llx\n", (unsigned long long)checksum);
+	printf("Tempo: %.3f s | Movimentos/s: %.0f\n", dt, (double)movimentos / dt);
+	ocupacao_liberar(&ocup);
+	return 0;
+}
@@ -0,0 +1,334 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "xadrez_fen.h"
+#include "xadrez_finais.h"
+#include "xadrez_lances.h"
+#include "xadrez_util.h"
+
+// Tabelas de finais KQK e KRK (distância até o mate) por análise
+// retrógrada com bitboards, gravadas como arquivos .xtf mapeáveis.
+// Uso: ./tabela_finais --gerar[=kqk|krk] [--dir=D] [--threads=T]
+//      ./tabela_finais --verificar[=kqk|krk] [--dir=D] [--amostra=N] [--profundidade=P] [--semente=S]
+//      ./tabela_finais --consultar=<FEN> [--dir=D]
+// --verificar confere, para todas as posições do espaço completo, a
+// legalidade e o valor da tabela contra os lances do gerador legal
+// (xadrez_lances.h): o valor tem que ser o mínimo (brancas) ou o máximo
+// (pretas) dos filhos + 1, e os mates/afogamentos têm que bater. Depois
+// compara uma amostra aleatória com uma busca de força bruta até P plies.
+
+#define MAX_THREADS 64
+
+static void usage(const char* prog) {
+	fprintf(stderr,
+		"Uso: %s --gerar[=kqk|krk] [--dir=D] [--threads=T]\n"
+		"     %s --verificar[=kqk|krk] [--dir=D] [--amostra=N] [--profundidade=P] [--semente=S]\n"
+		"     %s --consultar=<FEN> [--dir=D]\n"
+		"  --dir=D           diretório dos arquivos .xtf (padrão: .)\n"
+		"  --threads=T       threads da geração (padrão 1, até %d)\n"
+		"  --amostra=N       posições da força bruta (padrão 300)\n"
+		"  --profundidade=P  plies da força bruta (padrão 3, até 7)\n",
+		prog, prog, prog, MAX_THREADS);
+}
+
+static void caminho_tabela(char* dst, size_t cap, const char* dir, TipoFinal tipo) {
+	snprintf(dst, cap, "%s/%s.xtf", dir, CHAVE_FINAL[tipo]);
+}
+
+static void maiusculas(char* dst, const char* src) {
+	while ((*dst++ = (char)(*src >= 'a' && *src <= 'z' ? *src - 32 : *src))) src++;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ GERAÇÃO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static int gerar(TipoFinal tipo, const char* dir, int threads) {
+	TabelaFinal t;
+	FinalStats st;
+	char caminho[4096], nome[8];
+	maiusculas(nome, CHAVE_FINAL[tipo]);
+	if (!final_gerar(&t, tipo, threads, &st)) {
+		fprintf(stderr, "Erro: sem memória para gerar %s.\n", nome);
+		return 1;
+	}
+	caminho_tabela(caminho, sizeof caminho, dir, tipo);
+	int ok = final_salvar(&t, caminho);
+	if (!ok) {
+		perror(caminho);
+		final_fechar(&t);
+		return 1;
+	}
+	printf("%s: %zu bytes em %s; %d passes em %.3fs (%d thread%s); maior distância: %d plies (mate em %d)\n",
+		nome, final_tamanho_arquivo(), caminho, st.passes, st.segundos, threads, threads > 1 ? "s" : "",
+		t.maior_plies, (t.maior_plies + 1) / 2);
+	printf("%s: vitórias (brancas a jogar)=%llu derrotas (pretas a jogar)=%llu empates=%llu\n", nome,
+		(unsigned long long)st.vitorias, (unsigned long long)st.derrotas, (unsigned long long)st.empates);
+	final_fechar(&t);
+	return 0;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ VERIFICAÇÃO
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static Rng rng;
+
+static void montar(Tabuleiro* tab, TipoPeca peca, int rb, int pc, int rp, Cor lado) {
+	tabuleiro_limpar(tab);
+	tabuleiro_por(tab, rb, PECA_COD(COR_BRANCA, TP_REI));
+	tabuleiro_por(tab, pc, PECA_COD(COR_BRANCA, peca));
+	tabuleiro_por(tab, rp, PECA_COD(COR_PRETA, TP_REI));
+	tab->lado = (uint8_t)lado;
+}
+
+// Legal = casas distintas, reis não vizinhos e o lado que não joga fora de xeque.
+static int legal(const Tabuleiro* tab, int rb, int pc, int rp) {
+	if (rb == pc || rb == rp || pc == rp) return 0;
+	if (ataques_rei(BB_CASA(rb)) & BB_CASA(rp)) return 0;
+	Cor espera = tab->lado == COR_BRANCA ? COR_PRETA : COR_BRANCA;
+	int rei = __builtin_ctzll(tab->pecas[espera][TP_REI]);
+	return !casa_atacada(tab, rei, (Cor)tab->lado);
+}
+
+// Valor esperado a partir dos filhos: plies até o mate ou FINAL_SEM_MATE.
+static int valor_pelos_filhos(const TabelaFinal* t, const Tabuleiro* tab) {
+	ListaLances lista;
+	int n = gerar_lances(tab, &lista);
+	if (n == 0) return tab->lado == COR_PRETA && em_xeque(tab) ? 0 : FINAL_SEM_MATE;
+	int melhor = FINAL_SEM_MATE;
+	for (int i = 0; i < n; i++) {
+		// Captura da peça: rei contra rei, empate.
+		if (lista.l[i].flags & LANCE_CAPTURA) return FINAL_SEM_MATE;
+		Tabuleiro filho = *tab;
+		aplicar_lance(&filho, lista.l[i]);
+		int v = final_consultar_tabuleiro(t, &filho);
+		if (tab->lado == COR_BRANCA) {
+			if (v >= 0 && (melhor < 0 || v + 1 < melhor)) melhor = v + 1;
+		} else {
+			if (v < 0) return FINAL_SEM_MATE;
+			if (v + 1 > melhor) melhor = v + 1;
+		}
+	}
+	return melhor;
+}
+
+// Força bruta: menor número de plies até o mate das brancas em no máximo
+// 'prof' plies, ou FINAL_SEM_MATE. As brancas apertam o limite a cada mate
+// achado; as pretas param no primeiro lance que escapa.
+static int mate_forca_bruta(const Tabuleiro* tab, int prof) {
+	ListaLances lista;
+	int n = gerar_lances(tab, &lista);
+	if (n == 0) return tab->lado == COR_PRETA && em_xeque(tab) ? 0 : FINAL_SEM_MATE;
+	if (prof == 0) return FINAL_SEM_MATE;
+	int melhor = FINAL_SEM_MATE;
+	for (int i = 0; i < n; i++) {
+		if (lista.l[i].flags & LANCE_CAPTURA) return FINAL_SEM_MATE;
+		Tabuleiro filho = *tab;
+		aplicar_lance(&filho, lista.l[i]);
+		if (tab->lado == COR_BRANCA) {
+			int limite = melhor < 0 ? prof - 1 : melhor - 2;
+			if (limite < 0) break;
+			int v = mate_forca_bruta(&filho, limite);
+			if (v >= 0) melhor = v + 1;
+		} else {
+			int v = mate_forca_bruta(&filho, prof - 1);
+			if (v < 0) return FINAL_SEM_MATE;
+			if (v + 1 > melhor) melhor = v + 1;
+		}
+	}
+	return melhor;
+}
+
+static int verificar(TipoFinal tipo, const char* dir, long amostra, long prof) {
+	TabelaFinal t;
+	char caminho[4096], nome[8];
+	maiusculas(nome, CHAVE_FINAL[tipo]);
+	caminho_tabela(caminho, sizeof caminho, dir, tipo);
+	if (!final_abrir(&t, caminho)) {
+		fprintf(stderr, "Erro: não foi possível abrir '%s' (%s); gere com --gerar.\n", caminho, strerror(errno));
+		return 1;
+	}
+	if (t.tipo != tipo) {
+		fprintf(stderr, "Erro: '%s' não é uma tabela %s.\n", caminho, nome);
+		final_fechar(&t);
+		return 1;
+	}
+	TipoPeca peca = tipo == FINAL_KQK ? TP_RAINHA : TP_TORRE;
+
+	// Todas as posições, também as fora do triângulo (confere a simetria).
+	uint64_t conferidas = 0, divergencias = 0;
+	Tabuleiro tab;
+	for (int lado = 0; lado < 2; lado++) {
+		for (int rb = 0; rb < 64; rb++) {
+			for (int pc = 0; pc < 64; pc++) {
+				for (int rp = 0; rp < 64; rp++) {
+					montar(&tab, peca, rb, pc, rp, (Cor)lado);
+					int v = final_consultar(&t, rb, pc, rp, (Cor)lado);
+					int esperado = FINAL_POSICAO_INVALIDA;
+					int distintas = rb != pc && rb != rp && pc != rp;
+					if (distintas && legal(&tab, rb, pc, rp)) esperado = valor_pelos_filhos(&t, &tab);
+					conferidas++;
+					if (v != esperado && ++divergencias <= 10) {
+						char fen[FEN_MAX];
+						if (distintas) fen_escrever(&tab, fen);
+						else snprintf(fen, sizeof fen, "(casas repetidas)");
+						fprintf(stderr, "Divergência %s: %s tabela=%d esperado=%d\n", nome, fen, v, esperado);
+					}
+				}
+			}
+		}
+	}
+	printf("%s: %llu posições conferidas contra o gerador de lances, %llu divergência(s)\n", nome,
+		(unsigned long long)conferidas, (unsigned long long)divergencias);
+
+	uint64_t brutas = 0, div_brutas = 0, com_mate = 0;
+	while ((long)brutas < amostra) {
+		uint64_t r = rng_proximo(&rng);
+		int rb = (int)(r & 63), pc = (int)(r >> 6 & 63), rp = (int)(r >> 12 & 63);
+		Cor lado = (Cor)(r >> 18 & 1);
+		int v = final_consultar(&t, rb, pc, rp, lado);
+		if (v == FINAL_POSICAO_INVALIDA) continue;
+		// Uma posição sim, outra não, perto do mate, onde a busca tem o que achar.
+		if ((brutas & 1) && (v < 0 || v > prof)) continue;
+		montar(&tab, peca, rb, pc, rp, lado);
+		int esperado = v >= 0 && v <= prof ? v : FINAL_SEM_MATE;
+		int b = mate_forca_bruta(&tab, (int)prof);
+		brutas++;
+		com_mate += b >= 0;
+		if (b != esperado && ++div_brutas <= 10) {
+			char fen[FEN_MAX];
+			fen_escrever(&tab, fen);
+			fprintf(stderr, "Divergência %s (força bruta): %s tabela=%d busca=%d\n", nome, fen, v, b);
+		}
+	}
+	printf("%s: %llu posições pela força bruta até %ld plies (%llu com mate), %llu divergência(s)\n", nome,
+		(unsigned long long)brutas, prof, (unsigned long long)com_mate, (unsigned long long)div_brutas);
+	final_fechar(&t);
+	return divergencias || div_brutas ? 1 : 0;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ CONSULTA
+────────────────────────────────────────────────────────────────────────────
+*/
+
+static int consultar(const char* fen, const char* dir) {
+	Tabuleiro tab;
+	FenErro e = fen_ler(&tab, fen, fen + strlen(fen));
+	if (e != FEN_OK) {
+		fprintf(stderr, "Erro: FEN inválida (%s).\n", fen_erro_msg(e));
+		return 1;
+	}
+	int falhas = 0;
+	for (int tipo = 0; tipo < FINAL_QTD; tipo++) {
+		TabelaFinal t;
+		char caminho[4096], nome[8];
+		maiusculas(nome, CHAVE_FINAL[tipo]);
+		caminho_tabela(caminho, sizeof caminho, dir, (TipoFinal)tipo);
+		if (!final_abrir(&t, caminho)) {
+			// Não gerada: tenta a próxima. Existente e ilegível: avisa, e
+			// o erro substitui o "nenhuma tabela" do fim.
+			if (errno != ENOENT) {
+				fprintf(stderr, "Erro: não foi possível abrir '%s' (%s).\n", caminho, strerror(errno));
+				falhas++;
+			}
+			continue;
+		}
+		int v = final_consultar_tabuleiro(&t, &tab);
+		if (v == FINAL_OUTRO_MATERIAL) {
+			final_fechar(&t);
+			continue;
+		}
+		const char* lado = tab.lado == COR_BRANCA ? "brancas jogam" : "pretas jogam";
+		if (v == FINAL_POSICAO_INVALIDA) {
+			printf("%s, %s: posição inválida\n", nome, lado);
+		} else if (v == FINAL_SEM_MATE) {
+			printf("%s, %s: empate\n", nome, lado);
+		} else if (v == 0) {
+			printf("%s, %s: xeque-mate\n", nome, lado);
+		} else {
+			// Melhor lance: o filho com v - 1 plies (a captura da peça só
+			// aparece como empate, que aqui não é o valor da posição).
+			ListaLances lista;
+			int n = gerar_lances(&tab, &lista);
+			char san[SAN_MAX] = "";
+			for (int i = 0; i < n; i++) {
+				Tabuleiro filho = tab;
+				aplicar_lance(&filho, lista.l[i]);
+				if (!(lista.l[i].flags & LANCE_CAPTURA) && final_consultar_tabuleiro(&t, &filho) == v - 1) {
+					lance_para_san(&tab, &lista, lista.l[i], san);
+					break;
+				}
+			}
+			printf("%s, %s: %s em %d lance%s (%d pl%s); melhor lance: %s\n", nome, lado,
+				tab.lado == COR_BRANCA ? "mate" : "levam mate", (v + 1) / 2, (v + 1) / 2 > 1 ? "s" : "", v,
+				v > 1 ? "ies" : "y", san);
+		}
+		final_fechar(&t);
+		return 0;
+	}
+	if (!falhas) fprintf(stderr, "Erro: nenhuma tabela em '%s' cobre esta posição (KQK ou KRK, brancas com a peça).\n", dir);
+	return 1;
+}
+
+int main(int argc, char** argv) {
+	int gerar_mask = 0, verificar_mask = 0;
+	const char* fen = NULL;
+	const char* dir = ".";
+	long threads = 1, amostra = 300, prof = 3, semente = 1;
+
+	for (int i = 1; i < argc; i++) {
+		const char* a = argv[i];
+		int tipo;
+		if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+			usage(argv[0]);
+			return 0;
+		} else if (!strcmp(a, "--gerar")) {
+			gerar_mask = (1 << FINAL_QTD) - 1;
+		} else if (!strncmp(a, "--gerar=", 8) && (tipo = final_de_chave(a + 8)) >= 0) {
+			gerar_mask |= 1 << tipo;
+		} else if (!strcmp(a, "--verificar")) {
+			verificar_mask = (1 << FINAL_QTD) - 1;
+		} else if (!strncmp(a, "--verificar=", 12) && (tipo = final_de_chave(a + 12)) >= 0) {
+			verificar_mask |= 1 << tipo;
+		} else if (!strncmp(a, "--consultar=", 12)) {
+			fen = a + 12;
+		} else if (!strncmp(a, "--dir=", 6) && a[6]) {
+			dir = a + 6;
+		} else if (!strncmp(a, "--threads=", 10) && parse_long(a + 10, 1, MAX_THREADS, &threads)) {
+		} else if (!strncmp(a, "--amostra=", 10) && parse_long(a + 10, 0, 1000000, &amostra)) {
+		} else if (!strncmp(a, "--profundidade=", 15) && parse_long(a + 15, 1, 7, &prof)) {
+		} else if (!strncmp(a, "--semente=", 10) && parse_long(a + 10, 1, 2000000000L, &semente)) {
+		} else {
+			fprintf(stderr, "Erro: argumento inválido '%s'.\n", a);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (!gerar_mask && !verificar_mask && !fen) {
+		usage(argv[0]);
+		return 1;
+	}
+	rng = rng_de_semente((uint64_t)semente);
+
+	int rc = 0;
+	for (int tipo = 0; tipo < FINAL_QTD; tipo++) {
+		if (gerar_mask >> tipo & 1) rc |= gerar((TipoFinal)tipo, dir, (int)threads);
+	}
+	for (int tipo = 0; tipo < FINAL_QTD; tipo++) {
+		if (verificar_mask >> tipo & 1) rc |= verificar((TipoFinal)tipo, dir, amostra, prof);
+	}
+	if (fen) rc |= consultar(fen, dir);
+	return rc;
+}
@@ -1,12 +1,48 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "xadrez_anel.h"
+#include "xadrez_cenarios.h"
+#include "xadrez_compressao.h"
+#include "xadrez_hash.h"
+#include "xadrez_latencia.h"
+#include "xadrez_saida.h"
+#include "xadrez_formatos.h"
+#include "xadrez_segmentos.h"
+#include "xadrez_util.h"
 
 // Versão com validações e parâmetros via CLI.
-// Uso: ./xadrez_com_validacoes [torre bispo rainha cavaloV cavaloH]
+// Uso: ./xadrez_com_validacoes [opções] [torre bispo rainha cavaloV cavaloH]
 // Padrões: 5 5 8 2 1
-// Limites: 0..100000 (para evitar saídas gigantes inadvertidas)
+// Limites: 0..100000000 (para evitar saídas gigantes inadvertidas)
+// Opções: --format=text|csv|jsonl|bin  --stats  --anel[=BLOCOS]  --compress  --digest
+//         --lote=<arquivo|->  --shards=N  --latencia[=text|json]  --cenarios=<arquivo.xcn>
+// Lote: um registro "torre bispo rainha cavaloV cavaloH" por linha (espaço,
+// tab ou vírgula); a saída é a de cada registro em sequência, entre um
+// cabeçalho e um rodapé únicos. Com --shards=N o arquivo é dividido em N
+// faixas contíguas (em fronteiras de linha), cada uma processada por um
+// processo filho num segmento temporário; o pai junta os segmentos em
+// ordem (copy_file_range/splice), com saída idêntica à de um processo só.
+// --latencia: histograma por registro de cada fase (leitura da linha,
+// geração dos passos no buffer, emissão dos blocos ao destino e o registro
+// inteiro), com p50/p90/p99/p99.9/máx em stderr ao terminar e, parcial, a
+// cada SIGUSR1. Com --shards cada processo mede o seu e o pai junta.
+// --cenarios: a mesma lista pré-compilada por bin/compilar_cenarios; o
+// arquivo é mapeado e os registros usados direto do mapa, sem parse. Só o
+// cabeçalho é conferido ao abrir e cada bloco antes do uso, então o
+// primeiro registro sai no mesmo tempo para 1 K ou 100 M cenários.
+
+#define BLOCO_LEITURA (1 << 20)
+#define SHARDS_MAX 256
 
 typedef struct {
 	int torre;     // passos "Direita"
@@ -22,71 +58,720 @@ static int parse_int(const char* s, int* out) {
 	char* end = NULL;
 	long v = strtol(s, &end, 10);
 	if (errno != 0 || end == s || *end != '\0') return 0; // inválido
-	if (v < 0 || v > 100000) return 0; // limites
+	if (v < 0 || v > LIMITE_PASSOS) return 0; // limites
 	*out = (int)v;
 	return 1;
 }
 
-static void repetir_puts(const char* s, int n) {
-	for (int i = 0; i < n; i++) puts(s);
-}
-
 static void usage(const char* prog) {
 	fprintf(stderr,
-		"Uso: %s [torre bispo rainha cavaloV cavaloH]\n"
+		"Uso: %s [opções] [torre bispo rainha cavaloV cavaloH]\n"
 		"Padrões: 5 5 8 2 1\n"
-		"Limites: cada valor em 0..100000\n",
-		prog ? prog : "programa");
+		"Limites: cada valor em 0..%d\n"
+		"Opções:\n"
+		"  --format=text|csv|jsonl|bin  formato da saída (padrão: text)\n"
+		"  --stats                      vazão (passos/s, MB/s) em stderr\n"
+		"  --anel[=BLOCOS]              escrita em thread separada por anel de\n"
+		"                               BLOCOS x 64 KiB (padrão: %d; 2..%d)\n"
+		"  --compress                   saída comprimida (.xzl, ler com bin/descomprimir)\n"
+		"  --digest                     em vez da saída, só o resumo: xxh64 (hex) e bytes\n"
+		"  --lote=<arquivo|->           um registro (5 valores) por linha, em vez dos argumentos;\n"
+		"                               '#' até o fim da linha é comentário\n"
+		"  --shards=N                   lote dividido entre N processos (1..%d; arquivo regular)\n"
+		"  --cenarios=<arquivo.xcn>     lote pré-compilado (bin/compilar_cenarios), lido por mmap\n"
+		"  --latencia[=text|json]       percentis de latência por fase de cada registro em stderr\n"
+		"                               (ao terminar e a cada SIGUSR1)\n",
+		prog ? prog : "programa", LIMITE_PASSOS, ANEL_BLOCOS_PADRAO, ANEL_BLOCOS_MAX, SHARDS_MAX);
+}
+
+// Título (texto) e início do fluxo: uma vez por execução, também no lote.
+static void emitir_cabecalho(Saida* out, Formato formato) {
+	if (formato == FORMATO_TEXTO) saida_linha(out, "=== XADREZ (versão com validações) ===");
+	emitir_inicio(out, formato);
+}
+
+// Um registro: mensagem de configuração (apenas no formato texto) e as
+// quatro peças, cada uma com índices a partir de 1.
+static void emitir_registro(Saida* out, Formato formato, const Params* p) {
+	if (formato == FORMATO_TEXTO) {
+		char cfg[160];
+		snprintf(cfg, sizeof cfg, "Config: Torre=%d, Bispo=%d, Rainha=%d, Cavalo=(V:%d,H:%d)\n",
+				 p->torre, p->bispo, p->rainha, p->cavV, p->cavH);
+		saida_linha(out, cfg);
+	}
+
+	Posicao at;
+	uint64_t k;
+
+	emitir_secao(out, formato, "TORRE:");
+	at = (Posicao){0, 0}; k = 0;
+	emitir_passos(out, formato, PECA_TORRE, DIR_DIREITA, p->torre, &at, &k);
+	emitir_secao(out, formato, "");
+
+	emitir_secao(out, formato, "BISPO:");
+	at = (Posicao){0, 0}; k = 0;
+	emitir_passos(out, formato, PECA_BISPO, DIR_CIMA_DIREITA, p->bispo, &at, &k);
+	emitir_secao(out, formato, "");
+
+	emitir_secao(out, formato, "RAINHA:");
+	at = (Posicao){0, 0}; k = 0;
+	emitir_passos(out, formato, PECA_RAINHA, DIR_ESQUERDA, p->rainha, &at, &k);
+	emitir_secao(out, formato, "");
+
+	emitir_secao(out, formato, "CAVALO:");
+	at = (Posicao){0, 0}; k = 0;
+	emitir_passos(out, formato, PECA_CAVALO, DIR_CIMA, p->cavV, &at, &k);
+	emitir_passos(out, formato, PECA_CAVALO, DIR_DIREITA, p->cavH, &at, &k);
+	emitir_secao(out, formato, "");
+}
+
+static void emitir_rodape(Saida* out, Formato formato) {
+	emitir_secao(out, formato, "[OK] Execução concluída com validações");
+}
+
+static inline uint64_t passos_de(const Params* p) {
+	return (uint64_t)p->torre + p->bispo + p->rainha + p->cavV + p->cavH;
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ LATÊNCIAS
+────────────────────────────────────────────────────────────────────────────
+*/
+
+typedef enum {
+	FASE_LEITURA,  // linha do lote -> Params
+	FASE_GERACAO,  // passos gerados e formatados no buffer
+	FASE_EMISSAO,  // blocos entregues ao destino durante o registro
+	FASE_REGISTRO, // as três juntas
+	FASE_QTD
+} Fase;
+
+static const char* const NOME_FASE[FASE_QTD] = { "leitura", "geracao", "emissao", "registro" };
+
+typedef struct {
+	Histograma fase[FASE_QTD];
+	CronometroSaida* cronometro; // topo da cadeia de saída: mede a emissão
+	int json;
+	char origem_parcial[32];     // rótulo dos relatórios pedidos por SIGUSR1
+} Latencias;
+
+static volatile sig_atomic_t relatorio_pedido = 0;
+
+// Pais de --shards repassam o pedido aos filhos (kill é seguro em handler).
+static pid_t filhos_relatorio[SHARDS_MAX];
+static volatile sig_atomic_t qtd_filhos_relatorio = 0;
+
+static void pedir_relatorio(int sinal) {
+	(void)sinal;
+	relatorio_pedido = 1;
+}
+
+static void repassar_relatorio(int sinal) {
+	for (int i = 0; i < qtd_filhos_relatorio; i++) kill(filhos_relatorio[i], sinal);
+}
+
+// Quem processa o lote instala sem SA_RESTART: uma leitura parada (lote
+// vindo de um pipe lento) volta com EINTR e o relatório sai na hora.
+static void tratar_sigusr1(void (*tratador)(int)) {
+	struct sigaction sa;
+	memset(&sa, 0, sizeof sa);
+	sa.sa_handler = tratador;
+	sa.sa_flags = tratador == repassar_relatorio ? SA_RESTART : 0;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGUSR1, &sa, NULL);
+}
+
+static void exportar_latencias(const Latencias* lat, const char* origem) {
+	for (int f = 0; f < FASE_QTD; f++) histograma_exportar(stderr, origem, NOME_FASE[f], &lat->fase[f], lat->json);
+	fflush(stderr);
+}
+
+// Registro medido em [t0, t2): leitura até t1; do resto, 'emissao' ns
+// foram gastos entregando blocos e o que sobra é geração.
+static void registrar_latencias(Latencias* lat, uint64_t t0, uint64_t t1, uint64_t t2, uint64_t emissao) {
+	uint64_t resto = t2 - t1;
+	histograma_registrar(&lat->fase[FASE_GERACAO], resto > emissao ? resto - emissao : 0);
+	histograma_registrar(&lat->fase[FASE_EMISSAO], emissao);
+	histograma_registrar(&lat->fase[FASE_REGISTRO], t2 - t0);
+}
+
+/*
+────────────────────────────────────────────────────────────────────────────
+ LOTE
+────────────────────────────────────────────────────────────────────────────
+*/
+
+typedef struct {
+	uint64_t linhas, registros, passos, erros;
+} LoteStats;
+
+// Lê os 5 valores de uma linha [ini, fim) com o parser da lista do .xcn
+// (cenario_ler_linha): as duas entradas aceitam o mesmo texto, '#' de
+// comentário incluído. 1 se válida, 0 se inválida e -1 se em branco.
+static int ler_registro(const char* ini, const char* fim, Params* p) {
+	CenarioRegistro r;
+	int v = cenario_ler_linha(ini, fim, LIMITE_PASSOS, &r);
+	if (v > 0) *p = (Params){ (int)r.torre, (int)r.bispo, (int)r.rainha, (int)r.cavalo_v, (int)r.cavalo_h };
+	return v;
+}
+
+// Quebras de linha de fd em [0, fim): numeração absoluta das linhas de um
+// fragmento. Só é contada no primeiro erro, então o caso comum não relê o
+// começo do arquivo.
+static uint64_t linhas_antes(int fd, off_t fim) {
+	char buf[1 << 16];
+	uint64_t n = 0;
+	for (off_t pos = 0; pos < fim;) {
+		size_t quer = fim - pos < (off_t)sizeof buf ? (size_t)(fim - pos) : sizeof buf;
+		ssize_t r = pread(fd, buf, quer, pos);
+		if (r < 0 && errno == EINTR) continue;
+		if (r <= 0) break;
+		for (char* c = buf; (c = memchr(c, '\n', (size_t)(buf + r - c))) != NULL; c++) n++;
+		pos += r;
+	}
+	return n;
+}
+
+// Emite os registros das linhas de fd em [ini, fim). Com fim < 0 lê
+// sequencialmente até o EOF (aceita pipe); com uma faixa usa pread, sem
+// mexer na posição do fd, que os processos de --shards compartilham, e
+// as mensagens de erro numeram as linhas a partir do início do arquivo.
+// Com 'lat' (pode ser NULL) cada linha não vazia entra nos histogramas.
+// Retorna 0 se a leitura falhou.
+static int processar_lote(int fd, off_t ini, off_t fim, Saida* out, Formato formato, LoteStats* st, Latencias* lat) {
+	char* buf = malloc(BLOCO_LEITURA);
+	if (!buf) return 0;
+	off_t lido = ini;
+	int64_t base = ini > 0 ? -1 : 0; // linhas antes de ini; -1 = ainda não contadas
+	size_t pendente = 0; // bytes de uma linha incompleta do bloco anterior
+	int ok = 1;
+	for (;;) {
+		size_t quer = BLOCO_LEITURA - pendente;
+		if (fim >= 0 && (off_t)quer > fim - lido) quer = (size_t)(fim - lido);
+		ssize_t r = !quer ? 0 : fim >= 0 ? pread(fd, buf + pendente, quer, lido) : read(fd, buf + pendente, quer);
+		if (r < 0 && errno == EINTR) {
+			if (lat && relatorio_pedido) {
+				relatorio_pedido = 0;
+				exportar_latencias(lat, lat->origem_parcial);
+			}
+			continue;
+		}
+		if (r < 0) {
+			ok = 0;
+			break;
+		}
+		lido += r;
+		int eof = r == 0;
+		char* p = buf;
+		char* lim = buf + pendente + r;
+		while (p < lim) {
+			char* nl = memchr(p, '\n', (size_t)(lim - p));
+			if (!nl) {
+				if (!eof) break;
+				nl = lim; // última linha sem '\n'
+			}
+			st->linhas++;
+			Params reg;
+			uint64_t t0 = lat ? latencia_agora() : 0;
+			int v = ler_registro(p, nl, &reg);
+			uint64_t t1 = 0;
+			if (lat && v >= 0) {
+				t1 = latencia_agora();
+				histograma_registrar(&lat->fase[FASE_LEITURA], t1 - t0);
+			}
+			if (v > 0) {
+				uint64_t e0 = lat ? lat->cronometro->ns : 0;
+				emitir_registro(out, formato, &reg);
+				if (lat) registrar_latencias(lat, t0, t1, latencia_agora(), lat->cronometro->ns - e0);
+				st->registros++;
+				st->passos += passos_de(&reg);
+			} else if (v == 0 && ++st->erros <= 10) {
+				if (base < 0) base = (int64_t)linhas_antes(fd, ini);
+				fprintf(stderr, "Linha %llu inválida\n", (unsigned long long)base + st->linhas);
+			}
+			p = nl + 1;
+			if (lat && relatorio_pedido) {
+				relatorio_pedido = 0;
+				exportar_latencias(lat, lat->origem_parcial);
+			}
+		}
+		if (eof) break;
+		pendente = (size_t)(lim - p);
+		if (pendente == BLOCO_LEITURA) {
+			fprintf(stderr, "Erro: linha maior que %d bytes.\n", BLOCO_LEITURA);
+			st->erros++;
+			break;
+		}
+		memmove(buf, p, pendente);
+	}
+	free(buf);
+	return ok;
+}
+
+// Emite os registros de um arquivo .xcn, bloco a bloco: cada bloco é
+// conferido contra o seu resumo e percorrido no próprio mapa. *primeiro
+// recebe o instante (agora_seg) em que o primeiro registro foi emitido.
+// Retorna 0 se um bloco está corrompido (nada dele é emitido).
+static int processar_cenarios(Cenarios* c, Saida* out, Formato formato, LoteStats* st, Latencias* lat,
+                              double* primeiro) {
+	for (uint64_t b = 0; b < c->blocos; b++) {
+		size_t qtd;
+		const CenarioRegistro* r = cenarios_bloco(c, b, &qtd);
+		if (!r) {
+			fprintf(stderr, "Erro: bloco %llu corrompido (resumo não confere).\n", (unsigned long long)b);
+			return 0;
+		}
+		for (size_t i = 0; i < qtd; i++, r++) {
+			st->linhas++;
+			uint64_t t0 = lat ? latencia_agora() : 0;
+			Params reg = { (int)r->torre, (int)r->bispo, (int)r->rainha, (int)r->cavalo_v, (int)r->cavalo_h };
+			int valido = r->torre <= LIMITE_PASSOS && r->bispo <= LIMITE_PASSOS && r->rainha <= LIMITE_PASSOS &&
+			             r->cavalo_v <= LIMITE_PASSOS && r->cavalo_h <= LIMITE_PASSOS;
+			uint64_t t1 = 0;
+			if (lat) {
+				t1 = latencia_agora();
+				histograma_registrar(&lat->fase[FASE_LEITURA], t1 - t0);
+			}
+			if (valido) {
+				uint64_t e0 = lat ? lat->cronometro->ns : 0;
+				emitir_registro(out, formato, &reg);
+				if (lat) registrar_latencias(lat, t0, t1, latencia_agora(), lat->cronometro->ns - e0);
+				if (!st->registros++) *primeiro = agora_seg();
+				st->passos += passos_de(&reg);
+			} else if (++st->erros <= 10) {
+				fprintf(stderr, "Registro %llu inválido\n", (unsigned long long)st->linhas);
+			}
+			if (lat && relatorio_pedido) {
+				relatorio_pedido = 0;
+				exportar_latencias(lat, lat->origem_parcial);
+			}
+		}
+	}
+	return 1;
+}
+
+// Pipe entre filho e pai: os histogramas passam do buffer do pipe, então
+// leitura e escrita repetem até o fim.
+static int enviar(int fd, const void* p, size_t n) {
+	const char* c = p;
+	while (n > 0) {
+		ssize_t w = write(fd, c, n);
+		if (w < 0 && errno == EINTR) continue;
+		if (w <= 0) return 0;
+		c += w;
+		n -= (size_t)w;
+	}
+	return 1;
+}
+
+static int receber(int fd, void* p, size_t n) {
+	char* c = p;
+	while (n > 0) {
+		ssize_t r = read(fd, c, n);
+		if (r < 0 && errno == EINTR) continue;
+		if (r <= 0) return 0;
+		c += r;
+		n -= (size_t)r;
+	}
+	return 1;
+}
+
+// Filho de --shards: emite a faixa [ini, fim) no segmento 'seg' e devolve
+// as contagens (e os histogramas, com 'lat') pelo pipe.
+// Código de saída: 0, 1 (linhas inválidas) ou 2 (E/S).
+static void fragmento_filho(int fd, off_t ini, off_t fim, int seg, int canal, Formato formato, int fragmento,
+                            Latencias* lat) {
+	LoteStats st = { 0, 0, 0, 0 };
+	Saida arquivo, cronometrada;
+	CronometroSaida cronometro;
+	Saida* out = &arquivo;
+	if (!saida_abrir(&arquivo, seg, SAIDA_CAP_PADRAO)) _exit(2);
+	if (lat) {
+		if (!saida_abrir_cronometrada(&cronometrada, &cronometro, &arquivo, SAIDA_CAP_PADRAO)) _exit(2);
+		out = &cronometrada;
+		lat->cronometro = &cronometro;
+		snprintf(lat->origem_parcial, sizeof lat->origem_parcial, "parcial fragmento=%d", fragmento);
+	}
+	int ok = processar_lote(fd, ini, fim, out, formato, &st, lat);
+	if (lat) ok = saida_fechar(&cronometrada) && ok;
+	ok = saida_fechar(&arquivo) && ok;
+	ok = enviar(canal, &st, sizeof st) && ok;
+	if (lat) ok = enviar(canal, lat->fase, sizeof lat->fase) && ok;
+	_exit(!ok ? 2 : st.erros ? 1 : 0);
+}
+
+// --shards=N: cabeçalho pelo pai, faixas pelos filhos, junção em ordem e
+// rodapé pelo pai. Com 'lat', os histogramas dos filhos são somados nele.
+static int rodar_fragmentos(const char* caminho, int n, Formato formato, int stats, Latencias* lat) {
+	int fd = strcmp(caminho, "-") ? open(caminho, O_RDONLY) : dup(0);
+	struct stat st_arq;
+	if (fd < 0 || fstat(fd, &st_arq) != 0) {
+		perror(caminho);
+		return 1;
+	}
+	if (!S_ISREG(st_arq.st_mode)) {
+		fprintf(stderr, "Erro: --shards exige um arquivo regular (não um pipe).\n");
+		close(fd);
+		return 1;
+	}
+	off_t limites[SHARDS_MAX + 1];
+	limites[0] = 0;
+	for (int i = 1; i < n; i++) {
+		off_t alvo = (off_t)((double)st_arq.st_size * i / n);
+		limites[i] = alinhar_linha(fd, alvo < limites[i - 1] ? limites[i - 1] : alvo, st_arq.st_size);
+	}
+	limites[n] = st_arq.st_size;
+
+	Saida out;
+	if (!saida_abrir(&out, 1, SAIDA_CAP_PADRAO)) {
+		fprintf(stderr, "Erro: sem memória para o buffer de saída.\n");
+		close(fd);
+		return 1;
+	}
+	double t0 = agora_seg();
+	emitir_cabecalho(&out, formato);
+	int ok = saida_flush(&out);
+
+	int seg[SHARDS_MAX], canal[SHARDS_MAX];
+	pid_t filho[SHARDS_MAX];
+	int criados = 0;
+	// SIGUSR1 fica bloqueado em volta de cada fork: o filho só o recebe
+	// depois de instalar o próprio tratador, e o pai só repassa a filhos
+	// já registrados.
+	sigset_t usr1, anterior;
+	sigemptyset(&usr1);
+	sigaddset(&usr1, SIGUSR1);
+	if (lat) tratar_sigusr1(repassar_relatorio);
+	for (; ok && criados < n; criados++) {
+		int tubo[2];
+		seg[criados] = segmento_temporario();
+		if (seg[criados] < 0 || pipe(tubo) != 0) {
+			perror("segmento");
+			if (seg[criados] >= 0) close(seg[criados]);
+			ok = 0;
+			break;
+		}
+		sigprocmask(SIG_BLOCK, &usr1, &anterior);
+		pid_t pid = fork();
+		if (pid < 0) {
+			sigprocmask(SIG_SETMASK, &anterior, NULL);
+			perror("fork");
+			close(tubo[0]);
+			close(tubo[1]);
+			close(seg[criados]);
+			ok = 0;
+			break;
+		}
+		if (pid == 0) {
+			close(tubo[0]);
+			if (lat) tratar_sigusr1(pedir_relatorio);
+			sigprocmask(SIG_SETMASK, &anterior, NULL);
+			fragmento_filho(fd, limites[criados], limites[criados + 1], seg[criados], tubo[1], formato, criados, lat);
+		}
+		filhos_relatorio[criados] = pid;
+		qtd_filhos_relatorio = criados + 1;
+		sigprocmask(SIG_SETMASK, &anterior, NULL);
+		close(tubo[1]);
+		canal[criados] = tubo[0];
+		filho[criados] = pid;
+	}
+
+	LoteStats total = { 0, 0, 0, 0 };
+	JuncaoStats juncao = { { 0 } };
+	int invalidas = 0;
+	for (int i = 0; i < criados; i++) {
+		LoteStats st;
+		int status = 0;
+		int recebeu = receber(canal[i], &st, sizeof st);
+		if (recebeu && lat) {
+			static Histograma fases[FASE_QTD];
+			recebeu = receber(canal[i], fases, sizeof fases);
+			for (int f = 0; recebeu && f < FASE_QTD; f++) histograma_juntar(&lat->fase[f], &fases[f]);
+		}
+		close(canal[i]);
+		waitpid(filho[i], &status, 0);
+		if (!recebeu || !WIFEXITED(status) || WEXITSTATUS(status) == 2) {
+			fprintf(stderr, "Erro: fragmento %d falhou.\n", i);
+			ok = 0;
+		} else {
+			invalidas |= WEXITSTATUS(status) == 1;
+			total.linhas += st.linhas;
+			total.registros += st.registros;
+			total.passos += st.passos;
+			total.erros += st.erros;
+		}
+	}
+	close(fd);
+	qtd_filhos_relatorio = 0;
+	for (int i = 0; i < criados; i++) {
+		if (ok && !segmento_anexar(1, seg[i], &juncao)) {
+			perror("junção dos segmentos");
+			ok = 0;
+		}
+		close(seg[i]);
+	}
+
+	// O rodapé vai depois dos segmentos: a posição do fd já avançou com eles.
+	// Com um fragmento perdido a saída está incompleta e fica sem ele.
+	if (ok) emitir_rodape(&out, formato);
+	uint64_t bytes_pai = out.total + out.len;
+	ok = saida_fechar(&out) && ok;
+	double dt = agora_seg() - t0;
+	if (!ok) {
+		fprintf(stderr, "Erro: falha ao escrever a saída.\n");
+		return 1;
+	}
+	if (stats) {
+		uint64_t bytes = bytes_pai;
+		for (int m = 0; m < JUNCAO_QTD; m++) bytes += juncao.bytes[m];
+		if (dt <= 0) dt = 1e-9;
+		fprintf(stderr,
+			"[stats] formato=%s registros=%llu passos=%llu bytes=%llu tempo=%.6fs "
+			"passos/s=%.0f MB/s=%.1f\n",
+			nome_formato(formato), (unsigned long long)total.registros, (unsigned long long)total.passos,
+			(unsigned long long)bytes, dt, (double)total.passos / dt, (double)bytes / dt / 1e6);
+		fprintf(stderr, "[stats] shards=%d junção:", n);
+		for (int m = 0; m < JUNCAO_QTD; m++) fprintf(stderr, " %s=%llu", NOME_JUNCAO[m], (unsigned long long)juncao.bytes[m]);
+		fprintf(stderr, " bytes\n");
+	}
+	if (lat) exportar_latencias(lat, NULL);
+	return invalidas ? 1 : 0;
 }
 
 int main(int argc, char** argv) {
 	Params p = {5, 5, 8, 2, 1};
+	Formato formato = FORMATO_TEXTO;
+	int stats = 0;
+	int blocos = 0; // 0 = sem anel (escrita síncrona)
+	int comprimir = 0;
+	int resumir = 0;
+	const char* lote = NULL;
+	const char* cenarios = NULL;
+	int shards = 0;
+	int medir = 0; // --latencia: 1 = texto, 2 = json
+	const char* pos[5];
+	int npos = 0;
 
 	if (argc == 2 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))) {
 		usage(argv[0]);
 		return 0;
 	}
 
-	if (argc > 1) {
-		if (argc != 6) {
+	for (int i = 1; i < argc; i++) {
+		if (!strncmp(argv[i], "--format=", 9)) {
+			if (!formato_de_nome(argv[i] + 9, &formato)) {
+				fprintf(stderr, "Erro: formato desconhecido '%s'.\n", argv[i] + 9);
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--stats")) {
+			stats = 1;
+		} else if (!strcmp(argv[i], "--compress")) {
+			comprimir = 1;
+		} else if (!strcmp(argv[i], "--digest")) {
+			resumir = 1;
+		} else if (!strcmp(argv[i], "--latencia") || !strcmp(argv[i], "--latencia=text")) {
+			medir = 1;
+		} else if (!strcmp(argv[i], "--latencia=json")) {
+			medir = 2;
+		} else if (!strncmp(argv[i], "--lote=", 7) && argv[i][7]) {
+			lote = argv[i] + 7;
+		} else if (!strncmp(argv[i], "--cenarios=", 11) && argv[i][11]) {
+			cenarios = argv[i] + 11;
+		} else if (!strncmp(argv[i], "--shards=", 9)) {
+			if (!parse_int(argv[i] + 9, &shards) || shards < 1 || shards > SHARDS_MAX) {
+				fprintf(stderr, "Erro: número de shards inválido '%s'.\n", argv[i] + 9);
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--anel")) {
+			blocos = ANEL_BLOCOS_PADRAO;
+		} else if (!strncmp(argv[i], "--anel=", 7)) {
+			if (!parse_int(argv[i] + 7, &blocos) || blocos < 2 || blocos > ANEL_BLOCOS_MAX) {
+				fprintf(stderr, "Erro: número de blocos do anel inválido '%s'.\n", argv[i] + 7);
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (npos < 5) {
+			pos[npos++] = argv[i];
+		} else {
+			npos++;
+		}
+	}
+
+	if (lote && npos > 0) {
+		fprintf(stderr, "Erro: --lote substitui os argumentos posicionais.\n");
+		usage(argv[0]);
+		return 1;
+	}
+	if (cenarios && (lote || npos > 0)) {
+		fprintf(stderr, "Erro: --cenarios substitui --lote e os argumentos posicionais.\n");
+		usage(argv[0]);
+		return 1;
+	}
+	if (shards && (!lote || comprimir || blocos || resumir)) {
+		fprintf(stderr, "Erro: --shards exige --lote e não se combina com --compress, --anel nem --digest.\n");
+		usage(argv[0]);
+		return 1;
+	}
+	if (npos > 0) {
+		if (npos != 5) {
 			fprintf(stderr, "Erro: número de argumentos inválido.\n");
 			usage(argv[0]);
 			return 1;
 		}
-		if (!parse_int(argv[1], &p.torre) ||
-			!parse_int(argv[2], &p.bispo) ||
-			!parse_int(argv[3], &p.rainha) ||
-			!parse_int(argv[4], &p.cavV) ||
-			!parse_int(argv[5], &p.cavH)) {
+		if (!parse_int(pos[0], &p.torre) ||
+			!parse_int(pos[1], &p.bispo) ||
+			!parse_int(pos[2], &p.rainha) ||
+			!parse_int(pos[3], &p.cavV) ||
+			!parse_int(pos[4], &p.cavH)) {
 			fprintf(stderr, "Erro: parâmetros fora do formato ou limites.\n");
 			usage(argv[0]);
 			return 1;
 		}
 	}
+	if (resumir && (comprimir || blocos)) {
+		fprintf(stderr, "Erro: --digest não se combina com --compress nem --anel.\n");
+		usage(argv[0]);
+		return 1;
+	}
+	// Opções todas conferidas acima: daqui em diante só falhas de recurso,
+	// e quem mapeia o .xcn ou abre o lote também o libera ao falhar.
 
-	// Mensagem de configuração
-	printf("=== XADREZ (versão com validações) ===\n");
-	printf("Config: Torre=%d, Bispo=%d, Rainha=%d, Cavalo=(V:%d,H:%d)\n\n",
-		   p.torre, p.bispo, p.rainha, p.cavV, p.cavH);
+	// Grande demais para a pilha de cada chamada; uma por processo basta.
+	static Latencias latencias;
+	Latencias* lat = NULL;
+	if (medir) {
+		lat = &latencias;
+		lat->json = medir == 2;
+		snprintf(lat->origem_parcial, sizeof lat->origem_parcial, "parcial");
+		tratar_sigusr1(pedir_relatorio);
+	}
+	if (shards) return rodar_fragmentos(lote, shards, formato, stats, lat);
 
-	puts("TORRE:");
-	repetir_puts("Direita", p.torre);
-	puts("");
+	// Só o cabeçalho é lido aqui; os registros, bloco a bloco, na emissão.
+	Cenarios arquivo_cenarios;
+	double t_abertura = agora_seg();
+	if (cenarios && !cenarios_abrir(&arquivo_cenarios, cenarios)) {
+		if (errno == EINVAL) {
+			fprintf(stderr, "Erro: '%s' não é um arquivo de cenários válido (cabeçalho, versão ou tamanho).\n", cenarios);
+		} else {
+			perror(cenarios);
+		}
+		return 1;
+	}
 
-	puts("BISPO:");
-	repetir_puts("Cima Direita", p.bispo);
-	puts("");
+	int fd_lote = -1;
+	if (lote) {
+		fd_lote = strcmp(lote, "-") ? open(lote, O_RDONLY) : 0;
+		if (fd_lote < 0) {
+			perror(lote);
+			return 1;
+		}
+	}
+
+	// destino escreve no fd (direto ou pelo anel); com --compress os passos
+	// passam antes pelo compressor, que entrega quadros ao destino. Com
+	// --digest nada é escrito: os blocos só alimentam o hash.
+	Saida destino, comprimida, resumida;
+	AnelSaida anel;
+	CompressorSaida compressor;
+	DigestSaida digest;
+	int aberta = resumir ? saida_abrir_digest(&resumida, &digest, NULL, SAIDA_CAP_PADRAO)
+	           : blocos ? saida_abrir_anel(&destino, &anel, 1, SAIDA_CAP_PADRAO, (unsigned)blocos)
+	                    : saida_abrir(&destino, 1, SAIDA_CAP_PADRAO);
+	if (aberta && comprimir && !saida_abrir_compressao(&comprimida, &compressor, &destino, SAIDA_CAP_PADRAO)) {
+		saida_fechar(&destino);
+		aberta = 0;
+	}
+	Saida* out = resumir ? &resumida : comprimir ? &comprimida : &destino;
+	// Com --latencia, um cronômetro no topo da cadeia mede a emissão.
+	Saida cronometrada;
+	CronometroSaida cronometro;
+	Saida* base = out;
+	if (aberta && lat) {
+		aberta = saida_abrir_cronometrada(&cronometrada, &cronometro, base, SAIDA_CAP_PADRAO);
+		if (aberta) {
+			out = &cronometrada;
+			lat->cronometro = &cronometro;
+		} else {
+			saida_fechar(base);
+			if (comprimir) saida_fechar(&destino);
+		}
+	}
+	if (!aberta) {
+		fprintf(stderr, "Erro: sem memória para o buffer de saída.\n");
+		if (cenarios) cenarios_fechar(&arquivo_cenarios);
+		if (fd_lote > 0) close(fd_lote);
+		return 1;
+	}
+	double t0 = agora_seg(), t_primeiro = t0;
 
-	puts("RAINHA:");
-	repetir_puts("Esquerda", p.rainha);
-	puts("");
+	emitir_cabecalho(out, formato);
+	LoteStats lst = { 0, 0, 0, 0 };
+	int lido = 1;
+	if (lote) {
+		lido = processar_lote(fd_lote, 0, -1, out, formato, &lst, lat);
+		if (!lido) perror(lote);
+		if (fd_lote != 0) close(fd_lote);
+	} else if (cenarios) {
+		lido = processar_cenarios(&arquivo_cenarios, out, formato, &lst, lat, &t_primeiro);
+	} else {
+		uint64_t r0 = lat ? latencia_agora() : 0;
+		emitir_registro(out, formato, &p);
+		if (lat) registrar_latencias(lat, r0, r0, latencia_agora(), cronometro.ns);
+		lst.registros = 1;
+		lst.passos = passos_de(&p);
+	}
+	// Leitura interrompida (E/S ou bloco corrompido): sem o rodapé de sucesso.
+	if (lido) emitir_rodape(out, formato);
 
-	puts("CAVALO:");
-	repetir_puts("Cima", p.cavV);
-	repetir_puts("Direita", p.cavH);
-	puts("");
+	// Com anel, fechar drena os blocos pendentes: o tempo inclui a escrita.
+	int ok = saida_fechar(out);
+	if (out != base) ok = saida_fechar(base) && ok;
+	if (comprimir) ok = saida_fechar(&destino) && ok;
+	double dt = agora_seg() - t0;
+	uint64_t bytes = out->total;
+	if (!ok) {
+		fprintf(stderr, "Erro: falha ao escrever a saída.\n");
+		return 1;
+	}
+	if (!lido) return 1;
+	if (resumir) printf("%016llx %llu\n", (unsigned long long)hash64_final(&digest.hash), (unsigned long long)bytes);
 
-	puts("[OK] Execução concluída com validações");
-	return 0;
+	if (stats) {
+		uint64_t passos = lst.passos;
+		if (dt <= 0) dt = 1e-9;
+		fprintf(stderr, "[stats] formato=%s", nome_formato(formato));
+		if (lote || cenarios) fprintf(stderr, " registros=%llu", (unsigned long long)lst.registros);
+		fprintf(stderr,
+			" passos=%llu bytes=%llu tempo=%.6fs passos/s=%.0f MB/s=%.1f\n",
+			(unsigned long long)passos,
+			(unsigned long long)bytes, dt, (double)passos / dt,
+			(double)bytes / dt / 1e6);
+		if (comprimir) {
+			fprintf(stderr, "[stats] compressão: bruto=%llu comprimido=%llu razão=%.1fx\n",
+				(unsigned long long)bytes, (unsigned long long)destino.total,
+				destino.total ? (double)bytes / (double)destino.total : 0.0);
+		}
+		if (blocos) {
+			fprintf(stderr, "[stats] anel=%dx%d memória=%zu bytes fila: média=%.2f máx=%llu blocos\n",
+				blocos, SAIDA_CAP_PADRAO, anel_memoria(&anel), anel_profundidade_media(&anel),
+				(unsigned long long)anel.profundidade_max);
+			fprintf(stderr, "[stats] anel: esperas do produtor=%llu (%.3fs) esperas da escritora=%llu "
+				"write=%.3fs ganho estimado sobre escrita síncrona=%.2fx\n",
+				(unsigned long long)anel.esperas, anel.ns_espera_produtor / 1e9,
+				(unsigned long long)anel.esperas_consumidora, anel.ns_escrita / 1e9, anel_ganho(&anel));
+		}
+		if (cenarios) {
+			fprintf(stderr, "[stats] cenários: arquivo=%llu registros blocos conferidos=%llu/%llu "
+				"abertura até o primeiro registro=%.0fus\n",
+				(unsigned long long)arquivo_cenarios.n, (unsigned long long)arquivo_cenarios.conferidos,
+				(unsigned long long)arquivo_cenarios.blocos, (t_primeiro - t_abertura) * 1e6);
+		}
+	}
+	if (cenarios) cenarios_fechar(&arquivo_cenarios);
+	if (lat) exportar_latencias(lat, NULL);
+	return lst.erros ? 1 : 0;
 }
-
@@ -3,16 +3,24 @@
 #include <stdlib.h>
 
 // Versão otimizada para reduzir I/O: acumula toda a saída em buffer e imprime uma vez.
+// Se a saída passar de OUT_CAP, o buffer é descarregado cada vez que enche
+// (uma escrita por 32 KiB) em vez de descartar as linhas que não cabem.
 
 #define OUT_CAP (1 << 15) // 32 KiB
 
 static char OUT[OUT_CAP];
 static size_t OFF = 0;
 
+static void descarregar(void) {
+	fwrite(OUT, 1, OFF, stdout);
+	OFF = 0;
+}
+
 static void append_line(const char* s) {
 	if (!s) return;
 	size_t len = strlen(s);
-	if (len + 1 > OUT_CAP - OFF) return; // proteção contra overflow
+	if (len + 1 > OUT_CAP - OFF) descarregar();
+	if (len + 1 > OUT_CAP) return; // linha maior que o buffer inteiro
 	memcpy(OUT + OFF, s, len);
 	OFF += len;
 	OUT[OFF++] = '\n';
@@ -47,7 +55,7 @@ int main(void) {
 	append_line("[OK] Saída gerada em buffer único");
 
 	// Emissão única
-	fwrite(OUT, 1, OFF, stdout);
+	descarregar();
 	return 0;
 }
 
@@ -22,6 +22,25 @@
 */
 
 #include <stdio.h>
+#include <string.h>
+
+#include "../../Movimentacao de Pecas: Algoritmos e Otimizacao/Biblioteca Comum/xadrez_casa.h"
+
+/*
+================================================================================
+ RASTREAMENTO DE POSIÇÃO (COORDENADAS ALGÉBRICAS)
+ 
+ Cada peça parte de uma casa inicial configurável (--inicio=e4) e cada passo
+ atualiza a casa atual. Com --coordenadas, o passo exibe origem→destino
+ usando a tabela pré-calculada de nomes (sem printf por passo). Casa,
+ NOME_CASA, as casas iniciais e a linha do passo vêm de xadrez_casa.h, o
+ mesmo cabeçalho de xadrez_completo.c.
+================================================================================
+*/
+static Casa posicao_atual;           // casa atual da peça em movimento
+static Casa inicio_global;           // casa informada em --inicio=
+static int usar_inicio_global = 0;
+static int exibir_coordenadas = 0;
 
 /*
 ================================================================================
@@ -44,12 +63,16 @@ void mover_bispo_loops_aninhados(int casas_verticais, int casas_horizontais);
 void exibir_cabecalho_mestre(void);
 void exibir_separador(const char* nome_peca);
 
+// Funções de rastreamento de posição (internas: mesma API de xadrez_completo.c)
+static void posicionar_peca(Casa padrao);
+static void registrar_passo(const char* direcao, int dc, int dl);
+
 /*
 ================================================================================
  FUNÇÃO PRINCIPAL - ORQUESTRAÇÃO DO PROGRAMA MESTRE
 ================================================================================
 */
-int main() {
+int main(int argc, char** argv) {
     /*
     ============================================================================
      DECLARAÇÃO DE CONSTANTES E VARIÁVEIS
@@ -71,6 +94,18 @@ int main() {
     const int BISPO_VERTICAL = 5;    // Componente vertical do movimento diagonal
     const int BISPO_HORIZONTAL = 5;  // Componente horizontal do movimento diagonal
     
+    // Opções: --coordenadas (origem→destino por passo), --inicio=<casa>
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--coordenadas")) {
+            exibir_coordenadas = 1;
+        } else if (!strncmp(argv[i], "--inicio=", 9) && casa_de_nome(argv[i] + 9, &inicio_global)) {
+            usar_inicio_global = 1;
+        } else {
+            fprintf(stderr, "Uso: %s [--coordenadas] [--inicio=<casa a1..h8>]\n", argv[0]);
+            return 1;
+        }
+    }
+    
     // Exibir cabeçalho do programa
     exibir_cabecalho_mestre();
     
@@ -89,6 +124,7 @@ int main() {
     ============================================================================
     */
     exibir_separador("TORRE (Recursividade)");
+    posicionar_peca(INICIO_TORRE);
     mover_torre_recursivo(CASAS_TORRE);
     
     /*
@@ -101,9 +137,11 @@ int main() {
     ============================================================================
     */
     exibir_separador("BISPO (Recursividade)");
+    posicionar_peca(INICIO_BISPO);
     mover_bispo_recursivo(CASAS_BISPO);
     
     exibir_separador("BISPO (Loops Aninhados - Vertical + Horizontal)");
+    posicionar_peca(INICIO_BISPO);
     mover_bispo_loops_aninhados(BISPO_VERTICAL, BISPO_HORIZONTAL);
     
     /*
@@ -115,6 +153,7 @@ int main() {
     ============================================================================
     */
     exibir_separador("RAINHA (Recursividade)");
+    posicionar_peca(INICIO_RAINHA);
     mover_rainha_recursivo(CASAS_RAINHA);
     
     /*
@@ -131,6 +170,7 @@ int main() {
     ============================================================================
     */
     exibir_separador("CAVALO (Loops Complexos - Movimento em L: Cima + Direita)");
+    posicionar_peca(INICIO_CAVALO_MESTRE);
     
     /*
     ============================================================================
@@ -167,7 +207,7 @@ int main() {
                     break; // Proteção redundante
                 }
                 
-                printf("Cima\n");
+                registrar_passo("Cima", 0, 1);
                 total_movimentos++;
                 
                 // Simulação de condição especial para demonstrar 'continue'
@@ -191,7 +231,7 @@ int main() {
             // Loop interno para movimentos da segunda etapa
             for (movimento_atual = 0; movimento_atual < CAVALO_DIREITA; movimento_atual++) {
                 
-                printf("Direita\n");
+                registrar_passo("Direita", 1, 0);
                 total_movimentos++;
                 
                 // Condição de finalização do movimento em "L"
@@ -279,7 +319,7 @@ void mover_torre_recursivo(int casas_restantes) {
      Padrão: executar ação atual + reduzir problema + chamar recursivamente
     ============================================================================
     */
-    printf("Direita\n");                           // Ação atual
+    registrar_passo("Direita", 1, 0);              // Ação atual
     mover_torre_recursivo(casas_restantes - 1);    // Chamada recursiva com problema reduzido
 }
 
@@ -298,7 +338,7 @@ void mover_bispo_recursivo(int casas_restantes) {
     }
     
     // Caso recursivo: movimento diagonal (cima + direita simultaneamente)
-    printf("Cima Direita\n");
+    registrar_passo("Cima Direita", 1, 1);
     mover_bispo_recursivo(casas_restantes - 1);
 }
 
@@ -317,7 +357,7 @@ void mover_rainha_recursivo(int casas_restantes) {
     }
     
     // Caso recursivo: movimento para esquerda
-    printf("Esquerda\n");
+    registrar_passo("Esquerda", -1, 0);
     mover_rainha_recursivo(casas_restantes - 1);
 }
 
@@ -352,11 +392,11 @@ void mover_bispo_loops_aninhados(int casas_verticais, int casas_horizontais) {
         for (int horizontal = 1; horizontal <= 1; horizontal++) { // 1 movimento horizontal por vertical
             
             // Primeiro imprimir componente vertical
-            printf("Cima\n");
+            registrar_passo("Cima", 0, 1);
             
             // Depois imprimir componente horizontal (se não for o último movimento)
             if (vertical <= casas_horizontais) {
-                printf("Direita\n");
+                registrar_passo("Direita", 1, 0);
             }
         }
     }
@@ -386,3 +426,27 @@ void exibir_cabecalho_mestre(void) {
 void exibir_separador(const char* nome_peca) {
     printf("%s:\n", nome_peca);
 }
+
+/*
+================================================================================
+ FUNÇÕES DE RASTREAMENTO DE POSIÇÃO
+ 
+ Mantêm a casa atual e emitem cada passo com uma única escrita (fwrite),
+ consultando a tabela NOME_CASA em vez de formatar coordenadas.
+================================================================================
+*/
+
+// Coloca a peça na casa inicial (--inicio= tem prioridade sobre o padrão).
+static void posicionar_peca(Casa padrao) {
+    posicao_atual = usar_inicio_global ? inicio_global : padrao;
+}
+
+// Aplica o deslocamento (dc, dl) e emite a linha do passo com uma única escrita.
+static void registrar_passo(const char* direcao, int dc, int dl) {
+    Casa de = posicao_atual;
+    posicao_atual.coluna += dc;
+    posicao_atual.linha += dl;
+
+    char linha[PASSO_LINHA_MAX];
+    fwrite(linha, 1, formatar_passo(linha, direcao, de, posicao_atual, exibir_coordenadas), stdout);
+}
@@ -144,6 +144,283 @@ if [ $USE_HYPERFINE -eq 1 ]; then
     echo ""
 fi
 
+# ═══════════════════════════════════════════════════════════════
+# VAZÃO POR FORMATO DE SAÍDA (text/csv/jsonl/bin)
+# ═══════════════════════════════════════════════════════════════
+
+echo "════════════════════════════════════════════════════════════"
+echo "📈 VAZÃO POR FORMATO (otim_validacoes --stats, saída em /dev/null)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+for n in 1000000 10000000 100000000; do
+    for fmt in text csv jsonl bin; do
+        "$BIN_DIR/otim_validacoes" --format=$fmt --stats $n 0 0 0 0 2>&1 > /dev/null
+    done
+    echo ""
+done
+
+echo "Escrita síncrona vs anel de blocos (--anel, fila SPSC sem trava; saída em pipe):"
+for fmt in text csv; do
+    "$BIN_DIR/otim_validacoes" --format=$fmt --stats 20000000 0 0 0 0 2>&1 > >(cat > /dev/null)
+    for blocos in 2 4 16; do
+        "$BIN_DIR/otim_validacoes" --format=$fmt --stats --anel=$blocos 20000000 0 0 0 0 2>&1 > >(cat > /dev/null)
+    done
+done
+echo ""
+
+# ═══════════════════════════════════════════════════════════════
+# BUSCA COM RAMIFICAÇÃO: PASSEIO DO CAVALO (nós/s por nº de threads)
+# ═══════════════════════════════════════════════════════════════
+
+echo "════════════════════════════════════════════════════════════"
+echo "🐴 PASSEIO DO CAVALO 5x5 (backtracking exaustivo)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+for t in 1 2 4; do
+    echo "threads=$t:"
+    "$BIN_DIR/passeio_cavalo" --modo=contar --tamanho=5 --threads=$t --profundidade=5 | grep -E "Passeios|Nós/s"
+done
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "👑 N-RAINHAS N=14 (benchmark padrão de escala da busca recursiva)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+"$BIN_DIR/n_rainhas" 14 --escala --threads="$(nproc 2>/dev/null || echo 4)" | tail -n +4
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "📏 DISTÂNCIA DO CAVALO (lote de 2 milhões de pares aleatórios)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+PARES=$(mktemp)
+awk 'BEGIN { srand(42); for (i = 0; i < 2000000; i++)
+    printf "%c%d %c%d\n", 97 + int(rand() * 8), 1 + int(rand() * 8), 97 + int(rand() * 8), 1 + int(rand() * 8) }' > "$PARES"
+"$BIN_DIR/distancia_cavalo" --lote="$PARES" --stats 2>&1 > /dev/null
+"$BIN_DIR/distancia_cavalo" --lote="$PARES" --caminho --stats 2>&1 > /dev/null
+rm -f "$PARES"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🧱 ALCANCE DESLIZANTE (lote de 1 milhão de consultas, 8 obstáculos)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+CONSULTAS=$(mktemp)
+awk 'BEGIN { srand(7); split("torre bispo rainha", P, " "); for (i = 0; i < 1000000; i++) {
+    o = int(rand() * 64); m = ""
+    for (j = 0; j < 8; j++) { c = int(rand() * 64); if (c != o) m = m sprintf("%s%c%d", m == "" ? "" : ",", 97 + c % 8, 1 + int(c / 8)) }
+    printf "%s %c%d %s\n", P[1 + int(rand() * 3)], 97 + o % 8, 1 + int(o / 8), m } }' > "$CONSULTAS"
+"$BIN_DIR/alcance_deslizante" --lote="$CONSULTAS" --stats 2>&1 > /dev/null
+"$BIN_DIR/alcance_deslizante" --lote="$CONSULTAS" --k=2 --stats 2>&1 > /dev/null
+rm -f "$CONSULTAS"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "📐 TABULEIRO GENÉRICO (1 milhão de movimentos da Rainha)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+for cfg in "8x8 8 densa" "8x8 8 esparsa" "16x16 32 densa" "16x16 32 esparsa" \
+           "1000x1000 10000 esparsa" "1000000x1000000 100000 esparsa"; do
+    set -- $cfg
+    echo -n "  $1 ($2 obstáculos, $3): "
+    "$BIN_DIR/simulacao_tabuleiro" --tamanho="$1" --pecas="$2" --representacao="$3" | grep "Movimentos/s"
+done
+set --
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🦄 MOTOR DE PEÇAS (kernel especializado x caminho genérico)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+for peca in cavalo rei rainha arcebispo; do
+    echo "  $peca (8x8, 8 obstáculos):"
+    "$BIN_DIR/motor_pecas" --peca=$peca --pecas=8 --bench=5000000 | tail -4 | sed 's/^/    /'
+done
+echo "  rainha (10^6 x 10^6, 100000 obstáculos):"
+"$BIN_DIR/motor_pecas" --peca=rainha --tamanho=1000000x1000000 --pecas=100000 --bench=2000000 | tail -4 | sed 's/^/    /'
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "📥 CARGA DE FEN (10 milhões de posições, mmap)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+FENS=$(mktemp)
+"$BIN_DIR/carga_fen" --gerar=10000000 > "$FENS"
+for t in 1 2 4; do
+    "$BIN_DIR/carga_fen" "$FENS" --threads=$t --stats 2>&1 > /dev/null
+done
+echo "Com avaliação de mobilidade (--avaliar):"
+for t in 1 2 4; do
+    "$BIN_DIR/carga_fen" "$FENS" --threads=$t --stats --avaliar 2>&1 > /dev/null
+done
+echo "Popcount em software, para comparar:"
+"$BIN_DIR/carga_fen" "$FENS" --threads=1 --stats --avaliar --popcount=software 2>&1 > /dev/null
+rm -f "$FENS"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🧮 ATAQUES EM LOTE (4 milhões de tabuleiros, escalar vs AVX2 vs AVX-512)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+FENS=$(mktemp)
+"$BIN_DIR/carga_fen" --gerar=4000000 > "$FENS"
+"$BIN_DIR/ataques_lote" "$FENS" --bench --repeticoes=10
+rm -f "$FENS"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "♟️  PERFT, FAZER/DESFAZER E REPRODUÇÃO DE PGN (100 mil partidas, mmap)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+"$BIN_DIR/perft" 5 --stats > /dev/null
+"$BIN_DIR/perft" 5 --incremental --stats > /dev/null
+"$BIN_DIR/perft" --bench-fazer=10000000 --fen="r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1" | sed 's/^/  /'
+PGNS=$(mktemp)
+"$BIN_DIR/reproducao_pgn" --gerar=100000 > "$PGNS"
+for t in 1 2 4; do
+    "$BIN_DIR/reproducao_pgn" "$PGNS" --threads=$t --stats 2>&1 > /dev/null
+done
+rm -f "$PGNS"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🗜️  COMPRESSÃO DE TRAÇOS (--compress, razão e MB/s; descomprimir)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+TRACO=$(mktemp)
+for traco in "Torre:10000000 0 0 0 0" "Rainha:0 0 10000000 0 0" "Cavalo:0 0 0 5000000 5000000"; do
+    nome=${traco%%:*}
+    for fmt in text csv; do
+        echo "$nome ($fmt):"
+        "$BIN_DIR/otim_validacoes" --format=$fmt --stats ${traco#*:} 2>&1 > /dev/null | sed 's/^/  /'
+        "$BIN_DIR/otim_validacoes" --format=$fmt --compress --stats ${traco#*:} 2>&1 > "$TRACO" | sed 's/^/  /'
+        "$BIN_DIR/descomprimir" "$TRACO" --stats 2>&1 > /dev/null | sed 's/^/  /'
+    done
+done
+rm -f "$TRACO"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🔐 RESUMO DA SAÍDA (--digest: xxh64 no escritor vs escrever o traço)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+TRACO=$(mktemp)
+for fmt in text csv bin; do
+    echo "Torre 10^7 ($fmt):"
+    "$BIN_DIR/otim_validacoes" --format=$fmt --stats 10000000 0 0 0 0 2>&1 > "$TRACO" | sed 's/^/  escrita: /'
+    "$BIN_DIR/otim_validacoes" --format=$fmt --digest --stats 10000000 0 0 0 0 2>&1 > /dev/null | sed 's/^/  resumo:  /'
+done
+rm -f "$TRACO"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🧩 LOTE EM FRAGMENTOS (--shards=N vs um processo; 5000 registros, ~360 MB em CSV)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+LOTE=$(mktemp)
+TRACO=$(mktemp)
+awk 'BEGIN { srand(3); for (i = 0; i < 5000; i++) printf "%d %d %d %d %d\n", int(rand() * 2000), int(rand() * 200), int(rand() * 2000), int(rand() * 100), int(rand() * 100) }' > "$LOTE"
+echo "Um processo:"
+"$BIN_DIR/otim_validacoes" --format=csv --lote="$LOTE" --stats 2>&1 > "$TRACO" | sed 's/^/  /'
+for n in 2 4 $(nproc); do
+    echo "--shards=$n (destino arquivo / pipe):"
+    "$BIN_DIR/otim_validacoes" --format=csv --lote="$LOTE" --shards=$n --stats 2>&1 > "$TRACO" | sed 's/^/  /'
+    "$BIN_DIR/otim_validacoes" --format=csv --lote="$LOTE" --shards=$n --stats 2>&1 > >(cat > /dev/null) | sed 's/^/  /'
+done
+rm -f "$LOTE" "$TRACO"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "⏱️  LATÊNCIA POR REGISTRO (--latencia: custo e percentis por fase)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+LOTE=$(mktemp)
+awk 'BEGIN { srand(5); for (i = 0; i < 20000; i++) printf "%d %d %d %d %d\n", int(rand() * 200), int(rand() * 20), int(rand() * 200), int(rand() * 10), int(rand() * 10) }' > "$LOTE"
+echo "Sem medição:"
+"$BIN_DIR/otim_validacoes" --format=csv --lote="$LOTE" --stats 2>&1 > /dev/null | sed 's/^/  /'
+echo "Com --latencia:"
+"$BIN_DIR/otim_validacoes" --format=csv --lote="$LOTE" --stats --latencia 2>&1 > /dev/null | sed 's/^/  /'
+rm -f "$LOTE"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🔁 RECURSÃO VS ITERAÇÃO (ns/passo e pilha por quadro; -O0/-O2/-O3)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+for nivel in O0 O2 O3; do
+    "$BIN_DIR/recursao_iteracao_$nivel"
+    echo ""
+done
+
+echo "════════════════════════════════════════════════════════════"
+echo "🧭 DESPACHO ADAPTATIVO (regras calibradas por destino; implementação por pedido)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+PEDIDOS="torre:5 bispo:100 rainha:10000 cavalo:2,1 torre:1000000 rainha:10000000"
+echo "Destino arquivo:"
+SAIDA_DESP=$(mktemp)
+"$BIN_DIR/despacho_adaptativo" --stats $PEDIDOS 2>&1 > "$SAIDA_DESP" | sed 's/^/  /'
+rm -f "$SAIDA_DESP"
+echo "Destino pipe:"
+"$BIN_DIR/despacho_adaptativo" --stats $PEDIDOS 2>&1 > >(cat > /dev/null) | sed 's/^/  /'
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "🧪 TESTE DIFERENCIAL (matriz completa, n até 10^7, uma thread por núcleo)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+"$BIN_DIR/teste_diferencial" --stats 2>&1 | sed 's/^/  /'
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "📦 CENÁRIOS PRÉ-COMPILADOS (abertura até o primeiro registro, 1 K vs 5 M)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+CEN_DIR=$(mktemp -d)
+for n in 1000 5000000; do
+    "$BIN_DIR/compilar_cenarios" --gerar=$n --max=0 > "$CEN_DIR/lista.txt"
+    echo "$n cenários:"
+    "$BIN_DIR/compilar_cenarios" "$CEN_DIR/lista.txt" "$CEN_DIR/c.xcn" --stats 2>&1 | sed 's/^/  /'
+    "$BIN_DIR/otim_validacoes" --cenarios="$CEN_DIR/c.xcn" --digest --stats 2>&1 > /dev/null | grep 'cenários' | sed 's/^/  /'
+    ( time "$BIN_DIR/otim_validacoes" --lote="$CEN_DIR/lista.txt" --digest ) 2>&1 > /dev/null | grep real | sed 's/^/  --lote (texto):    /'
+    ( time "$BIN_DIR/otim_validacoes" --cenarios="$CEN_DIR/c.xcn" --digest ) 2>&1 > /dev/null | grep real | sed 's/^/  --cenarios (.xcn): /'
+done
+rm -rf "$CEN_DIR"
+echo ""
+
+echo "════════════════════════════════════════════════════════════"
+echo "♛ TABELAS DE FINAIS (KQK/KRK por análise retrógrada, 1 thread vs uma por núcleo)"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+FINAIS_DIR=$(mktemp -d)
+for t in 1 "$(nproc)"; do
+    echo "Threads: $t"
+    "$BIN_DIR/tabela_finais" --gerar --threads="$t" --dir="$FINAIS_DIR" | sed 's/^/  /'
+done
+echo "Conferência completa:"
+( time "$BIN_DIR/tabela_finais" --verificar --dir="$FINAIS_DIR" ) 2>&1 | grep -v '^$' | sed 's/^/  /'
+rm -rf "$FINAIS_DIR"
+echo ""
+
 # ═══════════════════════════════════════════════════════════════
 # ANÁLISE DE TAMANHO DOS BINÁRIOS
 # ═══════════════════════════════════════════════════════════════
@@ -72,15 +72,17 @@ test_line_count() {
 }
 
 # Função de teste de conteúdo (procura por palavras-chave)
+# Argumentos extras após a palavra-chave são repassados ao executável
 test_content() {
     local name=$1
     local exec=$2
     local keyword=$3
+    shift 3
     
     ((TOTAL++))
     echo -n "[$TOTAL] Testando $name (conteúdo: '$keyword')... "
     
-    if "$exec" 2>/dev/null | grep -q "$keyword"; then
+    if "$exec" "$@" 2>/dev/null | grep -qF -- "$keyword"; then
         echo -e "${GREEN}✓ PASSOU${NC}"
         ((PASS++))
         return 0
@@ -162,6 +164,9 @@ test_exit_code "Mestre" "$BIN_DIR/mestre"
 test_line_count "Mestre" "$BIN_DIR/mestre" 35
 test_content "Mestre" "$BIN_DIR/mestre" "Recursividade"
 test_content "Mestre" "$BIN_DIR/mestre" "Loops Aninhados"
+test_content "Mestre (--coordenadas)" "$BIN_DIR/mestre" "Direita b3→c3" --coordenadas
+test_content "Mestre (--inicio=e4)" "$BIN_DIR/mestre" "Cima Direita e4→f5" --coordenadas --inicio=e4
+test_content "Xadrez Completo (--coordenadas)" "$BIN_DIR/xadrez_completo" "Esquerda g6→f6" --coordenadas
 echo ""
 
 # ═══════════════════════════════════════════════════════════════
@@ -212,6 +217,105 @@ else
     ((FAIL++))
 fi
 
+# Formatos estruturados
+test_content "Com Validações (--format=csv)" "$BIN_DIR/otim_validacoes" "torre,5,direita,4,0,5,0" --format=csv
+test_content "Com Validações (--format=jsonl)" "$BIN_DIR/otim_validacoes" '"peca":"cavalo","passo":3' --format=jsonl
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Com Validações (--format=bin, tamanho)... "
+bin_bytes=$("$BIN_DIR/otim_validacoes" --format=bin 2>/dev/null | wc -c)
+if [ "$bin_bytes" -eq $((8 + 21 * 28)) ]; then
+    echo -e "${GREEN}✓ PASSOU${NC} ($bin_bytes bytes)"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (esperado: $((8 + 21 * 28)), obtido: $bin_bytes)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Com Validações (formato inválido - deve falhar)... "
+if "$BIN_DIR/otim_validacoes" --format=xml > /dev/null 2>&1; then
+    echo -e "${RED}✗ FALHOU${NC} (deveria ter retornado erro)"
+    ((FAIL++))
+else
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+fi
+
+# Anel de blocos: mesma saída byte a byte que a escrita síncrona
+((TOTAL++))
+echo -n "[$TOTAL] Testando Com Validações (--anel, saída idêntica)... "
+anel_ok=1
+for fmt in text csv bin; do
+    if ! cmp -s <("$BIN_DIR/otim_validacoes" --format=$fmt 200000 3 7 2 1 2>/dev/null) \
+                <("$BIN_DIR/otim_validacoes" --format=$fmt --anel=2 200000 3 7 2 1 2>/dev/null); then
+        anel_ok=0
+    fi
+done
+if [ $anel_ok -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (saída com anel difere)"
+    ((FAIL++))
+fi
+
+# Leitor lento com blocos pequenos: as duas pontas da fila esperam e dormem
+((TOTAL++))
+echo -n "[$TOTAL] Testando Com Validações (--anel=2 em pipe lento, resumo e estatísticas da fila)... "
+anel_esperado=$("$BIN_DIR/otim_validacoes" --format=csv 0 0 2000000 0 0 | cksum)
+ANEL_TMP=$(mktemp)
+anel_stats=$( { "$BIN_DIR/otim_validacoes" --format=csv --anel=2 --stats 0 0 2000000 0 0 | dd bs=4096 status=none | cksum > "$ANEL_TMP"; } 2>&1 )
+anel_obtido=$(cat "$ANEL_TMP")
+rm -f "$ANEL_TMP"
+if [ "$anel_obtido" = "$anel_esperado" ] && echo "$anel_stats" | grep -q "esperas da escritora=" && \
+   echo "$anel_stats" | grep -q "fila: média="; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Com Validações (--anel, falha de escrita - deve falhar)... "
+if [ -w /dev/full ] && "$BIN_DIR/otim_validacoes" --anel 1000000 0 0 0 0 > /dev/full 2>/dev/null; then
+    echo -e "${RED}✗ FALHOU${NC} (deveria ter retornado erro)"
+    ((FAIL++))
+else
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+fi
+
+# Compressão: ida e volta pelo descompressor devolve a saída original
+((TOTAL++))
+echo -n "[$TOTAL] Testando Com Validações (--compress + descomprimir)... "
+comp_ok=1
+for fmt in text csv; do
+    if ! cmp -s <("$BIN_DIR/otim_validacoes" --format=$fmt 200000 3 50000 2 1 2>/dev/null) \
+                <("$BIN_DIR/otim_validacoes" --format=$fmt --compress --anel 200000 3 50000 2 1 2>/dev/null | "$BIN_DIR/descomprimir"); then
+        comp_ok=0
+    fi
+done
+comp_bytes=$("$BIN_DIR/otim_validacoes" --compress 200000 0 0 0 0 | wc -c)
+if [ $comp_ok -eq 1 ] && [ "$comp_bytes" -lt 20000 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC} (texto de 200000 passos em $comp_bytes bytes)"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (ida e volta: $comp_ok, tamanho: $comp_bytes)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Descomprimir (fluxo truncado - deve falhar)... "
+if "$BIN_DIR/otim_validacoes" --format=csv --compress 100000 0 0 0 0 | head -c 5000 | "$BIN_DIR/descomprimir" > /dev/null 2>&1; then
+    echo -e "${RED}✗ FALHOU${NC} (deveria ter retornado erro)"
+    ((FAIL++))
+else
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+fi
+
 # Teste com parâmetros inválidos (deve falhar)
 ((TOTAL++))
 echo -n "[$TOTAL] Testando Com Validações (parâmetros inválidos - deve falhar)... "
@@ -224,6 +328,616 @@ else
 fi
 echo ""
 
+# ═══════════════════════════════════════════════════════════════
+# TESTES - Ferramentas
+# ═══════════════════════════════════════════════════════════════
+
+echo "───────────────────────────────────────────────────────────"
+echo "🐴 Testando PASSEIO DO CAVALO"
+echo "───────────────────────────────────────────────────────────"
+test_exit_code "Passeio do Cavalo (Warnsdorff 5x5)" "$BIN_DIR/passeio_cavalo"
+test_content "Passeio do Cavalo (Warnsdorff 8x8)" "$BIN_DIR/passeio_cavalo" "Passeio aberto com 64 casas" --tamanho=8 --inicio=e4
+test_content "Passeio do Cavalo (contagem 5x5)" "$BIN_DIR/passeio_cavalo" "Passeios encontrados: 304" --modo=contar
+test_content "Passeio do Cavalo (contagem 3 threads)" "$BIN_DIR/passeio_cavalo" "Passeios encontrados: 304" --modo=contar --threads=3 --profundidade=5
+test_content "Passeio do Cavalo (fechados 5x6)" "$BIN_DIR/passeio_cavalo" "Passeios fechados: 16" --modo=contar --tamanho=5x6 --inicio=c3 --fechados
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Passeio do Cavalo (7x7 de b1 recusado pela cor, sem busca)... "
+passeio_out=$(timeout 10 "$BIN_DIR/passeio_cavalo" --tamanho=7 --inicio=b1); passeio_rc=$?
+if [ $passeio_rc -eq 2 ] && echo "$passeio_out" | grep -q "^Nenhum passeio a partir desta casa"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (código $passeio_rc)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Passeio do Cavalo (--nos esgotado termina com erro)... "
+timeout 10 "$BIN_DIR/passeio_cavalo" --tamanho=6 --modo=contar --threads=2 --nos=1000000 > /dev/null 2>&1; passeio_rc1=$?
+timeout 10 "$BIN_DIR/passeio_cavalo" --tamanho=8 --inicio=e4 --nos=1000 > /dev/null 2>&1; passeio_rc2=$?
+if [ $passeio_rc1 -eq 1 ] && [ $passeio_rc2 -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (códigos: $passeio_rc1, $passeio_rc2)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Passeio do Cavalo (--tamanho com sobra - deve falhar)... "
+passeio_aceitos=0
+for tam in 5x 6abc 6x6abc x5; do
+    "$BIN_DIR/passeio_cavalo" --tamanho=$tam > /dev/null 2>&1 && ((passeio_aceitos++))
+done
+if [ $passeio_aceitos -eq 0 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} ($passeio_aceitos aceito(s))"
+    ((FAIL++))
+fi
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "👑 Testando N-RAINHAS"
+echo "───────────────────────────────────────────────────────────"
+test_exit_code "N-Rainhas (N=8)" "$BIN_DIR/n_rainhas"
+test_content "N-Rainhas (N=8)" "$BIN_DIR/n_rainhas" "Soluções: 92"
+test_content "N-Rainhas (N=11, 3 threads)" "$BIN_DIR/n_rainhas" "Soluções: 2680" 11 --threads=3
+test_content "N-Rainhas (N=1)" "$BIN_DIR/n_rainhas" "Soluções: 1" 1
+test_content "N-Rainhas (listar N=4)" "$BIN_DIR/n_rainhas" "2 4 1 3" 4 --listar=1
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "📏 Testando DISTÂNCIA DO CAVALO"
+echo "───────────────────────────────────────────────────────────"
+test_content "Distância do Cavalo (a1→h8)" "$BIN_DIR/distancia_cavalo" "6 salto(s)" a1 h8
+test_content "Distância do Cavalo (a1→b2)" "$BIN_DIR/distancia_cavalo" "4 salto(s)" a1 b2
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Distância do Cavalo (lote)... "
+lote_out=$(printf "a1 h8\nb1,c3\n\nh8 h8" | "$BIN_DIR/distancia_cavalo" --lote=- 2>/dev/null | tr '\n' '|')
+if [ "$lote_out" = "a1 h8 6|b1 c3 1|h8 h8 0|" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $lote_out)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Distância do Cavalo (lote com linha inválida - deve falhar)... "
+if printf "a1 z9\n" | "$BIN_DIR/distancia_cavalo" --lote=- > /dev/null 2>&1; then
+    echo -e "${RED}✗ FALHOU${NC} (deveria ter retornado erro)"
+    ((FAIL++))
+else
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Distância do Cavalo (erro de leitura do lote - deve falhar)... "
+if "$BIN_DIR/distancia_cavalo" --lote=/ > /dev/null 2>&1; then
+    echo -e "${RED}✗ FALHOU${NC} (deveria ter retornado erro)"
+    ((FAIL++))
+else
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+fi
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "🧱 Testando ALCANCE DESLIZANTE"
+echo "───────────────────────────────────────────────────────────"
+test_content "Alcance (Torre a1 com obstáculos)" "$BIN_DIR/alcance_deslizante" "Até 1 movimento(s): 3 casa(s)" torre a1 --obstaculos=a4,c1,b2
+test_content "Alcance (Bispo c1, mesma cor)" "$BIN_DIR/alcance_deslizante" "Até 2 movimento(s): 31 casa(s)" bispo c1
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Alcance (lote)... "
+lote_out=$(printf "torre a1\nrainha d4 0xffff000000000000\nbispo c1 b2,d2\n" | "$BIN_DIR/alcance_deslizante" --lote=- --k=2 2>/dev/null | tr '\n' '|')
+if [ "$lote_out" = "torre a1 63 0xfffffffffffffffe|rainha d4 47 0x0000fffff7ffffff|bispo c1 0 0x0000000000000000|" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $lote_out)"
+    ((FAIL++))
+fi
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "📐 Testando SIMULAÇÃO EM TABULEIRO GENÉRICO"
+echo "───────────────────────────────────────────────────────────"
+((TOTAL++))
+echo -n "[$TOTAL] Testando Simulação (densa e esparsa dão a mesma trajetória)... "
+sim_densa=$("$BIN_DIR/simulacao_tabuleiro" --tamanho=13x9 --pecas=20 --movimentos=100000 --representacao=densa | grep Checksum)
+sim_esparsa=$("$BIN_DIR/simulacao_tabuleiro" --tamanho=13x9 --pecas=20 --movimentos=100000 --representacao=esparsa | grep Checksum)
+if [ -n "$sim_densa" ] && [ "$sim_densa" = "$sim_esparsa" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} ($sim_densa vs $sim_esparsa)"
+    ((FAIL++))
+fi
+test_content "Simulação (10^6 x 10^6)" "$BIN_DIR/simulacao_tabuleiro" "esparsa (hash) | Obstáculos: 1000" --tamanho=1000000x1000000 --pecas=1000 --movimentos=10000
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Simulação (densa em 20x20 - deve falhar)... "
+if "$BIN_DIR/simulacao_tabuleiro" --tamanho=20x20 --representacao=densa > /dev/null 2>&1; then
+    echo -e "${RED}✗ FALHOU${NC} (deveria ter retornado erro)"
+    ((FAIL++))
+else
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+fi
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "🦄 Testando MOTOR DE PEÇAS"
+echo "───────────────────────────────────────────────────────────"
+test_content "Motor (tabela de peças)" "$BIN_DIR/motor_pecas" "Cavaleiro Noturno" --listar
+test_content "Motor (Cavalo no canto)" "$BIN_DIR/motor_pecas" "2 destino(s)" --peca=cavalo --inicio=0,0
+test_content "Motor (Rainha no centro)" "$BIN_DIR/motor_pecas" "27 destino(s)" --peca=rainha
+test_content "Motor (peça feérica S(1,2) = Cavalo)" "$BIN_DIR/motor_pecas" "8 destino(s)" --definir="S(1,2)"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Motor (kernel especializado = caminho genérico)... "
+if "$BIN_DIR/motor_pecas" --peca=arcebispo --pecas=8 --bench=20000 > /dev/null 2>&1; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (contagens divergem)"
+    ((FAIL++))
+fi
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "📥 Testando CARGA DE FEN"
+echo "───────────────────────────────────────────────────────────"
+FEN_TMP=$(mktemp)
+"$BIN_DIR/carga_fen" --gerar=5000 > "$FEN_TMP"
+test_content "Carga FEN (5000 posições)" "$BIN_DIR/carga_fen" "Posições: 5000" "$FEN_TMP"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Carga FEN (1 e 3 threads dão o mesmo checksum)... "
+fen_1=$("$BIN_DIR/carga_fen" "$FEN_TMP" --threads=1 | grep Checksum)
+fen_3=$("$BIN_DIR/carga_fen" "$FEN_TMP" --threads=3 | grep Checksum)
+if [ -n "$fen_1" ] && [ "$fen_1" = "$fen_3" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} ($fen_1 vs $fen_3)"
+    ((FAIL++))
+fi
+
+AV_TMP=$(mktemp)
+echo "4k3/8/8/1n1q4/3R4/8/8/B3K3 w - - 0 1" > "$AV_TMP"
+test_content "Avaliação de mobilidade (torre em d4 contra dama e cavalo)" "$BIN_DIR/carga_fen" \
+    "Mobilidade (brancas/pretas): torre=11/0 bispo=2/0 rainha=0/22 cavalo=0/6" --avaliar "$AV_TMP"
+test_content "Avaliação de mobilidade (ataques e pontuação)" "$BIN_DIR/carga_fen" \
+    "Pontuação média: -22.00" --avaliar "$AV_TMP"
+rm -f "$AV_TMP"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Avaliação (1 e 3 threads, popcount em hardware e em software iguais)... "
+av_1=$("$BIN_DIR/carga_fen" "$FEN_TMP" --avaliar --threads=1)
+av_3=$("$BIN_DIR/carga_fen" "$FEN_TMP" --avaliar --threads=3)
+av_sw=$("$BIN_DIR/carga_fen" "$FEN_TMP" --avaliar --threads=2 --popcount=software)
+if echo "$av_1" | grep -q "^Checksum avaliação: " && [ "$av_1" = "$av_3" ] && [ "$av_1" = "$av_sw" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Ataques em lote (vetoriais iguais à escalar, tabuleiro a tabuleiro)... "
+atq_bench=$("$BIN_DIR/ataques_lote" "$FEN_TMP" --bench --lado=pretas); atq_rc=$?
+atq_esc=$("$BIN_DIR/ataques_lote" "$FEN_TMP" --impl=escalar | grep Checksum)
+atq_auto=$("$BIN_DIR/ataques_lote" "$FEN_TMP" | grep Checksum)
+if [ $atq_rc -eq 0 ] && ! echo "$atq_bench" | grep -q DIVERGENTE && \
+   [ "$(echo "$atq_bench" | grep -c 'conferência: ok')" -ge 1 ] && [ "$atq_esc" = "$atq_auto" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+
+AV_TMP=$(mktemp)
+echo "4k3/8/8/8/3R4/8/8/N3K3 w - - 0 1" > "$AV_TMP"
+test_content "Ataques em lote (torre em d4 e cavalo em a1)" "$BIN_DIR/ataques_lote" "Casas atacadas: 16" "$AV_TMP"
+rm -f "$AV_TMP"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Carga FEN (erro com número da linha)... "
+printf '%s\n' "$(head -1 "$FEN_TMP")" "" "4k3/8/8/8/8/8/8/4K3 w KK -" > "$FEN_TMP"
+fen_err=$("$BIN_DIR/carga_fen" "$FEN_TMP" --threads=2 2>&1 >/dev/null)
+if [ $? -ne 0 ] && echo "$fen_err" | grep -qF "Linha 3: direitos de roque inválidos"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $fen_err)"
+    ((FAIL++))
+fi
+rm -f "$FEN_TMP"
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "📥 Testando PERFT E REPRODUÇÃO DE PGN"
+echo "───────────────────────────────────────────────────────────"
+test_content "Perft inicial (profundidade 4)" "$BIN_DIR/perft" "Nós: 197281" 4
+test_content "Perft Kiwipete (roques, en passant)" "$BIN_DIR/perft" "Nós: 97862" 3 \
+    --fen="r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+test_content "Perft posição 5 (promoções)" "$BIN_DIR/perft" "Nós: 62379" 3 \
+    --fen="rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Perft --divide (capturas antes dos quietos)... "
+primeiro=$("$BIN_DIR/perft" 1 --divide --fen="4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1" | head -1)
+if [ "$primeiro" = "e4d5: 1" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $primeiro)"
+    ((FAIL++))
+fi
+
+test_content "Perft incremental conferido (Kiwipete)" "$BIN_DIR/perft" "Nós: 97862" 3 --conferir \
+    --fen="r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+test_content "Fazer/desfazer (bench confere com recálculo)" "$BIN_DIR/perft" "Conferência: ok" --bench-fazer=100000 \
+    --fen="rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+
+PGN_TMP=$(mktemp)
+"$BIN_DIR/reproducao_pgn" --gerar=300 > "$PGN_TMP"
+test_content "Reprodução PGN (300 partidas geradas)" "$BIN_DIR/reproducao_pgn" "Inválidas: 0" "$PGN_TMP"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Reprodução PGN (1 e 3 threads dão o mesmo total)... "
+pgn_1=$("$BIN_DIR/reproducao_pgn" "$PGN_TMP" --threads=1)
+pgn_3=$("$BIN_DIR/reproducao_pgn" "$PGN_TMP" --threads=3)
+if [ -n "$pgn_1" ] && [ "$pgn_1" = "$pgn_3" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} ($pgn_1 vs $pgn_3)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Reprodução PGN (lance ilegal marcado)... "
+printf '%s\n' '[Event "a"]' '' '1. e4 {x} e5 (1... c5) 2. Nf3 Nc6 1-0' '' \
+    '[Event "b"]' '' '1. e4 e5 2. Ke3 *' > "$PGN_TMP"
+pgn_err=$("$BIN_DIR/reproducao_pgn" "$PGN_TMP" --threads=2 2>&1 >/dev/null)
+if [ $? -ne 0 ] && echo "$pgn_err" | grep -qF "Partida 2 (linha 7): lance ilegal 2. Ke3"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $pgn_err)"
+    ((FAIL++))
+fi
+rm -f "$PGN_TMP"
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "🔁 Testando RECURSÃO VS ITERAÇÃO (saída nula)"
+echo "───────────────────────────────────────────────────────────"
+test_content "Recursão vs iteração -O0 (pilha por quadro)" "$BIN_DIR/recursao_iteracao_O0" \
+    "torre_recursiva          pilha:" --max=100
+test_content "Recursão vs iteração -O0 (recursão mantida)" "$BIN_DIR/recursao_iteracao_O0" \
+    "recursão mantida (pilha O(n))" --max=100
+test_content "Recursão vs iteração -O2 (laços sem pilha)" "$BIN_DIR/recursao_iteracao_O2" \
+    "cavalo_loops_complexos   pilha:   0 B/quadro" --max=100
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "🧭 Testando DESPACHO ADAPTATIVO"
+echo "───────────────────────────────────────────────────────────"
+PERFIL_TMP=$(mktemp -d)
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Despacho (todas as implementações dão a mesma saída)... "
+desp_ok=1
+for impl in laco recursiva bufferizada anel; do
+    cav=$impl; [ $impl = recursiva ] && cav=laco
+    printf 'arquivo torre 0 %s\narquivo bispo 0 %s\narquivo rainha 0 %s\narquivo cavalo 0 %s\n' \
+        $impl $impl $impl $cav > "$PERFIL_TMP/$impl"
+    "$BIN_DIR/despacho_adaptativo" --perfil="$PERFIL_TMP/$impl" torre:3000 bispo:7 rainha:0 rainha:50 cavalo:9,2 cavalo:3,0 \
+        > "$PERFIL_TMP/saida_$impl" 2>/dev/null || desp_ok=0
+    cmp -s "$PERFIL_TMP/saida_laco" "$PERFIL_TMP/saida_$impl" || desp_ok=0
+done
+if [ $desp_ok -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (saídas diferem entre implementações)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Despacho (recursão vetada acima da profundidade segura)... "
+desp_stats=$("$BIN_DIR/despacho_adaptativo" --perfil="$PERFIL_TMP/recursiva" --profundidade-max=1000 --stats \
+    torre:1000 torre:1001 2>&1 > "$PERFIL_TMP/saida")
+if echo "$desp_stats" | grep -qF "torre n=1000 -> torre_recursiva" && \
+   echo "$desp_stats" | grep -qF "torre n=1001 -> torre_for"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $desp_stats)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Despacho (calibra, grava e recarrega o perfil)... "
+"$BIN_DIR/despacho_adaptativo" --perfil="$PERFIL_TMP/novo" > "$PERFIL_TMP/saida" 2>/dev/null
+desp_origem=$("$BIN_DIR/despacho_adaptativo" --perfil="$PERFIL_TMP/novo" --stats 2>&1 > "$PERFIL_TMP/saida" | head -1)
+if grep -q "^arquivo torre 0 " "$PERFIL_TMP/novo" && echo "$desp_origem" | grep -qF "carregado do perfil"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $desp_origem)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Despacho (perfil inválido - deve falhar)... "
+echo "arquivo torre x laco" > "$PERFIL_TMP/ruim"
+if "$BIN_DIR/despacho_adaptativo" --perfil="$PERFIL_TMP/ruim" > /dev/null 2>&1; then
+    echo -e "${RED}✗ FALHOU${NC} (deveria ter retornado erro)"
+    ((FAIL++))
+else
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+fi
+rm -rf "$PERFIL_TMP"
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "🧪 Testando TESTE DIFERENCIAL (implementações equivalentes)"
+echo "───────────────────────────────────────────────────────────"
+((TOTAL++))
+echo -n "[$TOTAL] Testando Teste diferencial (n sorteado até 10^7, em paralelo)... "
+dif_saida=$("$BIN_DIR/teste_diferencial" 2>&1)
+if [ $? -eq 0 ] && echo "$dif_saida" | grep -qF "Divergências: 0"; then
+    echo -e "${GREEN}✓ PASSOU${NC} ($(echo "$dif_saida" | grep -o "Comparações: [0-9]*"))"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    echo "$dif_saida" | grep -E "DIVERG|ERRO" | head -5
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Teste diferencial (mesma semente, mesmos casos)... "
+dif_a=$("$BIN_DIR/teste_diferencial" --max=50000 --casos=20 --semente=7 --threads=1 2>&1)
+dif_b=$("$BIN_DIR/teste_diferencial" --max=50000 --casos=20 --semente=7 --threads=3 2>&1 | sed 's/3 threads/1 threads/')
+if [ -n "$dif_a" ] && [ "$dif_a" = "$dif_b" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "🔐 Testando RESUMOS DE REFERÊNCIA (xxh64 da saída, sem cópia em disco)"
+echo "───────────────────────────────────────────────────────────"
+DIGESTS="$TEST_DIR/digests.txt"
+while IFS=$'\t' read -r dig_bytes dig_hash dig_args; do
+    case "$dig_bytes" in ''|'#'*) continue ;; esac
+    ((TOTAL++))
+    echo -n "[$TOTAL] Testando Resumo ($dig_args)... "
+    read -r -a dig_argv <<< "$dig_args"
+    dig_obtido=$("$BIN_DIR/otim_validacoes" --digest "${dig_argv[@]}" 2>&1)
+    if [ "$dig_obtido" = "$dig_hash $dig_bytes" ]; then
+        echo -e "${GREEN}✓ PASSOU${NC}"
+        ((PASS++))
+    else
+        echo -e "${RED}✗ FALHOU${NC} (esperado: $dig_hash $dig_bytes, obtido: $dig_obtido)"
+        ((FAIL++))
+    fi
+done < "$DIGESTS"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Resumo do fluxo descomprimido (mesmo da saída direta)... "
+dig_linha=$(grep -P '\t--format=csv 0 0 10000000 0 0$' "$DIGESTS")
+dig_obtido=$("$BIN_DIR/otim_validacoes" --format=csv --compress 0 0 10000000 0 0 | "$BIN_DIR/descomprimir" --digest)
+if [ -n "$dig_linha" ] && [ "$dig_obtido" = "$(echo "$dig_linha" | cut -f2) $(echo "$dig_linha" | cut -f1)" ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (obtido: $dig_obtido)"
+    ((FAIL++))
+fi
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "🧩 Testando LOTE EM FRAGMENTOS (--shards, junção dos segmentos, latências)"
+echo "───────────────────────────────────────────────────────────"
+LOTE_TMP=$(mktemp -d)
+awk 'BEGIN { srand(11); for (i = 0; i < 600; i++) { if (i % 50 == 0) print ""; printf "%d %d,%d\t%d %d\n", int(rand() * 2000), int(rand() * 200), int(rand() * 2000), int(rand() * 40), int(rand() * 40) } }' > "$LOTE_TMP/lote.txt"
+for lote_fmt in text csv bin; do
+    ((TOTAL++))
+    echo -n "[$TOTAL] Testando --shards=4 igual ao lote em um processo ($lote_fmt, arquivo e pipe)... "
+    "$BIN_DIR/otim_validacoes" --format=$lote_fmt --lote="$LOTE_TMP/lote.txt" > "$LOTE_TMP/um.$lote_fmt"
+    "$BIN_DIR/otim_validacoes" --format=$lote_fmt --lote="$LOTE_TMP/lote.txt" --shards=4 > "$LOTE_TMP/frag.$lote_fmt"
+    if [ -s "$LOTE_TMP/um.$lote_fmt" ] && cmp -s "$LOTE_TMP/um.$lote_fmt" "$LOTE_TMP/frag.$lote_fmt" && \
+       "$BIN_DIR/otim_validacoes" --format=$lote_fmt --lote="$LOTE_TMP/lote.txt" --shards=4 | cmp -s - "$LOTE_TMP/um.$lote_fmt"; then
+        echo -e "${GREEN}✓ PASSOU${NC}"
+        ((PASS++))
+    else
+        echo -e "${RED}✗ FALHOU${NC}"
+        ((FAIL++))
+    fi
+done
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando --latencia (saída intacta, 4 fases; json com --shards soma os fragmentos)... "
+lat_texto=$("$BIN_DIR/otim_validacoes" --format=csv --lote="$LOTE_TMP/lote.txt" --latencia 2>&1 > "$LOTE_TMP/lat.csv")
+lat_json=$("$BIN_DIR/otim_validacoes" --format=csv --lote="$LOTE_TMP/lote.txt" --shards=3 --latencia=json 2>&1 > /dev/null)
+if cmp -s "$LOTE_TMP/lat.csv" "$LOTE_TMP/um.csv" && [ "$(echo "$lat_texto" | grep -c '^\[latência\] fase=.* n=600 .* p999=.* máx=')" -eq 4 ] && \
+   echo "$lat_json" | grep -q '^{"origem":"final","fase":"registro","n":600,.*"p99_ns":[0-9]*,"p999_ns":[0-9]*,"max_ns":[0-9]*}$'; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Lote com linha inválida (código 1 e mesma linha, com e sem --shards)... "
+printf '1 2 3 4 5\n1 1 1 1 1\n2 2 2 2 2\n1 2 x 4 5\n' > "$LOTE_TMP/ruim.txt"
+"$BIN_DIR/otim_validacoes" --lote="$LOTE_TMP/ruim.txt" > /dev/null 2> "$LOTE_TMP/erro1"; lote_rc1=$?
+"$BIN_DIR/otim_validacoes" --lote="$LOTE_TMP/ruim.txt" --shards=2 > /dev/null 2> "$LOTE_TMP/erro2"; lote_rc2=$?
+if [ $lote_rc1 -eq 1 ] && [ $lote_rc2 -eq 1 ] && grep -qF "Linha 4 inválida" "$LOTE_TMP/erro2" && \
+   cmp -s "$LOTE_TMP/erro1" "$LOTE_TMP/erro2"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (códigos: $lote_rc1, $lote_rc2)"
+    ((FAIL++))
+fi
+rm -rf "$LOTE_TMP"
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "♛ Testando TABELAS DE FINAIS (KQK/KRK, análise retrógrada, mmap)"
+echo "───────────────────────────────────────────────────────────"
+FINAIS_TMP=$(mktemp -d)
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Geração KQK/KRK (mate em 10 e em 16, 1 e 4 threads iguais)... "
+finais_out=$("$BIN_DIR/tabela_finais" --gerar --dir="$FINAIS_TMP")
+mkdir "$FINAIS_TMP/t4"
+"$BIN_DIR/tabela_finais" --gerar --threads=4 --dir="$FINAIS_TMP/t4" > /dev/null
+if echo "$finais_out" | grep -q "^KQK: .*(mate em 10)" && echo "$finais_out" | grep -q "^KRK: .*(mate em 16)" && \
+   cmp -s "$FINAIS_TMP/kqk.xtf" "$FINAIS_TMP/t4/kqk.xtf" && cmp -s "$FINAIS_TMP/krk.xtf" "$FINAIS_TMP/t4/krk.xtf"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Tabelas conferidas com o gerador de lances e força bruta... "
+finais_ver=$("$BIN_DIR/tabela_finais" --verificar --dir="$FINAIS_TMP" 2>&1); finais_rc=$?
+if [ $finais_rc -eq 0 ] && [ "$(echo "$finais_ver" | grep -c ', 0 divergência(s)$')" -eq 4 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (código $finais_rc)"
+    ((FAIL++))
+fi
+
+test_content "Consulta KQK (melhor lance em SAN)" "$BIN_DIR/tabela_finais" \
+    "KQK, brancas jogam: mate em 1 lance (1 ply); melhor lance: Qa4#" \
+    --consultar="8/8/8/8/8/8/k7/2KQ4 w - - 0 1" --dir="$FINAIS_TMP"
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Regravação que falha mantém a tabela anterior (sem resumo)... "
+cp "$FINAIS_TMP/kqk.xtf" "$FINAIS_TMP/kqk.antes"
+mkdir "$FINAIS_TMP/kqk.xtf.tmp"
+finais_out=$("$BIN_DIR/tabela_finais" --gerar=kqk --dir="$FINAIS_TMP" 2> /dev/null); finais_rc=$?
+rmdir "$FINAIS_TMP/kqk.xtf.tmp"
+if [ $finais_rc -eq 1 ] && [ -z "$finais_out" ] && cmp -s "$FINAIS_TMP/kqk.xtf" "$FINAIS_TMP/kqk.antes"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (código $finais_rc)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Tabela corrompida recusada no mapeamento (--verificar e --consultar)... "
+printf '\x07' | dd of="$FINAIS_TMP/krk.xtf" bs=1 seek=5000 conv=notrunc 2> /dev/null
+finais_cons=$("$BIN_DIR/tabela_finais" --consultar="8/8/8/8/8/2k5/8/K6R w - - 0 1" --dir="$FINAIS_TMP" 2>&1); finais_rc=$?
+if ! "$BIN_DIR/tabela_finais" --verificar=krk --dir="$FINAIS_TMP" > /dev/null 2>&1 && [ $finais_rc -eq 1 ] && \
+   echo "$finais_cons" | grep -qF "krk.xtf' (Invalid argument)"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+rm -rf "$FINAIS_TMP"
+echo ""
+
+echo "───────────────────────────────────────────────────────────"
+echo "📦 Testando CENÁRIOS PRÉ-COMPILADOS (.xcn via mmap)"
+echo "───────────────────────────────────────────────────────────"
+CEN_TMP=$(mktemp -d)
+"$BIN_DIR/compilar_cenarios" --gerar=10000 --max=6 --semente=7 > "$CEN_TMP/lista.txt"
+"$BIN_DIR/compilar_cenarios" "$CEN_TMP/lista.txt" "$CEN_TMP/c.xcn" > /dev/null
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando --cenarios idêntico a --lote (text/csv/jsonl/bin)... "
+cen_ok=1
+for cen_fmt in text csv jsonl bin; do
+    "$BIN_DIR/otim_validacoes" --lote="$CEN_TMP/lista.txt" --format=$cen_fmt > "$CEN_TMP/a.out"
+    "$BIN_DIR/otim_validacoes" --cenarios="$CEN_TMP/c.xcn" --format=$cen_fmt > "$CEN_TMP/b.out" || cen_ok=0
+    cmp -s "$CEN_TMP/a.out" "$CEN_TMP/b.out" || cen_ok=0
+done
+if [ $cen_ok -eq 1 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando --listar de volta à lista (comentários ignorados na compilação e no --lote)... "
+printf '# cenários\n5 5 8 2 1   # padrão\n\n0,1,2,3,4\n' > "$CEN_TMP/com.txt"
+"$BIN_DIR/compilar_cenarios" "$CEN_TMP/com.txt" "$CEN_TMP/com.xcn" > /dev/null
+if "$BIN_DIR/compilar_cenarios" --listar "$CEN_TMP/c.xcn" | cmp -s - "$CEN_TMP/lista.txt" && \
+   [ "$("$BIN_DIR/compilar_cenarios" --listar "$CEN_TMP/com.xcn" | tr '\n' ';')" = "5 5 8 2 1;0 1 2 3 4;" ] && \
+   "$BIN_DIR/otim_validacoes" --lote="$CEN_TMP/com.txt" > "$CEN_TMP/com.lote" && \
+   "$BIN_DIR/otim_validacoes" --cenarios="$CEN_TMP/com.xcn" | cmp -s - "$CEN_TMP/com.lote"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC}"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Lista inválida não gera nem substitui arquivo... "
+printf '1 2 3 4 5\n1 2 3\n' | "$BIN_DIR/compilar_cenarios" - "$CEN_TMP/ruim.xcn" > /dev/null 2>&1; cen_rc=$?
+cp "$CEN_TMP/com.xcn" "$CEN_TMP/com.antes"
+printf '1 2 3\n' | "$BIN_DIR/compilar_cenarios" - "$CEN_TMP/com.xcn" > /dev/null 2>&1
+if [ $cen_rc -eq 1 ] && [ ! -e "$CEN_TMP/ruim.xcn" ] && [ ! -e "$CEN_TMP/ruim.xcn.tmp" ] && \
+   cmp -s "$CEN_TMP/com.xcn" "$CEN_TMP/com.antes"; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (código $cen_rc)"
+    ((FAIL++))
+fi
+
+((TOTAL++))
+echo -n "[$TOTAL] Testando Registro, cabeçalho e tamanho corrompidos recusados (sem rodapé de sucesso)... "
+cp "$CEN_TMP/c.xcn" "$CEN_TMP/reg.xcn"
+printf '\x07' | dd of="$CEN_TMP/reg.xcn" bs=1 seek=90000 conv=notrunc 2> /dev/null
+cp "$CEN_TMP/c.xcn" "$CEN_TMP/cab.xcn"
+printf '\x07' | dd of="$CEN_TMP/cab.xcn" bs=1 seek=22 conv=notrunc 2> /dev/null
+head -c 1000 "$CEN_TMP/c.xcn" > "$CEN_TMP/curto.xcn"
+"$BIN_DIR/otim_validacoes" --cenarios="$CEN_TMP/reg.xcn" --digest > /dev/null 2>&1; cen_rc1=$?
+"$BIN_DIR/otim_validacoes" --cenarios="$CEN_TMP/cab.xcn" > /dev/null 2>&1; cen_rc2=$?
+"$BIN_DIR/otim_validacoes" --cenarios="$CEN_TMP/curto.xcn" > /dev/null 2>&1; cen_rc3=$?
+cen_rodape=$("$BIN_DIR/otim_validacoes" --cenarios="$CEN_TMP/reg.xcn" 2> /dev/null | grep -cF "[OK] Execução concluída")
+if [ $cen_rc1 -eq 1 ] && [ $cen_rc2 -eq 1 ] && [ $cen_rc3 -eq 1 ] && [ "$cen_rodape" -eq 0 ]; then
+    echo -e "${GREEN}✓ PASSOU${NC}"
+    ((PASS++))
+else
+    echo -e "${RED}✗ FALHOU${NC} (códigos: $cen_rc1, $cen_rc2, $cen_rc3)"
+    ((FAIL++))
+fi
+rm -rf "$CEN_TMP"
+echo ""
+
 # ═══════════════════════════════════════════════════════════════
 # RELATÓRIO FINAL
 # ═══════════════════════════════════════════════════════════════
@@ -37,6 +37,9 @@
 */
 
 #include <stdio.h>
+#include <string.h>
+
+#include "Movimentacao de Pecas: Algoritmos e Otimizacao/Biblioteca Comum/xadrez_casa.h"
 
 /*
 ================================================================================
@@ -70,6 +73,32 @@
 #define SEP_DUPLO     "════════════════════════════════════════════════════════════\n"
 #define SEP_NIVEL     "▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓\n"
 
+/*
+================================================================================
+ RASTREAMENTO DE POSIÇÃO (COORDENADAS ALGÉBRICAS)
+ 
+ Cada passo desloca a peça a partir de uma casa inicial configurável.
+ Os nomes das casas vêm de uma tabela pré-calculada: nenhum printf por passo.
+ Casas fora do tabuleiro 8x8 aparecem como "--". Casa, NOME_CASA, as casas
+ iniciais INICIO_* e a linha de cada passo vêm de xadrez_casa.h, o mesmo
+ cabeçalho de mestre_recursividade_avancada.c.
+================================================================================
+*/
+
+static Casa posicao_atual;           // casa onde a peça está agora
+static Casa inicio_global;           // casa definida por --inicio=
+static int usar_inicio_global = 0;   // 1 se --inicio= foi informado
+static int exibir_coordenadas = 0;   // 1 se --coordenadas foi informado
+
+#ifdef NO_OUTPUT
+// Sumidouro nulo para benchmarks de controle (otimizacoes_performance.md,
+// "Saída opcional"): cada passo só incrementa um contador volátil, para o
+// compilador não poder apagar nem fundir os laços medidos. 'sonda_pilha',
+// quando definida, é chamada a cada passo (medição de pilha por quadro).
+static volatile unsigned long long passos_sumidouro = 0;
+static void (*sonda_pilha)(void) = NULL;
+#endif
+
 /*
 ================================================================================
  PROTÓTIPOS DE FUNÇÕES
@@ -118,6 +147,13 @@ void exibir_separador_peca(const char* peca, const char* tecnica);
 void exibir_rodape_nivel(void);
 void exibir_rodape_geral(void);
 
+/* ─────────────────────────────────────────────────────────────────────────
+   FUNÇÕES DE RASTREAMENTO DE POSIÇÃO
+   Casa atual da peça e emissão de coordenadas algébricas
+   ───────────────────────────────────────────────────────────────────────── */
+void posicionar_peca(Casa padrao);
+void registrar_passo(const char* direcao, int dc, int dl);
+
 /*
 ================================================================================
  IMPLEMENTAÇÕES DAS FUNÇÕES - NÍVEL NOVATO
@@ -168,7 +204,7 @@ void torre_for(int n) {
      * Invariante: Após k iterações, foram impressas k movimentos "Direita"
      */
     for (int i = 1; i <= n; i++) {
-        printf("Direita\n");
+        registrar_passo("Direita", 1, 0);
     }
 }
 
@@ -211,7 +247,7 @@ void bispo_while(int n) {
     int contador = 1;
     
     while (contador <= n) {
-        printf("Cima Direita\n");  // Movimento diagonal composto
+        registrar_passo("Cima Direita", 1, 1);  // Movimento diagonal composto
         contador++;                 // CRÍTICO: incremento manual
     }
 }
@@ -258,7 +294,7 @@ void rainha_dowhile(int n) {
     int contador = 1;
     
     do {
-        printf("Esquerda\n");
+        registrar_passo("Esquerda", -1, 0);
         contador++;
     } while (contador <= n);
 }
@@ -343,7 +379,7 @@ void cavalo_loops_aninhados(int vertical, int horizontal) {
             // Loop interno WHILE: executa N movimentos verticais
             contador = 1;
             while (contador <= casas_nesta_etapa) {
-                printf("Baixo\n");
+                registrar_passo("Baixo", 0, -1);
                 contador++;
             }
             
@@ -356,7 +392,7 @@ void cavalo_loops_aninhados(int vertical, int horizontal) {
             // Loop interno WHILE: executa N movimentos horizontais
             contador = 1;
             while (contador <= casas_nesta_etapa) {
-                printf("Esquerda\n");
+                registrar_passo("Esquerda", -1, 0);
                 contador++;
             }
         }
@@ -487,7 +523,7 @@ void torre_recursiva(int n) {
     // ═══════════════════════════════════════════════════════════════════
     // CASO RECURSIVO: Trabalho Atual + Chamada Recursiva
     // ═══════════════════════════════════════════════════════════════════
-    printf("Direita\n");           // Movimento atual (trabalho desta chamada)
+    registrar_passo("Direita", 1, 0);  // Movimento atual (trabalho desta chamada)
     torre_recursiva(n - 1);        // Resolve subproblema (n-1 movimentos)
 }
 
@@ -530,7 +566,7 @@ void bispo_recursivo(int n) {
     }
     
     // Caso recursivo: movimento diagonal composto
-    printf("Cima Direita\n");
+    registrar_passo("Cima Direita", 1, 1);
     bispo_recursivo(n - 1);
 }
 
@@ -572,7 +608,7 @@ void rainha_recursiva(int n) {
     }
     
     // Caso recursivo: movimento para esquerda
-    printf("Esquerda\n");
+    registrar_passo("Esquerda", -1, 0);
     rainha_recursiva(n - 1);
 }
 
@@ -626,14 +662,15 @@ void cavalo_loops_complexos(int vertical, int horizontal) {
     int movimento_atual = 0;
     int total_movimentos = 0;
     int movimento_completo = 0;
+    int passagens = 0;      // uma passagem por etapa: termina mesmo com horizontal = 0
     
-    while (!movimento_completo && total_movimentos < 10) {
+    while (!movimento_completo && passagens++ < 2) {
         if (etapa == 1) {
             for (movimento_atual = 0; movimento_atual < vertical; movimento_atual++) {
                 if (total_movimentos >= (vertical + horizontal)) {
                     break;
                 }
-                printf("Cima\n");
+                registrar_passo("Cima", 0, 1);
                 total_movimentos++;
                 if (movimento_atual == 0) {
                     continue;
@@ -644,7 +681,7 @@ void cavalo_loops_complexos(int vertical, int horizontal) {
         }
         else if (etapa == 2) {
             for (movimento_atual = 0; movimento_atual < horizontal; movimento_atual++) {
-                printf("Direita\n");
+                registrar_passo("Direita", 1, 0);
                 total_movimentos++;
                 if (total_movimentos >= (vertical + horizontal)) {
                     movimento_completo = 1;
@@ -687,9 +724,9 @@ void cavalo_loops_complexos(int vertical, int horizontal) {
 void bispo_loops_decompostos(int n) {
     for (int vertical = 1; vertical <= n; vertical++) {
         for (int horizontal = 1; horizontal <= 1; horizontal++) {
-            printf("Cima\n");
+            registrar_passo("Cima", 0, 1);
             if (vertical <= n) {
-                printf("Direita\n");
+                registrar_passo("Direita", 1, 0);
             }
         }
     }
@@ -754,6 +791,38 @@ void exibir_rodape_geral(void) {
     printf(SEP_DUPLO);
 }
 
+/*
+================================================================================
+ FUNÇÕES DE RASTREAMENTO DE POSIÇÃO
+ 
+ Mantêm a casa atual da peça e, opcionalmente, anexam ao passo as
+ coordenadas de origem e destino ("Direita e4→f4").
+================================================================================
+*/
+
+// Coloca a peça na casa inicial (--inicio= tem prioridade sobre o padrão).
+void posicionar_peca(Casa padrao) {
+    posicao_atual = usar_inicio_global ? inicio_global : padrao;
+}
+
+// Aplica o deslocamento (dc, dl) e emite a linha do passo com uma única escrita.
+void registrar_passo(const char* direcao, int dc, int dl) {
+    Casa de = posicao_atual;
+    posicao_atual.coluna += dc;
+    posicao_atual.linha += dl;
+
+#ifdef NO_OUTPUT
+    (void)direcao;
+    (void)de;
+    (void)exibir_coordenadas;
+    passos_sumidouro++;
+    if (sonda_pilha) sonda_pilha();
+#else
+    char linha[PASSO_LINHA_MAX];
+    fwrite(linha, 1, formatar_passo(linha, direcao, de, posicao_atual, exibir_coordenadas), stdout);
+#endif
+}
+
 /*
 ================================================================================
  FUNÇÃO MAIN - ORQUESTRAÇÃO DE TODOS OS NÍVEIS
@@ -769,11 +838,31 @@ void exibir_rodape_geral(void) {
    4. Nível Mestre (recursividade + avançado)
    5. Rodapé geral
  
+ Opções:
+   --coordenadas   anexa origem→destino algébricos a cada passo
+   --inicio=<casa> casa inicial de todas as peças (ex.: --inicio=e4)
+ 
  Retorno:
    0 - Execução bem-sucedida (padrão POSIX)
+   1 - Opção inválida
+
+ Com XADREZ_COMPLETO_SEM_MAIN definido, main fica de fora e o arquivo pode
+ ser incluído por um benchmark (Ferramentas/recursao_iteracao.c).
 ================================================================================
 */
-int main(void) {
+#ifndef XADREZ_COMPLETO_SEM_MAIN
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--coordenadas")) {
+            exibir_coordenadas = 1;
+        } else if (!strncmp(argv[i], "--inicio=", 9) && casa_de_nome(argv[i] + 9, &inicio_global)) {
+            usar_inicio_global = 1;
+        } else {
+            fprintf(stderr, "Uso: %s [--coordenadas] [--inicio=<casa a1..h8>]\n", argv[0]);
+            return 1;
+        }
+    }
+    
     // Cabeçalho geral
     exibir_cabecalho_geral();
     
@@ -786,14 +875,17 @@ int main(void) {
     );
     
     exibir_separador_peca("TORRE", "loop FOR");
+    posicionar_peca(INICIO_TORRE);
     torre_for(CASAS_TORRE_NOVATO);
     printf("\n");
     
     exibir_separador_peca("BISPO", "loop WHILE");
+    posicionar_peca(INICIO_BISPO);
     bispo_while(CASAS_BISPO_NOVATO);
     printf("\n");
     
     exibir_separador_peca("RAINHA", "loop DO-WHILE");
+    posicionar_peca(INICIO_RAINHA);
     rainha_dowhile(CASAS_RAINHA_NOVATO);
     exibir_rodape_nivel();
     
@@ -806,18 +898,22 @@ int main(void) {
     );
     
     exibir_separador_peca("TORRE", "loop FOR - mantido do Novato");
+    posicionar_peca(INICIO_TORRE);
     torre_for(CASAS_TORRE_NOVATO);
     printf("\n");
     
     exibir_separador_peca("BISPO", "loop WHILE - mantido do Novato");
+    posicionar_peca(INICIO_BISPO);
     bispo_while(CASAS_BISPO_NOVATO);
     printf("\n");
     
     exibir_separador_peca("RAINHA", "loop DO-WHILE - mantido do Novato");
+    posicionar_peca(INICIO_RAINHA);
     rainha_dowhile(CASAS_RAINHA_NOVATO);
     printf("\n");
     
     exibir_separador_peca("CAVALO", "loops aninhados - NOVO");
+    posicionar_peca(INICIO_CAVALO_AVENTUREIRO);
     cavalo_loops_aninhados(CAVALO_AVENTUREIRO_V, CAVALO_AVENTUREIRO_H);
     exibir_rodape_nivel();
     
@@ -830,22 +926,27 @@ int main(void) {
     );
     
     exibir_separador_peca("TORRE", "RECURSIVA - substitui FOR");
+    posicionar_peca(INICIO_TORRE);
     torre_recursiva(CASAS_TORRE_MESTRE);
     printf("\n");
     
     exibir_separador_peca("BISPO", "RECURSIVA - substitui WHILE");
+    posicionar_peca(INICIO_BISPO);
     bispo_recursivo(CASAS_BISPO_MESTRE);
     printf("\n");
     
     exibir_separador_peca("BISPO", "LOOPS ANINHADOS - decomposição");
+    posicionar_peca(INICIO_BISPO);
     bispo_loops_decompostos(CASAS_BISPO_MESTRE);
     printf("\n");
     
     exibir_separador_peca("RAINHA", "RECURSIVA - substitui DO-WHILE");
+    posicionar_peca(INICIO_RAINHA);
     rainha_recursiva(CASAS_RAINHA_MESTRE);
     printf("\n");
     
     exibir_separador_peca("CAVALO", "LOOPS COMPLEXOS - continue/break");
+    posicionar_peca(INICIO_CAVALO_MESTRE);
     cavalo_loops_complexos(CAVALO_MESTRE_V, CAVALO_MESTRE_H);
     exibir_rodape_nivel();
     
@@ -854,6 +955,7 @@ int main(void) {
     
     return 0;
 }
+#endif
 
 /*
 ================================================================================
@@ -871,6 +973,7 @@ int main(void) {
 
  Execução:
    ./xadrez_completo
+   ./xadrez_completo --coordenadas --inicio=e4
 
  Validação:
    - Sem warnings com -Wall -Wextra